@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for int8 quantized ImageNet models on the local CPU.
+
+The models are quantized with per-channel weight scales and UPWARD rounding,
+so every conv2d and dense epilogue requantizes with fixed point multipliers.
+Each network is measured with the requantization lowered to the fused
+fixed_point_multiply op and with the int64 op chain it replaces
+(TVM_QNN_FUSED_FIXED_POINT=0), under the same rounding. Each setting runs in
+its own process, since the setting is read once per process.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+import numpy as np
+
+import tvm
+import tvm.contrib.graph_runtime as runtime
+from tvm import relay
+
+from util import get_network, print_progress
+
+
+def evaluate_network(network, target, repeat):
+    """Mean and standard deviation of the inference time in ms"""
+    print_progress(network)
+    net, params, input_shape, _ = get_network(network, batch_size=1)
+
+    print_progress("%-20s quantizing..." % network)
+    with relay.quantize.qconfig(per_channel=True, weight_scale="max", rounding="UPWARD"):
+        net = relay.quantize.quantize(net, params=params)
+
+    print_progress("%-20s building..." % network)
+    with relay.build_config(opt_level=3):
+        graph, lib, params = relay.build(net, target=target)
+
+    ctx = tvm.cpu(0)
+    module = runtime.create(graph, lib, ctx)
+    data_tvm = tvm.nd.array((np.random.uniform(size=input_shape)).astype('float32'))
+    module.set_input('data', data_tvm)
+    module.set_input(**params)
+
+    # evaluate
+    print_progress("%-20s evaluating..." % network)
+    ftimer = module.module.time_evaluator("run", ctx, number=1, repeat=repeat)
+    prof_res = np.array(ftimer().results) * 1000  # multiply 1000 for converting to millisecond
+    return np.mean(prof_res), np.std(prof_res)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, choices=
+                        ['resnet-18', 'resnet-34', 'resnet-50', 'vgg-16', 'mobilenet'],
+                        help='The name of neural network')
+    parser.add_argument("--target", type=str, default='llvm -mcpu=cascadelake',
+                        help="The CPU target, e.g. 'llvm -mcpu=skylake-avx512' or "
+                             "'llvm -device=arm_cpu -target=aarch64-linux-gnu -mattr=+v8.2a,+dotprod'")
+    parser.add_argument("--repeat", type=int, default=10)
+    parser.add_argument("--child", type=str, default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child is not None:
+        mean, std = evaluate_network(args.child, tvm.target.create(args.target), args.repeat)
+        print("\n%.4f %.4f" % (mean, std))
+        sys.exit(0)
+
+    if args.network is None:
+        networks = ['resnet-18', 'mobilenet']
+    else:
+        networks = [args.network]
+
+    settings = [("int64", "0"), ("fused", "1")]
+    print("--------------------------------------------------")
+    print("%-20s %-10s %-20s" % ("Network Name", "Requantize", "Mean Inference Time (std dev)"))
+    print("--------------------------------------------------")
+    for network in networks:
+        for name, fused in settings:
+            env = dict(os.environ, TVM_QNN_FUSED_FIXED_POINT=fused)
+            cmd = [sys.executable, __file__, "--child", network, "--target", args.target,
+                   "--repeat", str(args.repeat)]
+            mean, std = subprocess.check_output(cmd, env=env).decode().split()[-2:]
+            print("%-20s %-10s %-19s (%s)" % (network, name, "%s ms" % mean, "%s ms" % std))
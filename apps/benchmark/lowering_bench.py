@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the lowering time of large conv2d schedules.
+
+The schedules are lowered once with the simplification memo of arith.Analyzer
+and once without it (TVM_ARITH_SIMPLIFY_MEMO=0). Each setting runs in its own
+process, since the setting is read once per process.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+import numpy as np
+
+import tvm
+import topi
+
+# (batch, in_channel, height, width, out_channel, kernel, stride, padding) of resnet-18 layers
+WORKLOADS = [
+    (1, 3, 224, 224, 64, 7, 2, 3),
+    (1, 64, 56, 56, 64, 3, 1, 1),
+    (1, 128, 28, 28, 128, 3, 1, 1),
+    (1, 256, 14, 14, 256, 3, 1, 1),
+    (1, 512, 7, 7, 512, 3, 1, 1),
+]
+
+
+def lower_workloads(target, repeat):
+    """Lower every workload `repeat` times, return the mean time of one pass in ms"""
+    costs = []
+    for _ in range(repeat):
+        tic = time.time()
+        for n, ic, h, w, oc, k, stride, pad in WORKLOADS:
+            with tvm.target.create(target):
+                data = tvm.placeholder((n, ic, h, w), name="data")
+                kernel = tvm.placeholder((oc, ic, k, k), name="kernel")
+                out = topi.nn.conv2d(data, kernel, stride, pad, 1, "NCHW", "float32")
+                s = topi.generic.schedule_conv2d_nchw([out])
+            tvm.lower(s, [data, kernel, out])
+        costs.append((time.time() - tic) * 1000)
+    return np.mean(costs), np.std(costs)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--child", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        print("%.2f %.2f" % lower_workloads(args.target, args.repeat))
+        sys.exit(0)
+
+    print("--------------------------------------------------")
+    print("%-20s %-20s" % ("Simplify Memo", "Lowering Time (std dev)"))
+    print("--------------------------------------------------")
+    for memo in ["1", "0"]:
+        env = dict(os.environ, TVM_ARITH_SIMPLIFY_MEMO=memo)
+        out = subprocess.check_output(
+            [sys.executable, __file__, "--child", "--target", args.target,
+             "--repeat", str(args.repeat)], env=env)
+        mean, std = out.decode().split()
+        print("%-20s %-20s" % ("on" if memo == "1" else "off",
+                               "%s ms (%s ms)" % (mean, std)))
@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the throughput of the arithmetic simplifiers.
+
+The lowered IR of large conv2d schedules is simplified over and over, once
+with the structural pre-check of the rewrite rule patterns and once without
+it (TVM_ARITH_PATTERN_PRECHECK=0). The simplification memo of arith.Analyzer
+is disabled in both runs so that every rule is actually tried. Each setting
+runs in its own process, since the settings are read once per process.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+import numpy as np
+
+import tvm
+import topi
+
+from lowering_bench import WORKLOADS
+
+
+def lowered_stmts(target):
+    """The lowered IR of every workload"""
+    stmts = []
+    for n, ic, h, w, oc, k, stride, pad in WORKLOADS:
+        with tvm.target.create(target):
+            data = tvm.placeholder((n, ic, h, w), name="data")
+            kernel = tvm.placeholder((oc, ic, k, k), name="kernel")
+            out = topi.nn.conv2d(data, kernel, stride, pad, 1, "NCHW", "float32")
+            s = topi.generic.schedule_conv2d_nchw([out])
+        stmts.append(tvm.lower(s, [data, kernel, out], simple_mode=True))
+    return stmts
+
+
+def simplify_stmts(stmts, number, repeat):
+    """Simplify every statement `number` times per repeat, return the mean time in ms"""
+    costs = []
+    for _ in range(repeat):
+        tic = time.time()
+        for _ in range(number):
+            for stmt in stmts:
+                tvm.ir_pass.CanonicalSimplify(stmt)
+                tvm.ir_pass.Simplify(stmt)
+        costs.append((time.time() - tic) * 1000)
+    return np.mean(costs), np.std(costs)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--number", type=int, default=10)
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--child", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        stmts = lowered_stmts(args.target)
+        print("%.2f %.2f" % simplify_stmts(stmts, args.number, args.repeat))
+        sys.exit(0)
+
+    print("--------------------------------------------------")
+    print("%-20s %-20s" % ("Pattern Pre-check", "Simplify Time (std dev)"))
+    print("--------------------------------------------------")
+    for precheck in ["1", "0"]:
+        env = dict(os.environ, TVM_ARITH_SIMPLIFY_MEMO="0",
+                   TVM_ARITH_PATTERN_PRECHECK=precheck)
+        out = subprocess.check_output(
+            [sys.executable, __file__, "--child", "--target", args.target,
+             "--number", str(args.number), "--repeat", str(args.repeat)], env=env)
+        mean, std = out.decode().split()
+        print("%-20s %-20s" % ("on" if precheck == "1" else "off",
+                               "%s ms (%s ms)" % (mean, std)))
@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for argsort and topk of contrib/sort on CPU.
+
+The score shapes of the detection models are sorted with the current
+implementation, which selects the first k elements and splits the rows over
+the thread pool, and with the full serial stable sort it replaced, which
+TVM_SORT_BASELINE=1 selects. Each setting runs in its own process, since the
+setting is read once per process.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+import numpy as np
+
+import tvm
+
+# (name, shape, k) of the scores that are sorted, k of 0 is a full argsort.
+WORKLOADS = [
+    ("ssd argsort", (1, 8732), 0),
+    ("ssd topk", (1, 8732), 200),
+    ("yolo argsort", (1, 10647), 0),
+    ("yolo topk", (1, 10647), 100),
+    ("coco topk b1", (1, 100 * 80), 100),
+    ("coco topk b8", (8, 100 * 80), 100),
+    ("voc topk b8", (8, 100 * 20), 100),
+]
+
+
+def build_sort(shape, k):
+    """Build a descending argsort along the last axis, or topk when k > 0"""
+    data = tvm.placeholder(shape, name="data")
+    if k > 0:
+        oshape = shape[:-1] + (k,)
+        out = tvm.extern([oshape, oshape], [data],
+                         lambda ins, outs: tvm.call_packed(
+                             "tvm.contrib.sort.topk", ins[0], outs[0], outs[1],
+                             k, -1, "both", False),
+                         dtype=["float32", "int32"], name="topk")
+    else:
+        out = [tvm.extern(shape, [data],
+                          lambda ins, outs: tvm.call_packed(
+                              "tvm.contrib.sort.argsort", ins[0], outs[0], -1, False),
+                          dtype="int32", name="argsort")]
+    s = tvm.create_schedule(out[0].op)
+    return tvm.build(s, [data] + out, "llvm"), [o.shape for o in out], [o.dtype for o in out]
+
+
+def measure(number, repeat):
+    """Mean time in ms of every workload"""
+    ctx = tvm.cpu(0)
+    costs = []
+    for _, shape, k in WORKLOADS:
+        func, oshapes, odtypes = build_sort(shape, k)
+        args = [tvm.nd.array(np.random.uniform(size=shape).astype("float32"), ctx)]
+        for oshape, odtype in zip(oshapes, odtypes):
+            args.append(tvm.nd.empty([int(x) for x in oshape], odtype, ctx))
+        ftimer = func.time_evaluator(func.entry_name, ctx, number=number, repeat=repeat)
+        costs.append(np.mean(ftimer(*args).results) * 1000)
+    return costs
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--number", type=int, default=50)
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--child", type=str, default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child is not None:
+        costs = measure(args.number, args.repeat)
+        print(" ".join("%.4f" % c for c in costs))
+        sys.exit(0)
+
+    settings = ["baseline", "current"]
+    results = {}
+    for setting in settings:
+        env = dict(os.environ, TVM_SORT_BASELINE="1" if setting == "baseline" else "0")
+        cmd = [sys.executable, __file__, "--child", setting,
+               "--number", str(args.number), "--repeat", str(args.repeat)]
+        results[setting] = subprocess.check_output(cmd, env=env).decode().split()
+
+    print("--------------------------------------------------------------")
+    print("%-16s %-14s %-12s %-12s %-8s" % ("Workload", "Shape", "Baseline", "Current", "Speedup"))
+    print("--------------------------------------------------------------")
+    for i, (name, shape, _) in enumerate(WORKLOADS):
+        base, cur = float(results["baseline"][i]), float(results["current"][i])
+        print("%-16s %-14s %-12s %-12s %-8s" % (
+            name, "x".join(str(x) for x in shape), "%.4f ms" % base, "%.4f ms" % cur,
+            "%.2fx" % (base / cur)))
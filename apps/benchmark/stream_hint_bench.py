@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the prefetch and non-temporal store hints.
+
+A vectorized elementwise add is built for array sizes around the thresholds
+of the InjectStreamHint pass, without the hints, with the hints under the
+default size thresholds (build_config(inject_stream_hint=True)) and with the
+hints on every loop regardless of size (TVM_STREAM_HINT_FORCE=1). Comparing
+the last two columns shows whether the thresholds skip the sizes at which
+the hints do not pay off. Each setting runs in its own process, since the
+settings are read once per process.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+import numpy as np
+
+import tvm
+
+# Sizes in bytes of each of the two arrays, around the 256KB streaming
+# threshold and the 4MB non-temporal threshold.
+SIZES = [64 << 10, 256 << 10, 1 << 20, 4 << 20, 16 << 20, 64 << 20, 256 << 20]
+
+
+def build_add(n, target, hint, parallel):
+    """Build B = A + 1 of n float32 elements"""
+    A = tvm.placeholder((n,), name="A")
+    B = tvm.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = tvm.create_schedule(B.op)
+    if parallel:
+        xo, xi = s[B].split(B.op.axis[0], nparts=64)
+        xi, xv = s[B].split(xi, factor=8)
+        s[B].parallel(xo)
+    else:
+        _, xv = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xv)
+    with tvm.build_config(inject_stream_hint=hint):
+        return tvm.build(s, [A, B], target)
+
+
+def measure(target, hint, parallel, number, repeat):
+    """Mean time in ms of every size"""
+    ctx = tvm.context(target, 0)
+    costs = []
+    for size in SIZES:
+        n = size // 4
+        func = build_add(n, target, hint, parallel)
+        a = tvm.nd.array(np.random.uniform(size=n).astype("float32"), ctx)
+        b = tvm.nd.empty((n,), "float32", ctx)
+        ftimer = func.time_evaluator(func.entry_name, ctx, number=number, repeat=repeat)
+        costs.append(np.mean(ftimer(a, b).results) * 1000)
+    return costs
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--parallel", action="store_true")
+    parser.add_argument("--number", type=int, default=20)
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--child", type=str, default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child is not None:
+        costs = measure(args.target, args.child != "off", args.parallel,
+                        args.number, args.repeat)
+        print(" ".join("%.4f" % c for c in costs))
+        sys.exit(0)
+
+    settings = ["off", "default", "force"]
+    results = {}
+    for setting in settings:
+        env = dict(os.environ, TVM_STREAM_HINT_FORCE="1" if setting == "force" else "0")
+        cmd = [sys.executable, __file__, "--child", setting, "--target", args.target,
+               "--number", str(args.number), "--repeat", str(args.repeat)]
+        if args.parallel:
+            cmd.append("--parallel")
+        results[setting] = subprocess.check_output(cmd, env=env).decode().split()
+
+    print("--------------------------------------------------")
+    print("%-12s %-12s %-12s %-12s" % ("Size", "Hint Off", "Default", "Forced"))
+    print("--------------------------------------------------")
+    for i, size in enumerate(SIZES):
+        row = ["%dKB" % (size >> 10)] + ["%s ms" % results[s][i] for s in settings]
+        print("%-12s %-12s %-12s %-12s" % tuple(row))
@@ -28,6 +28,8 @@
 #include <unordered_map>
 #include <memory>
 #include <limits>
+#include <functional>
+#include <utility>
 #include "expr.h"
 
 namespace tvm {
@@ -137,6 +139,8 @@ class ConstIntBoundAnalyzer {
    * \return an exit function that must be called to cleanup the constraint can be nullptr.
    */
   std::function<void()> EnterConstraint(const Expr& constraint);
+  /*! \brief The parent analyzer. */
+  Analyzer* parent_;
   struct Entry;
   class Impl;
   /*! \brief Internal impl */
@@ -216,6 +220,8 @@ class ModularSetAnalyzer {
    * \return an exit function that must be called to cleanup the constraint can be nullptr.
    */
   std::function<void()> EnterConstraint(const Expr& constraint);
+  /*! \brief The parent analyzer. */
+  Analyzer* parent_;
   struct Entry;
   class Impl;
   /*! \brief Internal impl */
@@ -253,6 +259,8 @@ class RewriteSimplifier {
   friend class CanonicalSimplifier;
   explicit RewriteSimplifier(Analyzer* parent);
   ~RewriteSimplifier();
+  /*! \brief The parent analyzer. */
+  Analyzer* parent_;
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
@@ -286,6 +294,8 @@ class CanonicalSimplifier {
   friend class ConstraintContext;
   explicit CanonicalSimplifier(Analyzer* parent);
   ~CanonicalSimplifier();
+  /*! \brief The parent analyzer. */
+  Analyzer* parent_;
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
@@ -461,6 +471,106 @@ class IntSetAnalyzer {
   Impl* impl_;
 };
 
+/*!
+ * \brief Memo of simplification results shared by the sub-analyzers.
+ *
+ *  Expressions are hash-consed by structure, so structurally identical
+ *  expressions hit the same entry. Each entry is tagged with the version
+ *  of the constraint scope it was computed in, and records the version of
+ *  the information about each variable of the expression. It is only reused
+ *  in the same scope and while the information about those variables is
+ *  unchanged, so rebinding a variable only invalidates the entries using it.
+ */
+class SimplifyMemo {
+ public:
+  /*! \brief The sub-analyzer that produced a result. */
+  enum Kind : int {
+    kRewrite = 0,
+    kCanonical = 1
+  };
+  /*!
+   * \brief constructor
+   *  The memo can be disabled with TVM_ARITH_SIMPLIFY_MEMO=0 to measure its effect.
+   */
+  SimplifyMemo();
+  /*! \brief Snapshot of the analyzer state. */
+  struct State {
+    /*! \brief The version of the constraint scope. */
+    uint64_t version;
+    /*! \brief The number of variable updates so far. */
+    uint64_t num_updates;
+  };
+  /*!
+   * \brief Look up a memoized result under the current state.
+   * \param kind The sub-analyzer.
+   * \param expr The input expression.
+   * \param result The memoized result, set on success.
+   * \return Whether the lookup succeeded.
+   */
+  bool Lookup(Kind kind, const Expr& expr, Expr* result) const;
+  /*!
+   * \brief Memoize a result.
+   * \param kind The sub-analyzer.
+   * \param state The state returned by state() before the result was computed.
+   * \param expr The input expression.
+   * \param result The result.
+   *
+   * \note The result is dropped if the state changed while it was computed.
+   */
+  void Insert(Kind kind, const State& state, const Expr& expr, const Expr& result);
+  /*!
+   * \brief Notify that information about a variable changed.
+   * \param var The variable.
+   * \param info The new information if it is an expression. Rebinding a
+   *        variable it refers to later also invalidates var.
+   */
+  void Invalidate(const Var& var, const Expr& info = Expr());
+  /*!
+   * \brief Enter a constraint scope.
+   * \return The function to call when leaving the scope.
+   */
+  std::function<void()> EnterConstraint();
+  /*! \return The current state. */
+  State state() const {
+    return State{version_, num_updates_};
+  }
+
+ private:
+  struct Key {
+    Expr expr;
+    uint64_t version;
+    int kind;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const;
+  };
+  struct Entry {
+    /*! \brief The memoized result. */
+    Expr result;
+    /*! \brief The variables of the input and the version of their information. */
+    std::vector<std::pair<Var, uint64_t> > deps;
+  };
+  /*! \return The version of the information about var. */
+  uint64_t VarVersion(const Var& var) const;
+  /*! \brief Whether results are memoized. */
+  bool enabled_;
+  /*! \brief The version of the current constraint scope. */
+  uint64_t version_{0};
+  /*! \brief The last version handed out. */
+  uint64_t last_version_{0};
+  /*! \brief The number of variable updates so far. */
+  uint64_t num_updates_{0};
+  /*! \brief The version of the information about each updated variable. */
+  std::unordered_map<Var, uint64_t, ObjectHash, ObjectEqual> var_version_;
+  /*! \brief The variables whose information refers to each variable. */
+  std::unordered_map<Var, std::vector<Var>, ObjectHash, ObjectEqual> var_users_;
+  /*! \brief The memo table. */
+  std::unordered_map<Key, Entry, KeyHash, KeyEqual> table_;
+};
+
 /*!
  * \brief Analyzer that contains bunch of sub-analyzers.
  *
@@ -488,6 +598,8 @@ class Analyzer {
   CanonicalSimplifier canonical_simplify;
   /*! \brief sub-analyzer: int set */
   IntSetAnalyzer int_set;
+  /*! \brief memo of simplification results */
+  SimplifyMemo memo;
   /*! \brief constructor */
   Analyzer();
   /*!
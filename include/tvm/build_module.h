@@ -235,6 +235,9 @@ class BuildConfigNode : public Object {
   /*! \brief Whether to disable assert stmt generation. */
   bool disable_assert = false;
 
+  /*! \brief Whether to inject prefetch and non-temporal store hints on CPU. */
+  bool inject_stream_hint = false;
+
   void VisitAttrs(AttrVisitor* v) {
     v->Visit("data_alignment", &data_alignment);
     v->Visit("offset_factor", &offset_factor);
@@ -251,6 +254,7 @@ class BuildConfigNode : public Object {
     v->Visit("disable_select_rewriting", &disable_select_rewriting);
     v->Visit("disable_vectorize", &disable_vectorize);
     v->Visit("disable_assert", &disable_assert);
+    v->Visit("inject_stream_hint", &inject_stream_hint);
   }
 
   static constexpr const char* _type_key = "BuildConfig";
@@ -307,13 +311,15 @@ class BuildConfig : public ::tvm::ObjectRef {
 * \param name The name of the lowered function.
 * \param binds Buffer assignments.
 * \param config The build configuration.
+* \param target The target to lower for, the current target is used when undefined.
 * \return The lowered function.
 */
 TVM_DLL Array<LoweredFunc> lower(Schedule sch,
                                  const Array<Tensor>& args,
                                  const std::string& name,
                                  const std::unordered_map<Tensor, Buffer>& binds,
-                                 const BuildConfig& config);
+                                 const BuildConfig& config,
+                                 const Target& target = Target());
 /*!
 * \brief Split host/device function and running necessary pass before build
 * \param funcs The functions to be built.
@@ -1255,6 +1255,11 @@ constexpr const char* pragma_tensor_core = "pragma_tensor_core";
  *  run prefetch of Tensor on the current loop scope
  */
 constexpr const char* prefetch_scope = "prefetch_scope";
+/*!
+ * \brief Mark the stores into the buffer in the scope as non-temporal,
+ *  the stores are fenced at the end of the scope.
+ */
+constexpr const char* nontemporal_store = "nontemporal_store";
 /*!
  * \brief Marks production of double buffer data
  */
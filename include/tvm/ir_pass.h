@@ -37,6 +37,9 @@
 #include "lowered_func.h"
 
 namespace tvm {
+
+class Target;
+
 namespace ir {
 
 /*!
@@ -257,9 +260,11 @@ Stmt UnrollLoop(Stmt stmt,
 /*!
  * \brief vectorize the constant loops
  * \param stmt The statement to be vectorized.
+ * \param target The target to lower for, it decides the vector width of
+ *  loops with symbolic extent. The current target is used when undefined.
  * \return Transformed stmt.
  */
-Stmt VectorizeLoop(Stmt stmt);
+Stmt VectorizeLoop(Stmt stmt, const Target& target);
 
 /*!
  * \brief convert vectorized loops into serialized loops
@@ -493,6 +498,14 @@ LoweredFunc RemapThreadAxis(LoweredFunc f, Map<Expr, IterVar> axis_map);
  */
 LoweredFunc LowerTVMBuiltin(LoweredFunc f);
 
+/*!
+ * \brief Inject software prefetch and non-temporal store hints
+ *  into the streaming loops of a CPU host function.
+ * \param f The host function to be transformed.
+ * \return Transformed function.
+ */
+LoweredFunc InjectStreamHint(LoweredFunc f);
+
 /*!
  * \brief Combine context function calls.
  * \param f The host function to be lowered.
@@ -524,7 +537,8 @@ LoweredFunc LowerDeviceStorageAccessInfo(LoweredFunc func);
 /*!
  * \brief Lower intrinsic function calls.
  * \param f The device function to be lowered.
- * \param target The target device.
+ * \param target The target string. The triple of a llvm target also selects
+ *        the rules of its architecture.
  * \return Transformed function.
  */
 LoweredFunc LowerIntrin(LoweredFunc f, const std::string& target);
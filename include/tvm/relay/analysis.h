@@ -293,6 +293,8 @@ struct StructuralHash {
   /*! \brief Hash a Relay expression.
    *
    * Implements structural hashing of a Relay expression.
+   * The result is cached on the expression node, so repeated
+   * hashing of the same expression is constant time.
    *
    * \param expr the expression to hash.
    *
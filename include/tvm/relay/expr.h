@@ -37,6 +37,22 @@ namespace relay {
  * \brief A Relay expression.
  */
 class Expr;
+/*!
+ * \brief A lazily computed hash value cached on an expression node.
+ *
+ * \note The value is reset rather than copied when the owning node is
+ *  copied, since nodes are usually copied in order to be modified.
+ *  Zero means the value has not been computed yet.
+ */
+struct ExprHashCache {
+  size_t value{0};
+  ExprHashCache() = default;
+  ExprHashCache(const ExprHashCache& other) {}
+  ExprHashCache& operator=(const ExprHashCache& other) {
+    value = 0;
+    return *this;
+  }
+};
 /*!
  * \brief Base type of the Relay expression hiearchy.
  */
@@ -49,6 +65,12 @@ class ExprNode : public RelayNode {
    *       This value is discarded during serialization.
    */
   mutable Type checked_type_ = Type(nullptr);
+  /*!
+   * \brief Caches the structural hash of the expression.
+   *
+   * \note Filled by StructuralHash, discarded during serialization.
+   */
+  mutable ExprHashCache structural_hash_;
   /*!
    * \return The checked_type
    */
@@ -34,6 +34,8 @@ namespace qnn {
 /*! \brief Attribute for requantize operator */
 struct RequantizeAttrs : public tvm::AttrsNode<RequantizeAttrs> {
   double input_scale;
+  Array<tvm::Expr> input_scales;
+  int axis;
   int32_t input_zero_point;
   double output_scale;
   int32_t output_zero_point;
@@ -43,6 +45,12 @@ struct RequantizeAttrs : public tvm::AttrsNode<RequantizeAttrs> {
   TVM_DECLARE_ATTRS(RequantizeAttrs, "relay.attrs.RequantizeAttrs") {
     TVM_ATTR_FIELD(input_scale)
         .describe("The scale of the input tensor.");
+    TVM_ATTR_FIELD(input_scales)
+        .set_default(Array<tvm::Expr>())
+        .describe("The per-channel scales of the input tensor along axis. If empty,"
+                  "input_scale is used for the whole tensor.");
+    TVM_ATTR_FIELD(axis).set_default(-1)
+        .describe("The channel axis of the input tensor for per-channel input_scales.");
     TVM_ATTR_FIELD(input_zero_point)
         .describe("The zero point of the input tensor.");
     TVM_ATTR_FIELD(output_scale)
@@ -139,6 +147,7 @@ struct QnnConv2DAttrs : public tvm::AttrsNode<QnnConv2DAttrs> {
   // for easy access to this information.
   double input_scale;
   double kernel_scale;
+  Array<tvm::Expr> kernel_scales;
 
   TVM_DECLARE_ATTRS(QnnConv2DAttrs, "relay.attrs.QnnConv2DAttrs") {
     TVM_ATTR_FIELD(strides).set_default(Array<IndexExpr>({1, 1}))
@@ -185,6 +194,10 @@ struct QnnConv2DAttrs : public tvm::AttrsNode<QnnConv2DAttrs> {
       .describe("The quantization scale for the input tensor.");
     TVM_ATTR_FIELD(kernel_scale)
       .describe("The quantization scale for the weight tensor.");
+    TVM_ATTR_FIELD(kernel_scales)
+      .set_default(Array<tvm::Expr>())
+      .describe("The per output channel quantization scales for the weight tensor."
+                "If empty, kernel_scale is used for the whole tensor.");
   }
 };
 
@@ -222,6 +235,7 @@ struct QnnDenseAttrs : public tvm::AttrsNode<QnnDenseAttrs> {
   int32_t kernel_zero_point;
   double input_scale;
   double kernel_scale;
+  Array<tvm::Expr> kernel_scales;
 
   TVM_DECLARE_ATTRS(QnnDenseAttrs, "relay.attrs.QnnDenseAttrs") {
     TVM_ATTR_FIELD(units)
@@ -236,6 +250,10 @@ struct QnnDenseAttrs : public tvm::AttrsNode<QnnDenseAttrs> {
       .describe("The input tensor scale.");
     TVM_ATTR_FIELD(kernel_scale)
       .describe("The kernel tensor scale.");
+    TVM_ATTR_FIELD(kernel_scales)
+      .set_default(Array<tvm::Expr>())
+      .describe("The per unit kernel tensor scales. If empty, kernel_scale is used"
+                "for the whole tensor.");
   }
 };
 
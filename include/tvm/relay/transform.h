@@ -99,6 +99,12 @@ class PassContextNode : public RelayNode {
   /*! \brief The list of disabled passes. */
   tvm::Array<tvm::Expr> disabled_pass;
 
+  /*!
+   * \brief The cost model FuseOps consults for every fusion candidate.
+   *  Greedy fusion is used when it is not set.
+   */
+  runtime::PackedFunc fusion_cost_model;
+
   PassContextNode() = default;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
@@ -27,10 +27,18 @@
 
 TVM_MICRO_RUNTIME_API_API void* UTVMRuntimeCreate(const char* json, size_t json_len, void* module);
 
+TVM_MICRO_RUNTIME_API_API size_t UTVMRuntimeArenaSize(const char* json, size_t json_len);
+
+TVM_MICRO_RUNTIME_API_API void* UTVMRuntimeCreateWithArena(const char* json, size_t json_len,
+                                                           void* module, void* arena,
+                                                           size_t arena_size);
+
 TVM_MICRO_RUNTIME_API_API void UTVMRuntimeDestroy(void* handle);
 
 TVM_MICRO_RUNTIME_API_API void UTVMRuntimeSetInput(void* handle, int index, void* tensor);
 
+TVM_MICRO_RUNTIME_API_API void UTVMRuntimeSetInputZeroCopy(void* handle, int index, void* tensor);
+
 TVM_MICRO_RUNTIME_API_API void UTVMRuntimeRun(void* handle);
 
 TVM_MICRO_RUNTIME_API_API void UTVMRuntimeGetOutput(void* handle, int index, void* tensor);
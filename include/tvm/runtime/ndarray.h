@@ -102,10 +102,11 @@ class NDArray : public ObjectRef {
    * \brief Create a NDArray that shares the data memory with the current one.
    * \param shape The shape of the new array.
    * \param dtype The data type of the new array.
-   * \note The memory size of new array must be smaller than the current one.
+   * \param relative_byte_offset The offset of the view from the start of the current one.
+   * \note The memory size of new array plus its offset must not exceed the current one.
    */
   TVM_DLL NDArray CreateView(
-      std::vector<int64_t> shape, DLDataType dtype);
+      std::vector<int64_t> shape, DLDataType dtype, uint64_t relative_byte_offset = 0);
   /*!
    * \brief Create a reference view of NDArray that
    *  represents as DLManagedTensor.
@@ -27,9 +27,11 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tvm {
@@ -571,6 +573,15 @@ class Executable : public ModuleNode {
    * corresponds to the position of the `packed_funcs` list in a `VirtualMachine` object.
    */
   std::unordered_map<std::string, Index> primitive_map;
+  /*!
+   * \brief Specializers of the primitives with dynamic shapes, keyed by the
+   * index of the primitive in `packed_funcs`.
+   *
+   * A specializer is called with the arguments of the primitive and returns a
+   * kernel compiled for their concrete shapes, or nothing if it cannot
+   * specialize. Specializers require the compiler and are not serialized.
+   */
+  std::unordered_map<Index, PackedFunc> kernel_specializers;
   /*! \brief The virtual machine's function table. */
   std::vector<VMFunction> functions;
 
@@ -701,6 +712,30 @@ class VirtualMachine : public runtime::ModuleNode {
   std::unordered_map<std::string, std::vector<ObjectRef>> inputs_;
   /*! \brief The set of TVM contexts the VM is currently executing on. */
   std::vector<TVMContext> ctxs_;
+  /*!
+   * \brief Kernels specialized for concrete argument shapes, keyed by the
+   * index of the primitive and the shapes of its arguments.
+   *
+   * Each table holds at most `max_kernel_specializations_` kernels, shapes
+   * seen after it is full run the generic kernel and are not recorded.
+   */
+  std::unordered_map<Index, std::map<std::vector<int64_t>, PackedFunc>> specialized_funcs_;
+  /*! \brief The primitives whose specializer could not specialize them. */
+  std::unordered_set<Index> unspecializable_funcs_;
+  /*! \brief The maximum number of specialized kernels per primitive, 0 disables them. */
+  size_t max_kernel_specializations_{0};
+
+  /*!
+   * \brief Select the kernel to run for the given arguments, specializing
+   * the primitive for their shapes on first sight if possible.
+   * \param packed_index The index of the primitive.
+   * \param func The generic kernel of the primitive.
+   * \param args The flattened arguments of the primitive.
+   * \param shape_key The shapes of the arguments.
+   * \return The kernel to run.
+   */
+  const PackedFunc& SelectKernel(Index packed_index, const PackedFunc& func,
+                                 const TVMArgs& args, const std::vector<int64_t>& shape_key);
 
   /*! \brief Push a call frame on to the call stack. */
   void PushFrame(Index arg_count, Index ret_pc, const VMFunction& vm_func);
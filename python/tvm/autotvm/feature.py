@@ -52,11 +52,21 @@ try:
         "autotvm.feature.GetCurveSampleFeatureFlatten")
     _get_itervar_feature = get_global_func("autotvm.feature.GetItervarFeature")
     _get_itervar_feature_flatten = get_global_func("autotvm.feature.GetItervarFeatureFlatten")
+    _get_itervar_feature_flatten_batch = get_global_func(
+        "autotvm.feature.GetItervarFeatureFlattenBatch")
+    _get_buffer_curve_sample_flatten_batch = get_global_func(
+        "autotvm.feature.GetCurveSampleFeatureFlattenBatch")
+    _get_cache_feature_flatten = get_global_func("autotvm.feature.GetCacheFeatureFlatten")
 except ValueError as e:
     def raise_error(*args, **kwargs):  # pylint: disable=unused-argument
         raise RuntimeError("Cannot load autotvm c++ API")
     _get_buffer_curve_sample_flatten = _get_itervar_feature = _get_itervar_feature_flatten = \
         raise_error
+    _get_itervar_feature_flatten_batch = _get_buffer_curve_sample_flatten_batch = raise_error
+    _get_cache_feature_flatten = raise_error
+
+# default capacity in bytes of L1, L2 and last level cache for cache features
+DEFAULT_CACHE_SIZES = (32 * 1024, 256 * 1024, 8 * 1024 * 1024)
 
 def get_itervar_feature(sch, args, take_log=False):
     """get features of iter vars
@@ -127,6 +137,60 @@ def get_itervar_feature_flatten(sch, args, take_log=True):
     feas = struct.unpack('%df' % (len(feas)//4), feas)
     return feas
 
+def get_cache_feature_flatten(sch, args, take_log=True, cache_sizes=DEFAULT_CACHE_SIZES,
+                              with_itervar=False):
+    """get flatten cache-aware features of iter vars
+
+    For every axis, this estimates the working set and the reuse distance in bytes,
+    whether they fit in each cache level, and the vectorization and alignment
+    of its memory accesses.
+
+    Parameters
+    ----------
+    sch: tvm.schedule.Schedule
+    args: Array of tvm.tensor.Tensor
+        the buffer args for lower
+    take_log: bool
+        whether take log of numerical statics
+    cache_sizes: tuple of int
+        capacity in bytes of each cache level, from L1 to the last level cache
+    with_itervar: bool
+        whether prepend the itervar feature of get_itervar_feature_flatten,
+        sharing a single lowering
+
+    Returns
+    -------
+    flatten_feature: np.ndarray
+        one-dimensional vector
+    """
+    stmt = ana_lower(sch, args, simple_mode=True)
+    feas = _get_cache_feature_flatten(stmt, take_log, list(cache_sizes))
+    feas = struct.unpack('%df' % (len(feas)//4), feas)
+    if with_itervar:
+        itervar = _get_itervar_feature_flatten(stmt, take_log)
+        feas = struct.unpack('%df' % (len(itervar)//4), itervar) + feas
+    return feas
+
+def get_itervar_feature_flatten_batch(schs, args_list, take_log=True):
+    """get flatten features of iter vars for a batch of schedules
+    Schedules are lowered serially, the extraction runs in parallel on the C++ thread pool.
+
+    Parameters
+    ----------
+    schs: list of tvm.schedule.Schedule
+    args_list: list of Array of tvm.tensor.Tensor
+        the buffer args for lower, one per schedule
+    take_log: bool
+        whether take log of numerical statics
+
+    Returns
+    -------
+    flatten_feature: np.ndarray
+        two-dimensional matrix, one zero padded row per schedule.
+        Rows of schedules that fail to lower are all zeros.
+    """
+    return _get_itervar_feature_flatten_batch(schs, args_list, take_log).asnumpy()
+
 def get_flatten_name(fea):
     """ Get names of feature after flatten.
 
@@ -195,3 +259,25 @@ def get_buffer_curve_sample_flatten(sch, args, sample_n=30):
     feas = _get_buffer_curve_sample_flatten(stmt, sample_n, False)
     feas = struct.unpack('%df' % (len(feas)//4), feas)
     return feas
+
+
+def get_buffer_curve_sample_flatten_batch(schs, args_list, sample_n=30):
+    """
+    Get flatten curve sample feature (relation feature) for a batch of schedules.
+    Schedules are lowered serially, the extraction runs in parallel on the C++ thread pool.
+
+    Parameters
+    ----------
+    schs: list of tvm.schedule.Schedule
+    args_list: list of Array of tvm.tensor.Tensor
+        the buffer args for lower, one per schedule
+    sample_n: int
+        number of sample points along one dimension
+
+    Returns
+    -------
+    flatten_feature: np.ndarray
+        two-dimensional matrix, one zero padded row per schedule.
+        Rows of schedules that fail to lower are all zeros.
+    """
+    return _get_buffer_curve_sample_flatten_batch(schs, args_list, sample_n).asnumpy()
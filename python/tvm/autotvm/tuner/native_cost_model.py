@@ -0,0 +1,222 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Cost model, model optimizer and tuner that run natively in C++
+
+The model is a gradient boosted tree ensemble trained on knob features.
+Knob features of every entity are tabulated once per config space, so the
+simulated annealing search can score candidates entirely in C++.
+"""
+import numpy as np
+
+from tvm import nd, get_global_func
+
+from ..task.space import SplitEntity, ReorderEntity, AnnotateEntity, \
+    OtherOptionEntity, _ann_to_number
+from .model_based_tuner import CostModel, ModelOptimizer, ModelBasedTuner
+
+
+def _entity_feature(index, entity):
+    """numerical feature of one entity, consistent with ConfigEntity.get_flatten_feature"""
+    if isinstance(entity, SplitEntity):
+        return list(entity.size)
+    if isinstance(entity, ReorderEntity):
+        return list(entity.perm)
+    if isinstance(entity, AnnotateEntity):
+        fea = []
+        for ann in entity.anns:
+            tmp = [0] * len(_ann_to_number)
+            tmp[_ann_to_number[ann]] = 1
+            fea.extend(tmp)
+        return fea
+    if isinstance(entity, OtherOptionEntity):
+        try:
+            return [float(entity.val)]
+        except (TypeError, ValueError):
+            return [index]
+    return [index]
+
+
+def knob_feature_table(space):
+    """Tabulate the knob features of a config space
+
+    Parameters
+    ----------
+    space: ConfigSpace
+        The config space
+
+    Returns
+    -------
+    dims: np.ndarray of int64
+        The number of entities of each knob
+    widths: np.ndarray of int64
+        The feature width of each knob
+    table: np.ndarray of float32
+        The feature rows of all entities, flattened knob by knob
+    """
+    dims, widths, rows = [], [], []
+    for knob in space.space_map.values():
+        feas = [_entity_feature(i, e) for i, e in enumerate(knob.entities)]
+        width = len(feas[0])
+        assert all(len(x) == width for x in feas), "knob features must have the same width"
+        dims.append(len(feas))
+        widths.append(width)
+        rows.extend(feas)
+    table = np.array([x for row in rows for x in row], dtype=np.float32)
+    return np.array(dims, dtype=np.int64), np.array(widths, dtype=np.int64), table
+
+
+class NativeCostModel(CostModel):
+    """Gradient boosted tree cost model implemented in C++
+
+    Parameters
+    ----------
+    task: Task
+        The tuning task
+    n_trees: int, optional
+        The number of trees of the ensemble
+    max_depth: int, optional
+        The maximum depth of a tree
+    learning_rate: float, optional
+        The shrinkage applied to each tree
+    min_samples_leaf: int, optional
+        The minimum number of samples in a leaf
+    max_history: int, optional
+        The maximum number of samples the model is refit on, the latest ones
+        are kept. 0 keeps all of them.
+    seed: int, optional
+        The random seed of the search
+    """
+    def __init__(self, task, n_trees=100, max_depth=6, learning_rate=0.3,
+                 min_samples_leaf=2, max_history=10000, seed=0):
+        super(NativeCostModel, self).__init__()
+        self.task = task
+        self.params = (n_trees, max_depth, learning_rate, min_samples_leaf, max_history, seed)
+        self._mod = get_global_func("autotvm.cost_model.CreateGBTModel")(*self.params)
+        dims, widths, table = knob_feature_table(task.config_space)
+        self._mod["set_space"](nd.array(dims), nd.array(widths), nd.array(table))
+        self.table = (dims, widths, table)
+        self.base_model = None
+        # unnormalized training set of this model, reused when it serves as a base model
+        self.xs = None
+        self.ys = None
+
+    def _features(self, xs):
+        dims, widths, table = self.table
+        offsets = np.concatenate(([0], np.cumsum(dims * widths)))
+        xs = np.array(xs, dtype=np.int64)
+        ret = []
+        for k, (dim, width) in enumerate(zip(dims, widths)):
+            knob = table[offsets[k]:offsets[k + 1]].reshape((dim, width))
+            ret.append(knob[xs % dim])
+            xs = xs // dim
+        return np.concatenate(ret, axis=1).astype(np.float32)
+
+    def fit(self, xs, ys, plan_size):
+        x = self._features(xs)
+        y = np.array(ys, dtype=np.float32)
+        self.xs, self.ys = x, y
+        if self.base_model is not None and self.base_model.xs is not None:
+            # refit on the history of the base model together with the new samples
+            x = np.concatenate((self.base_model.xs, x))
+            y = np.concatenate((self.base_model.ys, y))
+        # normalize all the samples by one maximum
+        y = y / max(np.max(y), 1e-8)
+        self._mod["fit"](nd.array(x), nd.array(y))
+
+    def fit_log(self, records, plan_size):
+        xs, ys = [], []
+        for inp, res in records:
+            if inp.task.name != self.task.name or inp.task.args != self.task.args:
+                continue
+            xs.append(inp.config.index)
+            ys.append(inp.task.flop / np.mean(res.costs) if res.error_no == 0 else 0.0)
+        if not xs or max(ys) < 1e-6:
+            return False
+        self.fit(xs, ys, plan_size)
+        return True
+
+    def predict(self, xs, output_margin=False):
+        xs = nd.array(np.array(xs, dtype=np.int64))
+        return self._mod["predict_points"](xs).asnumpy()
+
+    def load_basemodel(self, base_model):
+        self.base_model = base_model
+
+    def spawn_base_model(self):
+        return NativeCostModel(self.task, *self.params)
+
+
+class NativeSAOptimizer(ModelOptimizer):
+    """Simulated annealing over a NativeCostModel, run entirely in C++.
+    The parameters have the same meaning as in SimulatedAnnealingOptimizer.
+
+    Parameters
+    ----------
+    task: Task
+        The tuning task
+    n_iter: int
+        The number of iterations of simulated annealing
+    temp: float or Array of float
+        If is a single float, then use a constant temperature.
+        If is an Array, then perform linear cooling from temp[0] to temp[1]
+    persistent: bool
+        Whether to resume the walkers of the previous search
+    parallel_size: int
+        The number of walkers
+    early_stop: int, optional
+        Stop iteration if the optimal set do not change in `early_stop` rounds
+    """
+    def __init__(self, task, n_iter=500, temp=(1, 0), persistent=True, parallel_size=128,
+                 early_stop=50):
+        super(NativeSAOptimizer, self).__init__()
+        self.task = task
+        self.n_iter = n_iter
+        self.temp = temp if isinstance(temp, (tuple, list)) else (temp, temp)
+        self.persistent = persistent
+        self.parallel_size = parallel_size
+        self.early_stop = early_stop or 1 << 30
+
+    def find_maximums(self, model, num, exclusive):
+        assert isinstance(model, NativeCostModel), \
+            "NativeSAOptimizer only works with NativeCostModel"
+        exclusive = nd.array(np.array(list(exclusive), dtype=np.int64))
+        ret = model._mod["find_maximums"](  # pylint: disable=protected-access
+            num, self.n_iter, float(self.temp[0]), float(self.temp[1]),
+            self.parallel_size, self.early_stop, exclusive, self.persistent)
+        return [int(x) for x in ret.asnumpy()]
+
+
+class NativeTuner(ModelBasedTuner):
+    """Tuner that uses the native gradient boosted tree cost model
+    and the native simulated annealing optimizer
+
+    Parameters
+    ----------
+    task: Task
+        The tuning task
+    plan_size: int
+        The size of a plan. After `plan_size` trials, the tuner will refit a new cost model
+        and do planing for the next `plan_size` trials.
+    diversity_filter_ratio: int or float, optional
+        If is not None, the tuner will first select
+        top-(plan_size * diversity_filter_ratio) candidates according to the cost model
+        and then pick batch_size of them according to the diversity metric.
+    """
+    def __init__(self, task, plan_size=64, diversity_filter_ratio=None):
+        super(NativeTuner, self).__init__(task, NativeCostModel(task), NativeSAOptimizer(task),
+                                          plan_size, diversity_filter_ratio)
@@ -45,6 +45,8 @@ class XGBoostCostModel(CostModel):
         If is 'itervar', use features extracted from IterVar (loop variable).
         If is 'knob', use flatten ConfigEntity directly.
         If is 'curve', use sampled curve feature (relation feature).
+        If is 'cache', use itervar feature plus cache-aware feature
+        (working set, reuse distance and vectorization of each loop).
 
         Note on choosing feature type:
         For single task tuning, 'itervar' and 'knob' are good.
@@ -129,6 +131,8 @@ class XGBoostCostModel(CostModel):
             self.feature_extract_func = _extract_knob_feature_index
         elif feature_type == 'curve':
             self.feature_extract_func = _extract_curve_feature_index
+        elif feature_type == 'cache':
+            self.feature_extract_func = _extract_cache_feature_index
         else:
             raise RuntimeError("Invalid feature type " + feature_type)
 
@@ -234,6 +238,8 @@ class XGBoostCostModel(CostModel):
             feature_extract_func = _extract_knob_feature_log
         elif self.fea_type == 'curve':
             feature_extract_func = _extract_curve_feature_log
+        elif self.fea_type == 'cache':
+            feature_extract_func = _extract_cache_feature_log
         else:
             raise RuntimeError("Invalid feature type: " + self.fea_type)
         res = pool.map(feature_extract_func, data)
@@ -417,6 +423,36 @@ def _extract_curve_feature_log(arg):
     except Exception:  # pylint: disable=broad-except
         return None
 
+def _extract_cache_feature_index(index):
+    """extract itervar and cache feature for an index in extract_space"""
+    try:
+        config = _extract_space.get(index)
+        with _extract_target:
+            sch, args = _extract_task.instantiate(config)
+        fea = feature.get_cache_feature_flatten(sch, args, take_log=True, with_itervar=True)
+        fea = np.concatenate((fea, list(config.get_other_option().values())))
+        return np.array(fea)
+    except Exception:  # pylint: disable=broad-except
+        return None
+
+def _extract_cache_feature_log(arg):
+    """extract itervar and cache feature for log items"""
+    try:
+        inp, res = arg
+        config = inp.config
+        with inp.target:
+            sch, args = inp.task.instantiate(config)
+        fea = feature.get_cache_feature_flatten(sch, args, take_log=True, with_itervar=True)
+        x = np.concatenate((fea, list(config.get_other_option().values())))
+
+        if res.error_no == 0:
+            y = inp.task.flop / np.mean(res.costs)
+        else:
+            y = 0.0
+        return x, y
+    except Exception:  # pylint: disable=broad-except
+        return None
+
 def custom_callback(stopping_rounds, metric, fevals, evals=(), log_file=None,
                     maximize=False, verbose_eval=True):
     """callback function for xgboost to support multiple custom evaluation functions"""
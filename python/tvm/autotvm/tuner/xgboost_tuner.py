@@ -34,6 +34,7 @@ class XGBTuner(ModelBasedTuner):
         If is 'itervar', use features extracted from IterVar (loop variable).
         If is 'knob', use flatten ConfigEntity directly.
         If is 'curve', use sampled curve feature (relation feature).
+        If is 'cache', use itervar feature plus cache-aware feature.
 
         Note on choosing feature type:
         For single task tuning, 'itervar' and 'knob' are good.
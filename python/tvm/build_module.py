@@ -145,7 +145,8 @@ class BuildConfig(NodeBase):
         "instrument_bound_checkers": False,
         "disable_select_rewriting": False,
         "disable_vectorize": False,
-        "disable_assert": False
+        "disable_assert": False,
+        "inject_stream_hint": False
     }
     _dump_ir = DumpIR()
 
@@ -251,6 +252,10 @@ def build_config(**kwargs):
 
     dump_pass_ir: dump ir of each pass into file idx_passname_ir.cc, default=False
 
+    inject_stream_hint: bool, default=False
+        Whether to inject software prefetch and non-temporal store hints
+        into the streaming loops of llvm host code.
+
     Returns
     -------
     config: BuildConfig
@@ -339,7 +344,8 @@ def lower(sch,
           args,
           name="default_function",
           binds=None,
-          simple_mode=False):
+          simple_mode=False,
+          target=None):
     """Lowering step before build into target.
 
     Parameters
@@ -362,6 +368,10 @@ def lower(sch,
         Whether only output simple and compact statement, this will skip
         LoopPartition, api wrapper generation and Unrolling.
 
+    target : str or :any:`tvm.target.Target`, optional
+        The target to lower for. It decides the vector width of loops
+        with symbolic extent. The current target is used by default.
+
     Returns
     -------
     f : LoweredFunc or Stmt
@@ -400,7 +410,8 @@ def lower(sch,
     if cfg.disable_vectorize:
         stmt = ir_pass.SkipVectorize(stmt)
     else:
-        stmt = ir_pass.VectorizeLoop(stmt)
+        stmt = ir_pass.VectorizeLoop(
+            stmt, _target.create(target) if target else _target.current_target())
     stmt = ir_pass.InjectVirtualThread(stmt)
     stmt = ir_pass.InjectDoubleBuffer(stmt, cfg.double_buffer_split_loop)
     stmt = ir_pass.StorageRewrite(stmt)
@@ -490,6 +501,9 @@ def _build_for_device(flist, target, target_host):
             "bind?" % target)
 
     fhost = [ir_pass.BindDeviceType(x, device_type) for x in fhost]
+    if _target.create(target_host).target_name == "llvm" and \
+            current_build_config().inject_stream_hint:
+        fhost = [ir_pass.InjectStreamHint(x) for x in fhost]
     fhost = [ir_pass.LowerTVMBuiltin(x) for x in fhost]
 
     if device_type == ndarray.cpu(0).device_type and target_host == target:
@@ -498,8 +512,8 @@ def _build_for_device(flist, target, target_host):
     target_host = _target.create(target_host)
     fdevice = [ir_pass.LowerDeviceStorageAccessInfo(x) for x in fdevice]
     fhost = [ir_pass.LowerDeviceStorageAccessInfo(x) for x in fhost]
-    fdevice = [ir_pass.LowerIntrin(x, target.target_name) for x in fdevice]
-    fhost = [ir_pass.LowerIntrin(x, target_host.target_name) for x in fhost]
+    fdevice = [ir_pass.LowerIntrin(x, str(target)) for x in fdevice]
+    fhost = [ir_pass.LowerIntrin(x, str(target_host)) for x in fhost]
     fhost = [ir_pass.CombineContextCall(x) for x in fhost]
     mdev = codegen.build_module(fdevice, str(target)) if fdevice else None
 
@@ -587,7 +601,8 @@ def build(inputs,
             raise ValueError("args must be given for build from schedule")
         flist = lower(inputs, args,
                       name=name,
-                      binds=binds)
+                      binds=binds,
+                      target=target)
         if isinstance(flist, container.LoweredFunc):
             flist = [flist]
     elif isinstance(inputs, container.LoweredFunc):
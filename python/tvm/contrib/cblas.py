@@ -17,7 +17,7 @@
 """External function interface to BLAS libraries."""
 from __future__ import absolute_import as _abs
 
-from .. import api as _api, intrin as _intrin
+from .. import api as _api, intrin as _intrin, ndarray as _nd
 
 
 def matmul(lhs, rhs, transa=False, transb=False, **kwargs):
@@ -54,6 +54,100 @@ def matmul(lhs, rhs, transa=False, transb=False, **kwargs):
     )
 
 
+def pack(rhs, transb=False):
+    """Pack the constant right operand of a float32 matmul for matmul_prepacked.
+
+    The packed copy is owned by the returned array. It has to be packed again
+    whenever rhs changes, e.g. after new parameters are loaded.
+
+    Parameters
+    ----------
+    rhs : NDArray
+        The right matrix operand
+    transb : bool
+        Whether transpose rhs
+
+    Returns
+    -------
+    packed : NDArray
+        The 1-D packed right operand.
+    """
+    k, m = (rhs.shape[1], rhs.shape[0]) if transb else rhs.shape
+    size = _api.get_global_func("tvm.contrib.cblas.sgemm_pack_size")(k, m)
+    packed = _nd.empty((size,), "float32", rhs.ctx)
+    _api.get_global_func("tvm.contrib.cblas.sgemm_pack")(rhs, packed, transb)
+    return packed
+
+
+def matmul_prepacked(lhs, packed_rhs, m, transa=False, transb=False, **kwargs):
+    """Create an extern op that compute the float32 matrix mult of lhs and a
+    right operand packed by pack. With MKL the packed operand is consumed by
+    cblas_sgemm_compute, otherwise it is a dense copy used by plain sgemm.
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The left matrix operand
+    packed_rhs : Tensor
+        The 1-D packed right matrix operand, of the size returned by pack
+    m : int
+        The number of columns of the result
+    transa : bool
+        Whether transpose lhs
+    transb : bool
+        Whether rhs was transposed when it was packed
+
+    Returns
+    -------
+    C : Tensor
+        The result tensor.
+    """
+    n = lhs.shape[1] if transa else lhs.shape[0]
+    return _api.extern(
+        (n, m),
+        [lhs, packed_rhs],
+        lambda ins, outs: _intrin.call_packed(
+            "tvm.contrib.cblas.matmul_prepacked", ins[0], ins[1], outs[0], transa, transb
+        ),
+        name="C",
+        **kwargs
+    )
+
+
+def matmul_u8s8s32(lhs, rhs, transa=False, transb=False, **kwargs):
+    """Create an extern op that compute the int32 matrix mult of an uint8 lhs
+    and an int8 rhs. It requires TVM to be built with MKL or DNNL.
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The uint8 left matrix operand
+    rhs : Tensor
+        The int8 right matrix operand
+    transa : bool
+        Whether transpose lhs
+    transb : bool
+        Whether transpose rhs
+
+    Returns
+    -------
+    C : Tensor
+        The int32 result tensor.
+    """
+    n = lhs.shape[1] if transa else lhs.shape[0]
+    m = rhs.shape[0] if transb else rhs.shape[1]
+    return _api.extern(
+        (n, m),
+        [lhs, rhs],
+        lambda ins, outs: _intrin.call_packed(
+            "tvm.contrib.cblas.matmul_u8s8s32", ins[0], ins[1], outs[0], transa, transb
+        ),
+        dtype="int32",
+        name="C",
+        **kwargs
+    )
+
+
 def batch_matmul(lhs, rhs, transa=False, transb=False, iterative=False, **kwargs):
     """Create an extern op that compute batched matrix mult of A and rhs with CBLAS
      This function serves as an example on how to call external libraries.
@@ -96,4 +96,54 @@ def normal(loc, scale, size):
         "tvm.contrib.random.normal", float(loc), float(scale), outs[0]), dtype='float32')
 
 
+def seed(value):
+    """Seed the random engine of the calling thread.
+
+    The values drawn by randint, uniform and normal after seeding only depend
+    on the seed and on the number of values drawn before, not on the number
+    of threads used to generate them.
+
+    Parameters
+    ----------
+    value : int
+        The seed.
+    """
+    _api.get_global_func("tvm.contrib.random.seed")(int(value))
+
+
+def philox(seed_value, index):
+    """Get the raw 32-bit output of the Philox4x32-10 stream of a seed.
+
+    The stream is the one that randint, uniform and normal draw from after
+    seed(seed_value), for a seed that fits in 32 bits. The value at index is
+    not a sample of any of them but the bits they map: at the same flat
+    position of the first tensor drawn after seeding, randint writes
+    ``low + bits % (high - low)`` and uniform writes
+    ``low + (high - low) * (bits >> 8) * 2**-24``, the top 24 bits scaled to
+    [0, 1). normal combines two consecutive values by a Box-Muller transform.
+
+    The call is a pure extern function, so it can be used in compute
+    definitions, e.g. a uniform sample in [0, 1) is
+    ``(philox(seed, i) >> 8).astype("float32") * (1.0 / (1 << 24))``.
+
+    Parameters
+    ----------
+    seed_value : int or Expr
+        The seed of the stream.
+    index : int or Expr
+        The index of the number in the stream.
+
+    Returns
+    -------
+    out : Expr
+        The uint32 output of the stream at index.
+    """
+    def _to_uint64(value):
+        if isinstance(value, int):
+            return _api.const(value, "uint64")
+        return value.astype("uint64")
+    return _intrin.call_pure_extern("uint32", "TVMContribRandomPhilox",
+                                    _to_uint64(seed_value), _to_uint64(index))
+
+
 _init_api("tvm.contrib.random")
@@ -525,6 +525,39 @@ def fmod(x, y):
     return call_pure_intrin(x.dtype, "fmod", x, y)
 
 
+def q_multiply_shift(x, y, q, s):
+    """Multiply two Q-numbers x and y and shift the result by s.
+    The mathematical expression is:
+
+       out = round(x * y * 2^(s - q))
+
+    More about Q-numbers here: https://en.wikipedia.org/wiki/Q_(number_format)
+
+    The rounding rule is to the nearest value, rounding half up
+    (i.e., round(x.1) = x and round (x.5) = x+1)
+
+    The default lowering computes the product in int64. On AArch64, int32
+    vectors with q = 31 use the NEON multiply-high instructions instead.
+
+    Parameters
+    ----------
+    x : Expr
+        First Q-number, usually the int32 accumulator
+    y : Expr
+        Second Q-number, usually the fixed point multiplier
+    q : Expr
+        Number of fractional bits in x and y. Needs to be > 0
+    s : Expr
+        Integer shift. A positive s is a left shift, a negative s
+        is an additional right shift.
+
+    Returns
+    -------
+    z : Expr
+        The result.
+    """
+    return call_pure_intrin('int32', "q_multiply_shift", x, y, q, s)
+
 def if_then_else(cond, t, f):
     """Conditional selection expression.
 
@@ -110,6 +110,9 @@ class Session:
             server_port)
         self._enter = self.module["enter"]
         self._exit = self.module["exit"]
+        self._num_device_reads = self.module["num_device_reads"]
+        self._num_device_writes = self.module["num_device_writes"]
+        self._set_transaction_batching = self.module["set_transaction_batching"]
 
     def _check_system(self):
         """Check if the user's system is supported by MicroTVM.
@@ -123,6 +126,30 @@ class Session:
         if sys.maxsize <= 2**32:
             raise RuntimeError("MicroTVM is currently only supported on 64-bit host platforms")
 
+    def transaction_stats(self):
+        """Number of memory transactions issued to the device so far.
+
+        Writes are batched and reads from host-mirrored sections are served
+        locally, so these count the round trips to the device.
+
+        Returns
+        -------
+        stats : Tuple[int, int]
+            number of device reads and number of device writes
+        """
+        return self._num_device_reads(), self._num_device_writes()
+
+    def set_transaction_batching(self, enabled):
+        """Enable or disable the batching of memory transactions, which is on
+        by default. Disabled, every transaction goes to the device as is.
+
+        Parameters
+        ----------
+        enabled : bool
+            whether to batch transactions
+        """
+        self._set_transaction_batching(enabled)
+
     def __enter__(self):
         self._enter()
         return self
@@ -271,6 +271,8 @@ class VirtualMachine(object):
         self._init = self.mod["init"]
         self._invoke = self.mod["invoke"]
         self._set_input = self.mod["set_input"]
+        self._set_max_kernel_specializations = self.mod["set_max_kernel_specializations"]
+        self._get_num_kernel_specializations = self.mod["get_num_kernel_specializations"]
 
     def init(self, ctx):
         """Initialize the context in the VM.
@@ -283,6 +285,34 @@ class VirtualMachine(object):
         args = [ctx.device_type, ctx.device_id]
         self._init(*args)
 
+    def set_max_kernel_specializations(self, limit):
+        """Specialize kernels with dynamic shapes for the concrete shapes
+        seen at runtime.
+
+        On first sight of new argument shapes, a kernel with dynamic shapes
+        is recompiled with its shapes bound to the concrete values and
+        cached. Once a kernel has `limit` specializations, the generic
+        kernel is used for any further shapes. Specialization requires the
+        executable to be compiled in the same process.
+
+        Parameters
+        ----------
+        limit : int
+            The maximum number of specializations per kernel,
+            0 disables specialization.
+        """
+        self._set_max_kernel_specializations(limit)
+
+    def get_num_kernel_specializations(self):
+        """Get the number of kernels specialized so far over all primitives.
+
+        Returns
+        -------
+        count : int
+            The number of specialized kernels.
+        """
+        return self._get_num_kernel_specializations()
+
     def set_input(self, func_name, *args, **kwargs):
         """Set the input to a function.
 
@@ -109,6 +109,14 @@ def clip_compute(attrs, inputs, output_type, target):
 
 register_schedule("clip", schedule_elemwise)
 
+# fixed_point_multiply
+@register_compute("fixed_point_multiply")
+def fixed_point_multiply_compute(attrs, inputs, output_type, target):
+    assert len(inputs) == 3
+    return [topi.fixed_point_multiply(inputs[0], inputs[1], inputs[2])]
+
+register_schedule("fixed_point_multiply", schedule_broadcast)
+
 @script
 def _cast_shape_function(x):
     out_ndim = len(x)
@@ -783,6 +783,30 @@ def clip(a, a_min, a_max):
     return _make.clip(a, a_min, a_max)
 
 
+def fixed_point_multiply(data, multiplier, shift):
+    """Multiply an int32 tensor by fixed point numbers.
+
+    Computes round(data * multiplier * 2^(-31 - shift)) elementwise, with
+    ties rounded towards +inf. This is the requantization step of integer
+    only inference, lowered to a single fusable stage.
+
+    Parameters
+    ----------
+    data : relay.Expr
+        The int32 input tensor.
+    multiplier : relay.Expr
+        The int32 Q31 multipliers, broadcastable to data.
+    shift : relay.Expr
+        The int32 right shifts, broadcastable to data. A negative
+        shift is a left shift.
+
+    Returns
+    -------
+    result : relay.Expr
+        The int32 result.
+    """
+    return _make.fixed_point_multiply(data, multiplier, shift)
+
 def concatenate(data, axis):
     """Concatenate the input tensors along the given axis.
 
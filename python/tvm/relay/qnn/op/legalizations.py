@@ -53,6 +53,15 @@ def qnn_dense_legalize(attrs, inputs, types):
 # Helper functions.
 ###################
 
+def _qnn_attrs_to_dict(attrs):
+    """Converts the attrs of qnn conv2d/dense into the keyword arguments of the op, folding the
+    per-channel kernel scales back into kernel_scale."""
+    new_attrs = {k : attrs[k] for k in attrs.keys()}
+    kernel_scales = new_attrs.pop('kernel_scales')
+    if kernel_scales:
+        new_attrs['kernel_scale'] = [x.value for x in kernel_scales]
+    return new_attrs
+
 # Helper function for lowering in the abscence of fast Int8 arithmetic units.
 def helper_no_fast_int8_hw_legalization(attrs, inputs, types, relay_op):
     """ Converts QNN operators into a sequence of Relay operators that are friendly to HW that do
@@ -90,6 +99,7 @@ def helper_no_fast_int8_hw_legalization(attrs, inputs, types, relay_op):
     del new_attrs['input_zero_point']
     del new_attrs['input_scale']
     del new_attrs['kernel_scale']
+    del new_attrs['kernel_scales']
     return relay_op(shift_data, shift_kernel, **new_attrs)
 
 # Helper function to change dtypes to uint8 x int8. Intel VNNI instructions prefer this setting.
@@ -162,7 +172,7 @@ def helper_change_dtypes_to_uint8_int8(attrs, inputs, types, relay_op):
         kernel, kernel_zp = _shift(kernel, kernel_zp, 'int8')
 
     # Call qnn.conv2d with modified inputs and zero points.
-    new_attrs = {k : attrs[k] for k in attrs.keys()}
+    new_attrs = _qnn_attrs_to_dict(attrs)
     new_attrs['input_zero_point'] = input_zp
     new_attrs['kernel_zero_point'] = kernel_zp
     return relay_op(data, kernel, **new_attrs)
@@ -218,7 +228,7 @@ def helper_change_dtypes_to_be_same(attrs, inputs, types, relay_op):
     input_zp = attrs['input_zero_point']
     data, input_zp = _shift(data, input_zp, kernel_dtype)
 
-    new_attrs = {k : attrs[k] for k in attrs.keys()}
+    new_attrs = _qnn_attrs_to_dict(attrs)
     new_attrs['input_zero_point'] = input_zp
     return relay_op(data, kernel, **new_attrs)
 
@@ -22,13 +22,23 @@ from tvm.expr import FloatImm, IntImm
 from tvm.relay.expr import Tuple
 from . import _make
 
+
+def _split_scales(scale):
+    """Split a scale into the per-tensor scale and the per-channel scales
+    attributes. A scalar goes to the former, a sequence to the latter."""
+    if isinstance(scale, (int, float)):
+        return float(scale), []
+    return 0.0, [FloatImm("float64", float(x)) for x in scale]
+
+
 def requantize(data,
                input_scale,
                input_zero_point,
                output_scale,
                output_zero_point,
                rounding="UPWARD",
-               out_dtype="int8"):
+               out_dtype="int8",
+               axis=-1):
     r"""Requantized operator.
 
     The requantize operator converts one quantized tensor representation to
@@ -42,8 +52,9 @@ def requantize(data,
     data : tvm.relay.Expr
         The input data to the operator.
 
-    input_scale: float
-        The quantization scale for the input tensor.
+    input_scale: float or list of float
+        The quantization scale for the input tensor, or one scale per channel
+        along axis.
 
     input_zero_point: int
         The zero point of the input tensor.
@@ -61,19 +72,24 @@ def requantize(data,
     out_dtype : str, optional
         Specifies the output data type.
 
+    axis : int, optional
+        The channel axis of the per-channel input scales.
+
     Returns
     -------
     result : tvm.relay.Expr
         The computed result.
     """
-
+    input_scale, input_scales = _split_scales(input_scale)
     return _make.requantize(data,
                             input_scale,
                             input_zero_point,
                             output_scale,
                             output_zero_point,
                             rounding,
-                            out_dtype)
+                            out_dtype,
+                            input_scales,
+                            axis)
 
 
 def quantize(data,
@@ -225,8 +241,9 @@ def conv2d(data,
            The scale for the input tensor. The scale for the input tensor is
            stored purely for convenience here. See more commentary below.
 
-    kernel_scale: float
-           The scale for the weight tensor. The scale for the weight tensor is
+    kernel_scale: float or list of float
+           The scale for the weight tensor, or one scale per output channel.
+           The scale for the weight tensor is
            stored for access to this during relay. This information is not
            needed in the pass pipeline after qnn.conv2d is lowered to the
            sequence of steps as in nn.conv2d. See also input_scale in Requantize.
@@ -270,12 +287,14 @@ def conv2d(data,
         The computed result.
     """
 
+    kernel_scale, kernel_scales = _split_scales(kernel_scale)
     return _make.conv2d(data, kernel,
                         input_zero_point, kernel_zero_point,
                         input_scale, kernel_scale,
                         strides, padding, dilation,
                         groups, channels, kernel_size,
-                        data_layout, kernel_layout, out_layout, out_dtype)
+                        data_layout, kernel_layout, out_layout, out_dtype,
+                        kernel_scales)
 
 
 def add(lhs,
@@ -353,8 +372,9 @@ def dense(data,
         The kernel zero point.
     input_scale: float
         The scale for the input tensor.
-    kernel_scale: float
-        The scale for the weight tensor. The scale for the weight tensor is
+    kernel_scale: float or list of float
+        The scale for the weight tensor, or one scale per unit.
+        The scale for the weight tensor is
         stored for access to this during relay. This information is not
         needed in the pass pipeline after qnn.conv2d is lowered to the
         sequence of steps as in nn.conv2d. See also input_scale in Requantize.
@@ -369,6 +389,7 @@ def dense(data,
         The computed result.
     """
 
+    kernel_scale, kernel_scales = _split_scales(kernel_scale)
     return _make.dense(data,
                        weight,
                        input_zero_point,
@@ -376,7 +397,8 @@ def dense(data,
                        input_scale,
                        kernel_scale,
                        units,
-                       out_dtype)
+                       out_dtype,
+                       kernel_scales)
 
 
 def mul(lhs, rhs, lhs_scale, lhs_zero_point, rhs_scale, rhs_zero_point,
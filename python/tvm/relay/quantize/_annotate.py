@@ -43,6 +43,12 @@ def simulated_quantize_compute(attrs, inputs, out_type, target):
     if attrs.kind == QAnnotateKind.IDENTITY:
         return [topi.identity(data)]
 
+    if attrs.axis >= 0:
+        # broadcast the per-channel scale along the channel axis
+        num_newaxis = len(data.shape) - attrs.axis - 1
+        if num_newaxis > 0:
+            scale = topi.expand_dims(scale, axis=1, num_newaxis=num_newaxis)
+
     # simulate rounding error
     scaled_data = topi.divide(data, scale)
     clipped_data = topi.maximum(topi.minimum(scaled_data, clip_max), clip_min)
@@ -115,7 +121,7 @@ def register_annotate_function(op_name, frewrite=None, level=10):
     return _register(frewrite) if frewrite is not None else _register
 
 
-def attach_simulated_quantize(data, kind, sign=True, rounding="round"):
+def attach_simulated_quantize(data, kind, sign=True, rounding="round", axis=-1):
     """Attach a simulated quantize operation after input data expr.
 
     Parameters
@@ -125,14 +131,18 @@ def attach_simulated_quantize(data, kind, sign=True, rounding="round"):
 
     kind: QAnnotateKind
         the kind of annotation field.
+
+    axis: int
+        the channel axis for a per-channel scale, -1 for a single scale.
     """
     quantize_op = _op.get("relay.op.annotation.simulated_quantize")
     if isinstance(data, _expr.Call) and data.op == quantize_op:
-        if data.attrs.kind == kind and data.attrs.sign == sign and data.attrs.rounding == rounding:
+        if data.attrs.kind == kind and data.attrs.sign == sign and \
+                data.attrs.rounding == rounding and data.attrs.axis == axis:
             return data
 
     qctx = quantize_context()
-    key = tuple([data, kind, sign, rounding])
+    key = tuple([data, kind, sign, rounding, axis])
     if key in qctx.qnode_map:
         return qctx.qnode_map[key]
 
@@ -140,7 +150,7 @@ def attach_simulated_quantize(data, kind, sign=True, rounding="round"):
     clip_min = _expr.var("clip_min")
     clip_max = _expr.var("clip_max")
     qnode = _quantize.simulated_quantize(
-        data, dom_scale, clip_min, clip_max, kind, sign, rounding)
+        data, dom_scale, clip_min, clip_max, kind, sign, rounding, axis)
     qctx.qnode_map[key] = qnode
     return qnode
 
@@ -169,7 +179,10 @@ def conv2d_rewrite(ref_call, new_args, ctx):
         lhs_expr = attach_simulated_quantize(lhs_expr, QAnnotateKind.INPUT)
 
     assert rhs_kind is None
-    rhs_expr = attach_simulated_quantize(rhs_expr, QAnnotateKind.WEIGHT)
+    axis = -1
+    if current_qconfig().per_channel:
+        axis = ref_call.attrs.kernel_layout.index('O')
+    rhs_expr = attach_simulated_quantize(rhs_expr, QAnnotateKind.WEIGHT, axis=axis)
 
     expr = _forward_op(ref_call, [lhs_expr, rhs_expr])
 
@@ -191,7 +204,9 @@ def dense_rewrite(ref_call, new_args, ctx):
         lhs_expr = attach_simulated_quantize(lhs_expr, QAnnotateKind.INPUT)
 
     assert rhs_kind is None
-    rhs_expr = attach_simulated_quantize(rhs_expr, QAnnotateKind.WEIGHT)
+    # the weight of dense is (units, input_dim)
+    axis = 0 if current_qconfig().per_channel else -1
+    rhs_expr = attach_simulated_quantize(rhs_expr, QAnnotateKind.WEIGHT, axis=axis)
 
     expr = _forward_op(ref_call, [lhs_expr, rhs_expr])
 
@@ -17,7 +17,6 @@
 """Find scales for quantization on the dataset."""
 from __future__ import absolute_import
 import logging
-import multiprocessing as mp
 import numpy as np
 import tvm
 
@@ -30,24 +29,32 @@ from .. import analysis as _analysis
 from .. import transform as _transform
 from .. import build_module as _build_module
 from ...contrib import graph_runtime
-from .kl_divergence import _find_scale_by_kl
 
 
-def collect_stats(mod, dataset):
+def collect_stats(mod, dataset, num_bins=8001):
     """Given an annotated graph, create a profile graph to collect profile data from the
     calibration dataset. This pass collects simulated_quantize op input into a tuple.
     Simulated_quantize ops are rewritten to identity mode. The tuple is the output of the profile
     graph.
 
+    The outputs are accumulated into one histogram per layer in C++ after each
+    batch, the values themselves are not kept.
+
     Parameters
     ----------
     mod: Module
         The simulation graph after annotation.
 
+    dataset: Iterable[dict of str to NDArray]
+        The calibration dataset.
+
+    num_bins: int
+        The number of bins of the histograms.
+
     Returns
     -------
-    ret: list of ndarray
-        List of output data of each layer
+    ret: CalibrationStats
+        The histograms of the output data of each layer
     """
 
     logging.info("collecting statistics for calibration...")
@@ -63,29 +70,18 @@ def collect_stats(mod, dataset):
 
     with _transform.build_config(opt_level=3):
         graph, lib, params = _build_module.build(func, target=target)
-    outputs = []
     runtime = graph_runtime.create(graph, lib, ctx)
     runtime.set_input(**params)
 
-    num_outputs = runtime.get_num_outputs()
-    outputs = [[] for i in range(num_outputs)]
-
+    stats = _quantize.CreateCalibrationStats(runtime.get_num_outputs(), num_bins)
     for batch in dataset:
         runtime.set_input(**batch)
         runtime.run()
-        for i in range(num_outputs):
-            output = runtime.get_output(i).asnumpy()
-            outputs[i].append(output)
-    for i in range(num_outputs):
-        outputs[i] = np.concatenate(outputs[i]).reshape(-1)
-    return outputs
+        _quantize.CalibrationStatsUpdate(stats, runtime.module)
+    return stats
 
 
-def _kl_scale(stats):
-    with mp.Pool() as pool:
-        logging.info("finding threshold with kl for calibration...")
-        scales = list(pool.map(_find_scale_by_kl, stats))
-
+def _make_scale_func(scales):
     def func(sq_call):  # pylint: disable=unused-argument
         scale = scales[func.scale_idx]
         func.scale_idx += 1
@@ -95,6 +91,20 @@ def _kl_scale(stats):
     return func
 
 
+def _kl_scale(stats):
+    logging.info("finding threshold with kl for calibration...")
+    scales = _quantize.CalibrationStatsFindScales(stats, "kl_divergence", 0.0).asnumpy()
+    return _make_scale_func([float(x) for x in scales])
+
+
+def _percentile_scale(stats):
+    logging.info("finding threshold with percentile for calibration...")
+    cfg = quantize.current_qconfig()
+    scales = _quantize.CalibrationStatsFindScales(
+        stats, "percentile", cfg.calibrate_percentile).asnumpy()
+    return _make_scale_func([float(x) for x in scales])
+
+
 def _set_params(mod, input_scale_func, weight_scale_func):
     quantize_op = _op.get("relay.op.annotation.simulated_quantize")
     cfg = quantize.current_qconfig()
@@ -120,7 +130,12 @@ def _set_params(mod, input_scale_func, weight_scale_func):
                 return _expr.const(val, 'float32')
 
             valid_range = 2**valid_bit
-            const_params[ndom_scale] = _make_const(scale / valid_range)
+            if attrs.axis >= 0:
+                # per-channel weight scale
+                const_params[ndom_scale] = _expr.const(
+                    np.asarray(scale / valid_range, dtype='float32'))
+            else:
+                const_params[ndom_scale] = _make_const(scale / valid_range)
             const_params[nclip_min] = _make_const(- (valid_range - 1))
             const_params[nclip_max] = _make_const((valid_range - 1))
 
@@ -131,8 +146,22 @@ def _set_params(mod, input_scale_func, weight_scale_func):
 
 
 # weight scale functions
+def _channel_abs_max(sq_call):
+    """maximum absolute value of each channel along the per-channel axis"""
+    var = sq_call.args[0]
+    assert isinstance(var, _expr.Constant)
+    data = np.abs(var.data.asnumpy())
+    axis = sq_call.attrs.axis
+    reduce_axis = tuple(i for i in range(data.ndim) if i != axis)
+    val = np.amax(data, axis=reduce_axis)
+    # channels of all zeros get a unit scale
+    return np.where(val > 0, val, 1.0)
+
+
 def _power2_scale(sq_call):  # pylint: disable=unused-argument
     """calculate weight scale with nearest mode-2 scale"""
+    if sq_call.attrs.axis >= 0:
+        return 2 ** np.ceil(np.log2(_channel_abs_max(sq_call)))
     var = sq_call.args[0]
     assert isinstance(var, _expr.Constant)
     val = np.amax(np.abs(var.data.asnumpy()))
@@ -141,6 +170,8 @@ def _power2_scale(sq_call):  # pylint: disable=unused-argument
 
 def _max_scale(sq_call):
     """calculate weight scale with maximum absolute value"""
+    if sq_call.attrs.axis >= 0:
+        return _channel_abs_max(sq_call)
     var = sq_call.args[0]
     assert isinstance(var, _expr.Constant)
     val = np.amax(np.abs(var.data.asnumpy()))
@@ -175,6 +206,9 @@ def calibrate(dataset=None):
         if cfg.calibrate_mode == 'kl_divergence':
             stats = collect_stats(mod, dataset)
             input_scale_func = _kl_scale(stats)
+        elif cfg.calibrate_mode == 'percentile':
+            stats = collect_stats(mod, dataset)
+            input_scale_func = _percentile_scale(stats)
         elif cfg.calibrate_mode == 'global_scale':
             input_scale_func = _global_scale
         else:
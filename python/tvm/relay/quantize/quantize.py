@@ -76,7 +76,9 @@ class QConfig(NodeBase):
         "dtype_activation": "int32",
         "calibrate_mode": "global_scale",
         "global_scale": 8.0,
+        "calibrate_percentile": 0.9999,
         "weight_scale": "power2",
+        "per_channel": False,
         "skip_conv_layers": [0],
         "do_simulation": False,
         "round_for_shift": True,
@@ -142,19 +144,28 @@ def qconfig(**kwargs):
         Number of bit for every kind of annotate field.
 
     calibrate_mode: str
-        The calibration mode. 'global_scale' or 'kl_divergence'.
+        The calibration mode. 'global_scale', 'kl_divergence' or 'percentile'.
         global_scale: use global scale
         kl_divergence: find scales by kl divergence on the dataset.
+        percentile: find scales by a percentile of the absolute values on the dataset.
 
     global_scale: float
         The global scale for calibration.
 
+    calibrate_percentile: float
+        The percentile of the absolute values covered by the scale, used by the
+        percentile calibration.
+
     weight_scale: str
         The way to calculate scales for weights (annotated with QAnnotateKind.WEIGHT).
         power2: Find the maximum of the absolute value of the tensor, and then round up to power
         of two.
         max: Find the maximum of the absolute value of the tensor
 
+    per_channel: boolean
+        Whether to quantize the weights of conv2d and dense with one scale per
+        output channel instead of one scale for the whole tensor.
+
     skip_conv_layers: list
         Specifying which layers to be skipped. Provide a list of indices
         that indicate which conv2d layers to leave untouched. Start from 0.
@@ -73,12 +73,20 @@ class PassContext(RelayNode):
 
     disabled_pass : Optional[Union[List[str], Set[str], Tuple[str]]]
         The list of passes that are disabled.
+
+    fusion_cost_model : Optional[Callable[[Map[str, IntImm]], bool]]
+        The cost model FuseOps consults for every fusion candidate. It
+        receives the features of a candidate (bytes_saved, flops, num_inputs,
+        num_nodes, src_pattern, sink_pattern and relaxed) and returns whether
+        to fuse. Relaxed candidates are beyond what greedy fusion would fuse.
+        Greedy fusion is used if not given.
     """
     def __init__(self,
                  opt_level=2,
                  fallback_device=_nd.cpu(),
                  required_pass=None,
-                 disabled_pass=None):
+                 disabled_pass=None,
+                 fusion_cost_model=None):
         if isinstance(fallback_device, str):
             fallback_device = _nd.context(fallback_device).device_type
         elif isinstance(fallback_device, TVMContext):
@@ -99,7 +107,7 @@ class PassContext(RelayNode):
 
         self.__init_handle_by_constructor__(_transform.PassContext, opt_level,
                                             fallback_device, required,
-                                            disabled)
+                                            disabled, fusion_cost_model)
 
     def __enter__(self):
         _transform.EnterPassContext(self)
@@ -117,7 +125,8 @@ class PassContext(RelayNode):
 def build_config(opt_level=2,
                  fallback_device=_nd.cpu(),
                  required_pass=None,
-                 disabled_pass=None):
+                 disabled_pass=None,
+                 fusion_cost_model=None):
     """Configure the build behavior by setting config variables.
 
     Parameters
@@ -151,13 +160,18 @@ def build_config(opt_level=2,
     disabled_pass: set of str, optional
         Optimization passes to be disabled during optimization.
 
+    fusion_cost_model: Callable[[Map[str, IntImm]], bool], optional
+        The cost model FuseOps consults for every fusion candidate, e.g.
+        relay.transform.DefaultFusionCostModel(). Greedy fusion is used
+        if not given.
+
     Returns
     -------
     pass_context: PassContext
         The pass context for optimizations.
     """
     return PassContext(opt_level, fallback_device, required_pass,
-                       disabled_pass)
+                       disabled_pass, fusion_cost_model)
 
 
 @register_relay_node
@@ -400,6 +414,20 @@ def FuseOps(fuse_opt_level=-1):
     return _transform.FuseOps(fuse_opt_level)
 
 
+def DefaultFusionCostModel():
+    """The builtin target-aware fusion cost model.
+
+    It limits the input streams of a fused group by the vector register
+    count and fuses large memory-bound chains on CPU.
+
+    Returns
+    -------
+    cost_model : Callable[[Map[str, IntImm]], bool]
+        The cost model, to be passed to the fusion_cost_model of a PassContext.
+    """
+    return _transform.DefaultFusionCostModel
+
+
 def CombineParallelConv2D(min_num_branches=3):
     """Combine multiple conv2d operators into one.
 
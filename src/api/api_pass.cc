@@ -27,6 +27,7 @@
 #include <tvm/ir_pass.h>
 #include <tvm/ir_functor_ext.h>
 #include <tvm/api_registry.h>
+#include <tvm/build_module.h>
 
 namespace tvm {
 namespace ir {
@@ -123,6 +124,12 @@ TVM_REGISTER_API("ir_pass.PostOrderVisit")
       });
   });
 
+TVM_REGISTER_API("ir_pass.VectorizeLoop")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+    Target target = args.size() > 1 ? args[1].operator Target() : Target();
+    *ret = VectorizeLoop(args[0].operator Stmt(), target);
+  });
+
 TVM_REGISTER_API("ir_pass.LowerStorageAccess")
 .set_body([](TVMArgs args, TVMRetValue *ret) {
   LoweredFunc f = args[0];
@@ -142,7 +149,6 @@ REGISTER_PASS(VerifySSA);
 REGISTER_PASS(RewriteUnsafeSelect);
 REGISTER_PASS(Inline);
 REGISTER_PASS(IRTransform);
-REGISTER_PASS(VectorizeLoop);
 REGISTER_PASS(SkipVectorize);
 REGISTER_PASS(UnrollLoop);
 REGISTER_PASS(InjectCopyIntrin);
@@ -156,6 +162,7 @@ REGISTER_PASS(LowerStorageAccessInfo);
 REGISTER_PASS(LowerDeviceStorageAccessInfo)
 REGISTER_PASS(InjectVirtualThread);
 REGISTER_PASS(InjectPrefetch);
+REGISTER_PASS(InjectStreamHint);
 REGISTER_PASS(InjectDoubleBuffer);
 REGISTER_PASS(LoopPartition);
 REGISTER_PASS(RemoveNoOp);
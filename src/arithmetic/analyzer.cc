@@ -21,8 +21,15 @@
  * \file tvm/arithmetic/analyzer.cc
  */
 #include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include <tvm/ir_functor_ext.h>
+#include <tvm/attrs.h>
 #include <tvm/arithmetic.h>
 #include <tvm/expr_operator.h>
+#include <cstdlib>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace tvm {
 namespace arith {
@@ -64,8 +71,10 @@ void ConstraintContext::EnterWithScope() {
   auto f0 = analyzer_->const_int_bound.EnterConstraint(constraint_);
   auto f1 = analyzer_->modular_set.EnterConstraint(constraint_);
   auto f2 = analyzer_->rewrite_simplify.EnterConstraint(constraint_);
+  auto f3 = analyzer_->memo.EnterConstraint();
   // recovery function.
-  exit_ = [f0, f1, f2]() {
+  exit_ = [f0, f1, f2, f3]() {
+    f3();
     if (f2 != nullptr) f2();
     if (f1 != nullptr) f1();
     if (f0 != nullptr) f0();
@@ -77,6 +86,98 @@ void ConstraintContext::ExitWithScope() {
   exit_();
 }
 
+// Upper bound of memo entries, the table is dropped when it is reached.
+static constexpr size_t kMaxSimplifyMemoSize = 1 << 16;
+
+size_t SimplifyMemo::KeyHash::operator()(const Key& key) const {
+  size_t h = AttrsHash()(key.expr);
+  h = dmlc::HashCombine(h, key.version);
+  return dmlc::HashCombine(h, key.kind);
+}
+
+bool SimplifyMemo::KeyEqual::operator()(const Key& lhs, const Key& rhs) const {
+  if (lhs.kind != rhs.kind || lhs.version != rhs.version) return false;
+  return lhs.expr.same_as(rhs.expr) || ir::Equal(lhs.expr, rhs.expr);
+}
+
+SimplifyMemo::SimplifyMemo() {
+  static const bool enabled = [] {
+    const char* val = getenv("TVM_ARITH_SIMPLIFY_MEMO");
+    return val == nullptr || atoi(val) != 0;
+  }();
+  enabled_ = enabled;
+}
+
+uint64_t SimplifyMemo::VarVersion(const Var& var) const {
+  auto it = var_version_.find(var);
+  return it == var_version_.end() ? 0 : it->second;
+}
+
+bool SimplifyMemo::Lookup(Kind kind, const Expr& expr, Expr* result) const {
+  if (!enabled_) return false;
+  auto it = table_.find(Key{expr, version_, kind});
+  if (it == table_.end()) return false;
+  for (const auto& dep : it->second.deps) {
+    if (VarVersion(dep.first) != dep.second) return false;
+  }
+  *result = it->second.result;
+  return true;
+}
+
+void SimplifyMemo::Insert(Kind kind, const State& state, const Expr& expr, const Expr& result) {
+  if (!enabled_) return;
+  if (state.version != version_ || state.num_updates != num_updates_) return;
+  if (table_.size() >= kMaxSimplifyMemoSize) {
+    table_.clear();
+  }
+  Entry entry;
+  entry.result = result;
+  std::unordered_set<const Variable*> visited;
+  ir::PostOrderVisit(expr, [&](const ObjectRef& node) {
+    if (const Variable* op = node.as<Variable>()) {
+      if (visited.insert(op).second) {
+        Var var = GetRef<Var>(op);
+        entry.deps.emplace_back(var, VarVersion(var));
+      }
+    }
+  });
+  table_[Key{expr, version_, kind}] = std::move(entry);
+}
+
+void SimplifyMemo::Invalidate(const Var& var, const Expr& info) {
+  ++num_updates_;
+  // Bump the version of var and of every variable whose information refers to it.
+  std::vector<Var> stack{var};
+  std::unordered_set<const Object*> visited{var.get()};
+  while (!stack.empty()) {
+    Var v = stack.back();
+    stack.pop_back();
+    ++var_version_[v];
+    auto it = var_users_.find(v);
+    if (it == var_users_.end()) continue;
+    for (const Var& user : it->second) {
+      if (visited.insert(user.get()).second) stack.push_back(user);
+    }
+  }
+  if (info.defined()) {
+    ir::PostOrderVisit(info, [&](const ObjectRef& node) {
+      if (const Variable* op = node.as<Variable>()) {
+        if (op != var.get()) var_users_[GetRef<Var>(op)].push_back(var);
+      }
+    });
+  }
+}
+
+std::function<void()> SimplifyMemo::EnterConstraint() {
+  uint64_t outer_version = version_;
+  version_ = ++last_version_;
+  // Variable updates inside the scope outlive it, but they are tracked
+  // per variable, so the outer entries can be reused after the scope.
+  return [this, outer_version]() {
+    version_ = outer_version;
+  };
+}
+
 bool Analyzer::CanProveGreaterEqual(const Expr& expr, int64_t lower_bound) {
   if (const auto* ptr = expr.as<ir::IntImm>()) {
     return ptr->value >= lower_bound;
@@ -1116,17 +1116,23 @@ VisitExpr_(const Reduce* op) {
 }
 
 Expr CanonicalSimplifier::operator()(const Expr& expr) {
-  return impl_->CanonicalSimplify(expr);
+  Expr res;
+  if (parent_->memo.Lookup(SimplifyMemo::kCanonical, expr, &res)) return res;
+  SimplifyMemo::State state = parent_->memo.state();
+  res = impl_->CanonicalSimplify(expr);
+  parent_->memo.Insert(SimplifyMemo::kCanonical, state, expr, res);
+  return res;
 }
 
 void CanonicalSimplifier::Update(const Var& var,
                                  const Expr& info,
                                  bool override) {
+  parent_->memo.Invalidate(var, info);
   impl_->Update(var, info, override);
 }
 
 CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent)
-    : impl_(new Impl(parent)) {
+    : parent_(parent), impl_(new Impl(parent)) {
 }
 
 CanonicalSimplifier::~CanonicalSimplifier() {
@@ -528,10 +528,12 @@ ConstIntBound ConstIntBoundAnalyzer::operator()(const Expr& expr) {
 void ConstIntBoundAnalyzer::Update(const Var& var,
                                    const ConstIntBound& info,
                                    bool override) {
+  parent_->memo.Invalidate(var);
   impl_->Update(var, info, override);
 }
 
 void ConstIntBoundAnalyzer::Bind(const Var& var, const Range& range) {
+  parent_->memo.Invalidate(var);
   impl_->Bind(var, range);
 }
 
@@ -540,7 +542,7 @@ std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const Expr& constra
 }
 
 ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent)
-    : impl_(new Impl()) {
+    : parent_(parent), impl_(new Impl()) {
 }
 
 ConstIntBoundAnalyzer::~ConstIntBoundAnalyzer() {
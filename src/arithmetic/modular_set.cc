@@ -406,6 +406,7 @@ ModularSet ModularSetAnalyzer::operator()(const Expr& expr) {
 void ModularSetAnalyzer::Update(const Var& var,
                                 const ModularSet& info,
                                 bool override) {
+  parent_->memo.Invalidate(var);
   impl_->Update(var, info, override);
 }
 
@@ -414,7 +415,7 @@ std::function<void()> ModularSetAnalyzer::EnterConstraint(const Expr& constraint
 }
 
 ModularSetAnalyzer::ModularSetAnalyzer(Analyzer* parent)
-    : impl_(new Impl(parent)) {
+    : parent_(parent), impl_(new Impl(parent)) {
 }
 
 ModularSetAnalyzer::~ModularSetAnalyzer() {
@@ -56,6 +56,15 @@
  *
  * \endcode
  *
+ * Before binding any PVar, Match first runs MatchShape_, a side-effect free
+ * check generated from the same templates that only inspects node types,
+ * call names and integer constants. Most candidate rules in a rewrite
+ * sequence fail on the node type of some sub-expression, so they are
+ * rejected by a few type-index comparisons without touching reference
+ * counts or running deep equality checks on repeated PVars. A successful
+ * match walks the pattern twice, apps/benchmark/simplify_bench.py measures
+ * the simplifier with and without the pre-check.
+ *
  * \note The pattern matcher is not threadsafe,
  *       do not use the same PVar in multiple threads.
  *
@@ -66,6 +75,7 @@
 #define TVM_ARITHMETIC_PATTERN_MATCH_H_
 
 #include <tvm/ir_pass.h>
+#include <cstdlib>
 #include <tuple>
 #include "const_fold.h"
 
@@ -109,6 +119,9 @@ class Pattern {
    */
   template<typename NodeType>
   bool Match(const NodeType& value) const {
+    // Cheap structural filter: rejects mismatched node types
+    // before any PVar is bound.
+    if (PrecheckEnabled() && !derived().MatchShape_(value)) return false;
     derived().InitMatch_();
     return derived().Match_(value);
   }
@@ -116,6 +129,17 @@ class Pattern {
   const Derived& derived() const {
     return *static_cast<const Derived*>(this);
   }
+  /*!
+   * \return Whether Match runs the structural pre-check.
+   *  It can be disabled with TVM_ARITH_PATTERN_PRECHECK=0 to measure its effect.
+   */
+  static bool PrecheckEnabled() {
+    static const bool enabled = [] {
+      const char* val = getenv("TVM_ARITH_PATTERN_PRECHECK");
+      return val == nullptr || atoi(val) != 0;
+    }();
+    return enabled;
+  }
 };
 
 /*!
@@ -196,6 +220,17 @@ class PVar : public Pattern<PVar<T> > {
     }
   }
 
+  bool MatchShape_(const T& value) const {
+    return true;
+  }
+
+  template<typename NodeRefType,
+           typename = typename std::enable_if<
+             std::is_base_of<NodeRefType, T>::value>::type>
+  bool MatchShape_(const NodeRefType& value) const {
+    return value.template as<typename T::ContainerType>() != nullptr;
+  }
+
   T Eval() const {
     CHECK(filled_);
     return value_;
@@ -225,6 +260,10 @@ class PConst : public Pattern<PConst<T> > {
     return PEqualChecker<T>()(value_, value);
   }
 
+  bool MatchShape_(const T& value) const {
+    return true;
+  }
+
   T Eval() const {
     return value_;
   }
@@ -260,6 +299,14 @@ class PBinaryExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const NodeType* ptr = node.as<NodeType>()) {
+      return a_.MatchShape_(ptr->a) && b_.MatchShape_(ptr->b);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     Expr lhs = a_.Eval();
     Expr rhs = b_.Eval();
@@ -290,6 +337,10 @@ class PConstWithTypeLike :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    return Match_(node);
+  }
+
   Expr Eval() const {
     return make_const(ref_.Eval().dtype(), value_);
   }
@@ -373,6 +424,14 @@ class PNotExpr : public Pattern<PNotExpr<TA> > {
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Not* ptr = node.as<ir::Not>()) {
+      return value_.MatchShape_(ptr->a);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     return ir::Not::make(value_.Eval());
   }
@@ -421,6 +480,16 @@ class PSelectExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Select* ptr = node.as<ir::Select>()) {
+      return condition_.MatchShape_(ptr->condition) &&
+          true_value_.MatchShape_(ptr->true_value) &&
+          false_value_.MatchShape_(ptr->false_value);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     return ir::Select::make(
         condition_.Eval(), true_value_.Eval(), false_value_.Eval());
@@ -482,6 +551,15 @@ class PCastExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Cast* ptr = node.as<ir::Cast>()) {
+      return dtype_.MatchShape_(ptr->dtype) &&
+          value_.MatchShape_(ptr->value);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     return ir::Cast::make(dtype_.Eval(), value_.Eval());
   }
@@ -541,6 +619,16 @@ class PRampExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Ramp* ptr = node.as<ir::Ramp>()) {
+      return base_.MatchShape_(ptr->base) &&
+          stride_.MatchShape_(ptr->stride) &&
+          lanes_.MatchShape_(ptr->lanes);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     return ir::Ramp::make(base_.Eval(), stride_.Eval(), lanes_.Eval());
   }
@@ -602,6 +690,15 @@ class PBroadcastExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Broadcast* ptr = node.as<ir::Broadcast>()) {
+      return value_.MatchShape_(ptr->value) &&
+          lanes_.MatchShape_(ptr->lanes);
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     return ir::Broadcast::make(value_.Eval(), lanes_.Eval());
   }
@@ -674,6 +771,19 @@ struct PCallExprMatchFunctor {
   }
 };
 
+struct PCallExprMatchShapeFunctor {
+  const ir::Call* call_;
+  bool matched_{true};
+
+  explicit PCallExprMatchShapeFunctor(const ir::Call* call)
+      : call_(call) {}
+
+  template<typename T>
+  void operator()(size_t i, const T& pattern) {
+    matched_ = matched_ && pattern.MatchShape_(call_->args[i]);
+  }
+};
+
 struct PCallExprEvalArgsFunctor {
   Array<Expr> args_;
 
@@ -716,6 +826,18 @@ class PCallExpr :
     }
   }
 
+  bool MatchShape_(const ObjectRef& node) const {
+    if (const ir::Call* ptr = node.as<ir::Call>()) {
+      if (ptr->args.size() != sizeof...(TArgs)) return false;
+      if (ptr->name != Op::kName) return false;
+      detail::PCallExprMatchShapeFunctor fmatch(ptr);
+      detail::tuple_for_each(fmatch, args_);
+      return fmatch.matched_;
+    } else {
+      return false;
+    }
+  }
+
   Expr Eval() const {
     detail::PCallExprEvalArgsFunctor feval_args;
     detail::tuple_for_each(feval_args, args_);
@@ -1763,20 +1763,25 @@ VisitExpr_(const Let* op) {
 }
 
 Expr RewriteSimplifier::operator()(const Expr& expr) {
+  Expr res;
+  if (parent_->memo.Lookup(SimplifyMemo::kRewrite, expr, &res)) return res;
+  SimplifyMemo::State state = parent_->memo.state();
   // Run simplification in post order
-  Expr res = expr;
+  res = expr;
   int max_iter = 2;
   for (int i = 0; i < max_iter; ++i) {
     Expr new_expr = impl_->operator()(res);
-    if (new_expr.same_as(res)) return res;
+    if (new_expr.same_as(res)) break;
     res = new_expr;
   }
+  parent_->memo.Insert(SimplifyMemo::kRewrite, state, expr, res);
   return res;
 }
 
 void RewriteSimplifier::Update(const Var& var,
                                const Expr& info,
                                bool override) {
+  parent_->memo.Invalidate(var, info);
   impl_->Update(var, info, override);
 }
 
@@ -1785,7 +1790,7 @@ std::function<void()> RewriteSimplifier::EnterConstraint(const Expr& constraint)
 }
 
 RewriteSimplifier::RewriteSimplifier(Analyzer* parent)
-    : impl_(new Impl(parent)) {
+    : parent_(parent), impl_(new Impl(parent)) {
 }
 
 RewriteSimplifier::~RewriteSimplifier() {
@@ -0,0 +1,440 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cost_model.cc
+ * \brief Native cost model and simulated annealing search for AutoTVM.
+ */
+#include "cost_model.h"
+
+#include <tvm/api_registry.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace tvm {
+namespace autotvm {
+
+void RegressionTree::Fit(const float* x, const std::vector<float>& target, size_t n, size_t d,
+                         int max_depth, int min_samples_leaf) {
+  nodes_.clear();
+  std::vector<size_t> index(n);
+  for (size_t i = 0; i < n; ++i) index[i] = i;
+  Build(x, target, d, &index, 0, n, 0, max_depth, std::max(min_samples_leaf, 1));
+}
+
+int RegressionTree::Build(const float* x, const std::vector<float>& target, size_t d,
+                          std::vector<size_t>* index, size_t begin, size_t end,
+                          int depth, int max_depth, int min_samples_leaf) {
+  size_t cnt = end - begin;
+  double sum = 0;
+  for (size_t i = begin; i < end; ++i) {
+    sum += target[(*index)[i]];
+  }
+  int id = static_cast<int>(nodes_.size());
+  nodes_.emplace_back();
+  nodes_[id].value = cnt == 0 ? 0.0f : static_cast<float>(sum / cnt);
+  if (depth >= max_depth || cnt < 2 * static_cast<size_t>(min_samples_leaf)) {
+    return id;
+  }
+
+  // exact greedy search of the split with the largest reduction of squared error
+  double base = sum * sum / cnt;
+  double best_gain = 1e-12;
+  int best_feature = -1;
+  float best_threshold = 0;
+  std::vector<size_t> order(index->begin() + begin, index->begin() + end);
+  for (size_t f = 0; f < d; ++f) {
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return x[lhs * d + f] < x[rhs * d + f];
+    });
+    double left_sum = 0;
+    for (size_t k = 0; k + 1 < cnt; ++k) {
+      left_sum += target[order[k]];
+      size_t n_left = k + 1, n_right = cnt - n_left;
+      if (n_right < static_cast<size_t>(min_samples_leaf)) break;
+      if (n_left < static_cast<size_t>(min_samples_leaf)) continue;
+      float v = x[order[k] * d + f], v_next = x[order[k + 1] * d + f];
+      if (v == v_next) continue;
+      double right_sum = sum - left_sum;
+      double gain = left_sum * left_sum / n_left + right_sum * right_sum / n_right - base;
+      if (gain > best_gain) {
+        best_gain = gain;
+        best_feature = static_cast<int>(f);
+        best_threshold = 0.5f * (v + v_next);
+      }
+    }
+  }
+  if (best_feature < 0) return id;
+
+  auto mid = std::partition(index->begin() + begin, index->begin() + end, [&](size_t i) {
+    return x[i * d + best_feature] < best_threshold;
+  });
+  size_t split = mid - index->begin();
+  int left = Build(x, target, d, index, begin, split, depth + 1, max_depth, min_samples_leaf);
+  int right = Build(x, target, d, index, split, end, depth + 1, max_depth, min_samples_leaf);
+  // nodes_ may have been reallocated by the recursion, index it again
+  nodes_[id].feature = best_feature;
+  nodes_[id].threshold = best_threshold;
+  nodes_[id].left = left;
+  nodes_[id].right = right;
+  return id;
+}
+
+float RegressionTree::Predict(const float* row) const {
+  int id = 0;
+  while (nodes_[id].feature >= 0) {
+    const Node& node = nodes_[id];
+    id = row[node.feature] < node.threshold ? node.left : node.right;
+  }
+  return nodes_[id].value;
+}
+
+void GBTModel::Fit(const float* x, const float* y, size_t n, size_t d) {
+  history_x_.clear();
+  history_y_.clear();
+  num_features_ = d;
+  Update(x, y, n, d);
+}
+
+void GBTModel::Update(const float* x, const float* y, size_t n, size_t d) {
+  if (num_features_ == 0) num_features_ = d;
+  CHECK_EQ(d, num_features_)
+      << "feature width changed from " << num_features_ << " to " << d;
+  history_x_.insert(history_x_.end(), x, x + n * d);
+  history_y_.insert(history_y_.end(), y, y + n);
+  if (max_history_ != 0 && history_y_.size() > max_history_) {
+    size_t drop = history_y_.size() - max_history_;
+    history_x_.erase(history_x_.begin(), history_x_.begin() + drop * d);
+    history_y_.erase(history_y_.begin(), history_y_.begin() + drop);
+  }
+  Refit();
+}
+
+void GBTModel::Refit() {
+  trees_.clear();
+  size_t n = history_y_.size(), d = num_features_;
+  const float* x = history_x_.data();
+  double sum = 0;
+  for (float y : history_y_) sum += y;
+  base_score_ = n == 0 ? 0.0f : static_cast<float>(sum / n);
+  std::vector<float> residual(n);
+  for (size_t i = 0; i < n; ++i) {
+    residual[i] = history_y_[i] - base_score_;
+  }
+  for (int t = 0; t < n_trees_; ++t) {
+    RegressionTree tree;
+    tree.Fit(x, residual, n, d, max_depth_, min_samples_leaf_);
+    for (size_t i = 0; i < n; ++i) {
+      residual[i] -= learning_rate_ * tree.Predict(x + i * d);
+    }
+    trees_.push_back(std::move(tree));
+  }
+}
+
+float GBTModel::Predict(const float* row) const {
+  float sum = 0;
+  for (const auto& tree : trees_) {
+    sum += tree.Predict(row);
+  }
+  return base_score_ + learning_rate_ * sum;
+}
+
+void KnobFeatureTable::Lookup(int64_t point, float* out) const {
+  for (size_t k = 0; k < dims.size(); ++k) {
+    int64_t choice = point % dims[k];
+    point /= dims[k];
+    const float* row = tables[k].data() + choice * widths[k];
+    out = std::copy(row, row + widths[k], out);
+  }
+}
+
+// Move one knob of the point to another value, same as the python random_walk.
+static int64_t RandomWalk(int64_t point, const std::vector<int64_t>& dims,
+                          std::mt19937_64* rng) {
+  std::vector<int64_t> knob(dims.size());
+  int64_t p = point;
+  bool movable = false;
+  for (size_t k = 0; k < dims.size(); ++k) {
+    knob[k] = p % dims[k];
+    p /= dims[k];
+    movable |= dims[k] > 1;
+  }
+  if (!movable) return point;
+  std::uniform_int_distribution<size_t> pick_knob(0, dims.size() - 1);
+  while (true) {
+    size_t k = pick_knob(*rng);
+    int64_t v = std::uniform_int_distribution<int64_t>(0, dims[k] - 1)(*rng);
+    if (v != knob[k]) {
+      knob[k] = v;
+      break;
+    }
+  }
+  int64_t ret = 0, stride = 1;
+  for (size_t k = 0; k < dims.size(); ++k) {
+    ret += knob[k] * stride;
+    stride *= dims[k];
+  }
+  return ret;
+}
+
+std::vector<int64_t> SimulatedAnnealing(const GBTModel& model,
+                                        const KnobFeatureTable& space,
+                                        const AnnealingParam& param,
+                                        const std::vector<int64_t>& exclusive,
+                                        std::vector<int64_t>* points,
+                                        std::mt19937_64* rng) {
+  int64_t space_size = 1;
+  for (auto dim : space.dims) space_size *= dim;
+  size_t parallel_size = static_cast<size_t>(
+      std::min<int64_t>(param.parallel_size, space_size));
+
+  if (points->size() != parallel_size) {
+    std::uniform_int_distribution<int64_t> sample(0, space_size - 1);
+    std::unordered_set<int64_t> visited;
+    points->clear();
+    while (points->size() < parallel_size) {
+      int64_t p = sample(*rng);
+      if (visited.insert(p).second) points->push_back(p);
+    }
+  }
+
+  std::vector<float> buf(space.num_features);
+  auto predict = [&](int64_t p) {
+    space.Lookup(p, buf.data());
+    return model.Predict(buf.data());
+  };
+
+  // the best num points found so far, kept as an ordered set of (score, point)
+  std::set<std::pair<float, int64_t> > heap;
+  std::unordered_set<int64_t> in_heap(exclusive.begin(), exclusive.end());
+  size_t num = static_cast<size_t>(param.num);
+  auto push = [&](float score, int64_t p) {
+    if (num == 0 || in_heap.count(p)) return false;
+    if (heap.size() >= num) {
+      if (score <= heap.begin()->first) return false;
+      in_heap.erase(heap.begin()->second);
+      heap.erase(heap.begin());
+    }
+    heap.emplace(score, p);
+    in_heap.insert(p);
+    return true;
+  };
+
+  std::vector<float> scores(points->size());
+  for (size_t i = 0; i < points->size(); ++i) {
+    scores[i] = predict((*points)[i]);
+    push(scores[i], (*points)[i]);
+  }
+
+  double t = param.temp_begin;
+  double cool = (param.temp_begin - param.temp_end) / (param.n_iter + 1);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  int k = 0, k_last_modify = 0;
+  while (k < param.n_iter && k < k_last_modify + param.early_stop) {
+    for (size_t i = 0; i < points->size(); ++i) {
+      int64_t new_point = RandomWalk((*points)[i], space.dims, rng);
+      float new_score = predict(new_point);
+      double ac_prob = std::exp(std::min((new_score - scores[i]) / (t + 1e-5), 1.0));
+      if (uniform(*rng) < ac_prob) {
+        (*points)[i] = new_point;
+        scores[i] = new_score;
+      }
+      if (push(new_score, new_point)) {
+        k_last_modify = k;
+      }
+    }
+    ++k;
+    t -= cool;
+  }
+
+  std::vector<int64_t> ret;
+  for (auto it = heap.rbegin(); it != heap.rend(); ++it) {
+    ret.push_back(it->second);
+  }
+  return ret;
+}
+
+/*!
+ * \brief Module exposing a GBTModel and its search to the frontend.
+ *  Features and targets are exchanged as float32 NDArrays and
+ *  config indices as int64 NDArrays.
+ */
+class NativeCostModel : public runtime::ModuleNode {
+ public:
+  NativeCostModel(int n_trees, int max_depth, double learning_rate,
+                  int min_samples_leaf, int64_t max_history, int64_t seed)
+      : model_(n_trees, max_depth, static_cast<float>(learning_rate), min_samples_leaf,
+               static_cast<size_t>(max_history)),
+        rng_(seed) {}
+
+  const char* type_key() const final {
+    return "AutoTVMNativeCostModel";
+  }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "set_space") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        SetSpace(args[0], args[1], args[2]);
+      });
+    } else if (name == "fit" || name == "update") {
+      bool refit = name == "fit";
+      return PackedFunc([sptr_to_self, this, refit](TVMArgs args, TVMRetValue* rv) {
+        DLTensor* x = args[0];
+        DLTensor* y = args[1];
+        CHECK_EQ(x->ndim, 2);
+        CHECK_EQ(y->ndim, 1);
+        CHECK_EQ(x->shape[0], y->shape[0]);
+        const float* px = FloatData(x);
+        const float* py = FloatData(y);
+        size_t n = static_cast<size_t>(x->shape[0]);
+        size_t d = static_cast<size_t>(x->shape[1]);
+        if (refit) {
+          model_.Fit(px, py, n, d);
+        } else {
+          model_.Update(px, py, n, d);
+        }
+      });
+    } else if (name == "predict") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        DLTensor* x = args[0];
+        CHECK_EQ(x->ndim, 2);
+        int64_t n = x->shape[0], d = x->shape[1];
+        CHECK_NE(model_.num_features(), 0U) << "fit must be called before predict";
+        CHECK_EQ(static_cast<size_t>(d), model_.num_features())
+            << "the features have " << d << " columns, the model was fit on "
+            << model_.num_features();
+        const float* px = FloatData(x);
+        runtime::NDArray ret = runtime::NDArray::Empty({n}, DataType::Float(32), {kDLCPU, 0});
+        float* pret = static_cast<float*>(ret->data);
+        for (int64_t i = 0; i < n; ++i) {
+          pret[i] = model_.Predict(px + i * d);
+        }
+        *rv = ret;
+      });
+    } else if (name == "predict_points") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        CheckSpace("predict_points");
+        std::vector<int64_t> points = ToVector(args[0]);
+        int64_t n = static_cast<int64_t>(points.size());
+        runtime::NDArray ret = runtime::NDArray::Empty({n}, DataType::Float(32), {kDLCPU, 0});
+        float* pret = static_cast<float*>(ret->data);
+        std::vector<float> buf(space_.num_features);
+        for (int64_t i = 0; i < n; ++i) {
+          space_.Lookup(points[i], buf.data());
+          pret[i] = model_.Predict(buf.data());
+        }
+        *rv = ret;
+      });
+    } else if (name == "find_maximums") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        CheckSpace("find_maximums");
+        AnnealingParam param;
+        param.num = args[0];
+        param.n_iter = args[1];
+        param.temp_begin = args[2];
+        param.temp_end = args[3];
+        param.parallel_size = args[4];
+        param.early_stop = args[5];
+        std::vector<int64_t> exclusive = ToVector(args[6]);
+        bool persistent = args[7];
+        if (!persistent) points_.clear();
+        std::vector<int64_t> best = SimulatedAnnealing(
+            model_, space_, param, exclusive, &points_, &rng_);
+        runtime::NDArray ret = runtime::NDArray::Empty(
+            {static_cast<int64_t>(best.size())}, DataType::Int(64), {kDLCPU, 0});
+        std::copy(best.begin(), best.end(), static_cast<int64_t*>(ret->data));
+        *rv = ret;
+      });
+    }
+    return PackedFunc();
+  }
+
+ private:
+  static std::vector<int64_t> ToVector(DLTensor* arr) {
+    CHECK_EQ(arr->ndim, 1);
+    CHECK_EQ(arr->dtype.code, kDLInt);
+    CHECK_EQ(arr->dtype.bits, 64);
+    const int64_t* data = reinterpret_cast<const int64_t*>(
+        static_cast<const char*>(arr->data) + arr->byte_offset);
+    return std::vector<int64_t>(data, data + arr->shape[0]);
+  }
+
+  static const float* FloatData(DLTensor* arr) {
+    CHECK(arr->dtype.code == kDLFloat && arr->dtype.bits == 32 && arr->dtype.lanes == 1)
+        << "expect float32 features and targets";
+    CHECK(arr->strides == nullptr) << "expect compact features and targets";
+    return reinterpret_cast<const float*>(static_cast<const char*>(arr->data) + arr->byte_offset);
+  }
+
+  // The knob feature table must be set and match the features of the model.
+  void CheckSpace(const char* name) const {
+    CHECK(!space_.dims.empty()) << "set_space must be called before " << name;
+    CHECK_NE(model_.num_features(), 0U) << "fit must be called before " << name;
+    CHECK_EQ(space_.num_features, model_.num_features())
+        << "the knob feature table has " << space_.num_features
+        << " features, the model was fit on " << model_.num_features();
+  }
+
+  void SetSpace(DLTensor* dims, DLTensor* widths, DLTensor* table) {
+    space_ = KnobFeatureTable();
+    space_.dims = ToVector(dims);
+    std::vector<int64_t> w = ToVector(widths);
+    CHECK_EQ(space_.dims.size(), w.size());
+    CHECK_EQ(table->ndim, 1);
+    const float* ptable = FloatData(table);
+    int64_t offset = 0;
+    for (size_t k = 0; k < w.size(); ++k) {
+      int64_t size = space_.dims[k] * w[k];
+      space_.tables.emplace_back(ptable + offset, ptable + offset + size);
+      space_.widths.push_back(static_cast<size_t>(w[k]));
+      space_.num_features += w[k];
+      offset += size;
+    }
+    CHECK_EQ(offset, table->shape[0]) << "knob feature table size mismatch";
+    points_.clear();
+  }
+
+  GBTModel model_;
+  KnobFeatureTable space_;
+  std::vector<int64_t> points_;
+  std::mt19937_64 rng_;
+};
+
+TVM_REGISTER_API("autotvm.cost_model.CreateGBTModel")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+  int n_trees = args[0];
+  int max_depth = args[1];
+  double learning_rate = args[2];
+  int min_samples_leaf = args[3];
+  int64_t max_history = args[4];
+  int64_t seed = args[5];
+  auto n = make_object<NativeCostModel>(
+      n_trees, max_depth, learning_rate, min_samples_leaf, max_history, seed);
+  *rv = runtime::Module(n);
+});
+
+}  // namespace autotvm
+}  // namespace tvm
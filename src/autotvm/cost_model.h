@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cost_model.h
+ * \brief Native cost model and model optimizer for AutoTVM.
+ *        The model ranks candidate configs from their knob features without
+ *        going through python, so the search can score many more candidates.
+ */
+
+#ifndef TVM_AUTOTVM_COST_MODEL_H_
+#define TVM_AUTOTVM_COST_MODEL_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace tvm {
+namespace autotvm {
+
+/*!
+ * \brief A regression tree stored as a flat array of nodes.
+ *  Node 0 is the root. A node with feature == -1 is a leaf.
+ */
+class RegressionTree {
+ public:
+  /*!
+   * \brief Fit the tree with exact greedy splits on squared error.
+   * \param x Row-major feature matrix with n rows and d columns.
+   * \param target The regression target of each row.
+   * \param n The number of rows.
+   * \param d The number of columns.
+   * \param max_depth The maximum depth of the tree.
+   * \param min_samples_leaf The minimum number of rows in a leaf.
+   */
+  void Fit(const float* x, const std::vector<float>& target, size_t n, size_t d,
+           int max_depth, int min_samples_leaf);
+  /*! \brief Predict a single row of d features. */
+  float Predict(const float* row) const;
+
+ private:
+  struct Node {
+    int feature{-1};
+    float threshold{0};
+    int left{-1};
+    int right{-1};
+    float value{0};
+  };
+
+  int Build(const float* x, const std::vector<float>& target, size_t d,
+            std::vector<size_t>* index, size_t begin, size_t end,
+            int depth, int max_depth, int min_samples_leaf);
+
+  std::vector<Node> nodes_;
+};
+
+/*!
+ * \brief Gradient boosted regression trees with squared loss.
+ *  The model keeps the samples it was trained on. Update adds new samples
+ *  to this history and refits the ensemble on all of it, so the model stays
+ *  at n_trees trees and does not forget earlier samples.
+ */
+class GBTModel {
+ public:
+  GBTModel(int n_trees, int max_depth, float learning_rate, int min_samples_leaf,
+           size_t max_history)
+      : n_trees_(n_trees), max_depth_(max_depth),
+        learning_rate_(learning_rate), min_samples_leaf_(min_samples_leaf),
+        max_history_(max_history) {}
+
+  /*! \brief Drop the history and fit the model to (x, y). */
+  void Fit(const float* x, const float* y, size_t n, size_t d);
+  /*!
+   * \brief Add (x, y) to the history and refit the model on it.
+   *  Only the latest max_history samples are kept, if max_history is not 0.
+   */
+  void Update(const float* x, const float* y, size_t n, size_t d);
+  /*! \brief Predict a single row of features. */
+  float Predict(const float* row) const;
+  /*! \brief The number of features the model was trained on, 0 if untrained. */
+  size_t num_features() const { return num_features_; }
+  /*! \brief The number of samples the model is trained on. */
+  size_t num_samples() const { return history_y_.size(); }
+
+ private:
+  /*! \brief Fit n_trees trees to the history. */
+  void Refit();
+
+  int n_trees_;
+  int max_depth_;
+  float learning_rate_;
+  int min_samples_leaf_;
+  size_t max_history_;
+  float base_score_{0};
+  size_t num_features_{0};
+  std::vector<float> history_x_;
+  std::vector<float> history_y_;
+  std::vector<RegressionTree> trees_;
+};
+
+/*!
+ * \brief Knob feature table of a config space.
+ *  The feature of a config is the concatenation, over knobs, of the
+ *  feature row of the chosen entity of that knob.
+ */
+struct KnobFeatureTable {
+  /*! \brief The number of choices of each knob. */
+  std::vector<int64_t> dims;
+  /*! \brief The feature rows of each knob, row-major with shape (dims[k], widths[k]). */
+  std::vector<std::vector<float> > tables;
+  /*! \brief The feature width of each knob. */
+  std::vector<size_t> widths;
+  /*! \brief The total feature width. */
+  size_t num_features{0};
+
+  /*! \brief Write the feature of a config index into out. */
+  void Lookup(int64_t point, float* out) const;
+};
+
+/*! \brief Parameters of the simulated annealing search. */
+struct AnnealingParam {
+  int num;
+  int n_iter;
+  double temp_begin;
+  double temp_end;
+  int parallel_size;
+  int early_stop;
+};
+
+/*!
+ * \brief Find the configs with the highest predicted score by parallel
+ *        simulated annealing, in the same way as the python
+ *        SimulatedAnnealingOptimizer.
+ * \param model The trained model.
+ * \param space The knob feature table of the config space.
+ * \param param The search parameters.
+ * \param exclusive Config indices that must not be returned.
+ * \param points The walker positions. Initialized randomly if empty,
+ *        and updated in place so the search can be resumed.
+ * \param rng The random engine.
+ * \return Up to param.num config indices, best first.
+ */
+std::vector<int64_t> SimulatedAnnealing(const GBTModel& model,
+                                        const KnobFeatureTable& space,
+                                        const AnnealingParam& param,
+                                        const std::vector<int64_t>& exclusive,
+                                        std::vector<int64_t>* points,
+                                        std::mt19937_64* rng);
+
+}  // namespace autotvm
+}  // namespace tvm
+
+#endif  // TVM_AUTOTVM_COST_MODEL_H_
@@ -96,13 +96,13 @@ void FeatureVisitor::VisitStmt_(const AttrStmt* op) {
 
 // memory access
 void FeatureVisitor::VisitExpr_(const Load* op) {
-  EnterMem_(op->buffer_var, op->index);
+  EnterMem_(op->buffer_var, op->index, op->dtype);
   StmtExprVisitor::VisitExpr_(op);
   ExitMem_();
 }
 
 void FeatureVisitor::VisitStmt_(const Store* op) {
-  EnterMem_(op->buffer_var, op->index);
+  EnterMem_(op->buffer_var, op->index, op->value.dtype());
   StmtExprVisitor::VisitStmt_(op);
   ExitMem_();
 }
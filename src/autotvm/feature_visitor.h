@@ -76,8 +76,9 @@ class FeatureVisitor : public StmtExprVisitor {
    * \brief Enter a memory access node
    * \param buffer_var The buffer to access.
    * \param index Index expression
+   * \param dtype The data type of the accessed element
    */
-  virtual void EnterMem_(tvm::VarExpr buffer_var, tvm::Expr index) = 0;
+  virtual void EnterMem_(tvm::VarExpr buffer_var, tvm::Expr index, DataType dtype) = 0;
   /*! \brief Exit a memory access node */
   virtual void ExitMem_() = 0;
 };
@@ -24,9 +24,16 @@
 
 #include "touch_extractor.h"
 
+#include <tvm/buffer.h>
+#include <tvm/ir_pass.h>
+#include <tvm/schedule_pass.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/ndarray.h>
+
 #include <set>
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <unordered_map>
 
 namespace tvm {
@@ -169,9 +176,10 @@ void TouchExtractor::ExitItervar_() {
   }
 }
 
-void TouchExtractor::EnterMem_(VarExpr buffer_var, Expr index) {
+void TouchExtractor::EnterMem_(VarExpr buffer_var, Expr index, DataType dtype) {
   std::string name = buffer_var.get()->name_hint;
   TouchedBuffer buf = name + "_" + std::to_string(buffer_counter_[name]++);
+  buffer_bytes[buf] = dtype.bytes() * dtype.lanes();
 
   // extract touch pattern from index
   IndexParser parser;
@@ -483,6 +491,178 @@ void GetCurveSampleFeatureFlatten(Stmt stmt, int sample_n, std::vector<float> *r
   }
 }
 
+/*!
+ * \brief Get cache-aware feature for all axes and flatten them into a one-dimensional vector.
+ * \param stmt The statement to be extracted
+ * \param take_log Whether take log for numerical feature
+ * \param cache_sizes The capacity in bytes of each cache level, e.g. (L1, L2, LLC)
+ * \param ret_feature The buffer where the return value is stored
+ *
+ * \note Axes are in the same order as GetItervarFeatureFlatten. For each axis the row is
+ *   (working_set, reuse_distance,
+ *    working_set fits in cache_sizes[i] for each level i,
+ *    reuse_distance fits in cache_sizes[i] for each level i,
+ *    vector_bytes, unit_stride, broadcast, strided, vector_aligned, line_aligned)
+ *
+ *  The working set of an axis is the bytes touched by its whole subtree, and
+ *  the reuse distance is the bytes touched by one of its iterations, which is
+ *  what separates two reuses of an element the axis does not index.
+ *  vector_bytes is only non-zero for vectorized axes. The stride counters
+ *  classify the touched buffers by their stride along the axis.
+ */
+void GetCacheFeatureFlatten(Stmt stmt, bool take_log, const std::vector<int64_t>& cache_sizes,
+                            std::vector<float> *ret_feature) {
+  TouchExtractor touch_analyzer;
+  touch_analyzer.Analyze(stmt);
+
+  std::vector<VarExpr> vars;
+  for (auto kv : touch_analyzer.itervar_map) {
+    vars.push_back(kv.first);
+  }
+  std::sort(vars.begin(), vars.end(), [&](const VarExpr &lhs, const VarExpr &rhs) -> bool {
+    return touch_analyzer.itervar_map[lhs].order < touch_analyzer.itervar_map[rhs].order;
+  });
+
+  auto trans = [take_log](int64_t x) -> float {
+    if (!take_log) return x;
+    if (x < 0)
+      return -std::log(-x+1) / std::log(2);
+    return std::log(x + 1) / std::log(2);
+  };
+
+  for (auto var : vars) {
+    ItervarFeature &fea = touch_analyzer.itervar_map[var];
+    // footprints are per buffer, so several accesses to a buffer
+    // (e.g. 'C_0', 'C_1') count once with their largest footprint
+    std::map<std::string, std::pair<int64_t, int64_t> > footprint;
+    int64_t unit_stride = 0, broadcast = 0, strided = 0;
+    int max_bytes = 0;
+    for (auto kv : fea.touch_feature) {
+      const TouchPattern &v = kv.second;
+      int64_t bytes = touch_analyzer.buffer_bytes[kv.first];
+      max_bytes = std::max(max_bytes, static_cast<int>(bytes));
+      int64_t per_iter = v.stride != 0 && fea.length > 0 ? v.count / fea.length : v.count;
+      auto &fp = footprint[kv.first.substr(0, kv.first.rfind("_"))];
+      fp.first = std::max(fp.first, v.count * bytes);
+      fp.second = std::max(fp.second, per_iter * bytes);
+      if (v.stride == 0) {
+        broadcast++;
+      } else if (v.stride == 1) {
+        unit_stride++;
+      } else {
+        strided++;
+      }
+    }
+    int64_t working_set = 0, reuse_distance = 0;
+    for (const auto& kv : footprint) {
+      working_set += kv.second.first;
+      reuse_distance += kv.second.second;
+    }
+
+    ret_feature->push_back(trans(working_set));
+    ret_feature->push_back(trans(reuse_distance));
+    for (int64_t size : cache_sizes) {
+      ret_feature->push_back(working_set <= size);
+    }
+    for (int64_t size : cache_sizes) {
+      ret_feature->push_back(reuse_distance <= size);
+    }
+
+    int64_t vector_bytes = fea.ann == kVectorized ? std::max<int64_t>(fea.length, 0) * max_bytes : 0;
+    ret_feature->push_back(trans(vector_bytes));
+    ret_feature->push_back(unit_stride);
+    ret_feature->push_back(broadcast);
+    ret_feature->push_back(strided);
+    ret_feature->push_back(vector_bytes > 0 && vector_bytes % 16 == 0);
+    ret_feature->push_back(vector_bytes > 0 && vector_bytes % 64 == 0);
+  }
+}
+
+
+/*!
+ * \brief Lower a schedule while keeping all axes in the IR.
+ *  This mirrors autotvm.feature.ana_lower in the python frontend.
+ * \param sch The schedule to be lowered
+ * \param args The buffer arguments of the schedule
+ * \return The lowered statement
+ */
+Stmt AnaLower(Schedule sch, const Array<Tensor>& args) {
+  sch = sch.normalize();
+  auto bounds = schedule::InferBound(sch);
+  Stmt stmt = schedule::ScheduleOps(sch, bounds, true);
+  Map<Tensor, Buffer> binds;
+  for (const auto& x : args) {
+    binds.Set(x, decl_buffer(x->shape, x->dtype, x->op->name));
+  }
+  stmt = ir::StorageFlatten(stmt, binds, 64);
+  return ir::CanonicalSimplify(stmt);
+}
+
+/*!
+ * \brief Lower a batch of schedules and extract their flattened features.
+ *  Lowering touches global schedule state and runs serially, only the
+ *  feature extraction of the lowered statements runs in parallel.
+ * \param schs The schedules to be extracted
+ * \param args The buffer arguments of each schedule
+ * \param extract The per-statement feature extractor
+ * \return A float32 matrix of shape (n, max_len) where each row is zero padded.
+ *         A row whose lowering or extraction failed is all zeros, which matches
+ *         how the python cost models treat failed candidates.
+ */
+runtime::NDArray GetFeatureFlattenBatch(
+    const Array<Schedule>& schs,
+    const Array<Array<Tensor> >& args,
+    std::function<void(Stmt, std::vector<float>*)> extract) {
+  CHECK_EQ(schs.size(), args.size());
+  size_t n = schs.size();
+  std::vector<Stmt> stmts(n);
+  std::vector<std::vector<float> > rows(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    try {
+      stmts[i] = AnaLower(schs[i], args[i]);
+    } catch (const dmlc::Error&) {
+      // leave the statement undefined, its row stays all zeros.
+    }
+  }
+
+  struct BatchEnv {
+    const std::vector<Stmt>* stmts;
+    std::function<void(Stmt, std::vector<float>*)>* extract;
+    std::vector<std::vector<float> >* rows;
+  } env{&stmts, &extract, &rows};
+
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    BatchEnv* env = static_cast<BatchEnv*>(cdata);
+    for (size_t i = task_id; i < env->rows->size(); i += penv->num_task) {
+      const Stmt& stmt = (*env->stmts)[i];
+      if (!stmt.defined()) continue;
+      try {
+        (*env->extract)(stmt, &(*env->rows)[i]);
+      } catch (const dmlc::Error&) {
+        (*env->rows)[i].clear();
+      }
+    }
+    return 0;
+  };
+  CHECK_EQ(TVMBackendParallelLaunch(flambda, &env, 0), 0);
+
+  int64_t max_len = 0;
+  for (const auto& row : rows) {
+    max_len = std::max<int64_t>(max_len, row.size());
+  }
+
+  DLContext ctx{kDLCPU, 0};
+  runtime::NDArray feature = runtime::NDArray::Empty(
+      {static_cast<int64_t>(n), max_len}, DataType::Float(32), ctx);
+  float* pfea = static_cast<float*>(feature->data);
+  std::fill(pfea, pfea + n * max_len, 0.0f);
+  for (size_t i = 0; i < n; ++i) {
+    std::copy(rows[i].begin(), rows[i].end(), pfea + i * max_len);
+  }
+  return feature;
+}
+
 
 // register API for front end
 TVM_REGISTER_API("autotvm.feature.GetItervarFeature")
@@ -512,6 +692,26 @@ TVM_REGISTER_API("autotvm.feature.GetItervarFeatureFlatten")
 });
 
 
+TVM_REGISTER_API("autotvm.feature.GetCacheFeatureFlatten")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+  Stmt stmt = args[0];
+  bool take_log = args[1];
+  Array<Integer> sizes = args[2];
+  std::vector<int64_t> cache_sizes;
+  for (auto size : sizes) {
+    cache_sizes.push_back(size->value);
+  }
+  std::vector<float> ret_feature;
+
+  GetCacheFeatureFlatten(stmt, take_log, cache_sizes, &ret_feature);
+
+  TVMByteArray arr;
+  arr.size = sizeof(float) * ret_feature.size();
+  arr.data = reinterpret_cast<char *>(ret_feature.data());
+  *ret = arr;
+});
+
+
 TVM_REGISTER_API("autotvm.feature.GetCurveSampleFeatureFlatten")
 .set_body([](TVMArgs args, TVMRetValue *ret) {
   Stmt stmt = args[0];
@@ -526,6 +726,29 @@ TVM_REGISTER_API("autotvm.feature.GetCurveSampleFeatureFlatten")
   *ret = arr;
 });
 
+TVM_REGISTER_API("autotvm.feature.GetItervarFeatureFlattenBatch")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+  Array<Schedule> schs = args[0];
+  Array<Array<Tensor> > sch_args = args[1];
+  bool take_log = args[2];
+
+  *ret = GetFeatureFlattenBatch(schs, sch_args, [=](Stmt stmt, std::vector<float>* fea) {
+    GetItervarFeatureFlatten(stmt, take_log, fea);
+  });
+});
+
+
+TVM_REGISTER_API("autotvm.feature.GetCurveSampleFeatureFlattenBatch")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+  Array<Schedule> schs = args[0];
+  Array<Array<Tensor> > sch_args = args[1];
+  int sample_n = args[2];
+
+  *ret = GetFeatureFlattenBatch(schs, sch_args, [=](Stmt stmt, std::vector<float>* fea) {
+    GetCurveSampleFeatureFlatten(stmt, sample_n, fea);
+  });
+});
+
 
 }  // namespace autotvm
 }  // namespace tvm
@@ -121,11 +121,13 @@ class TouchExtractor : public FeatureVisitor {
   }
 
   std::unordered_map<VarExpr, ItervarFeature, tvm::ExprHash, tvm::ExprEqual> itervar_map;
+  // element size in bytes of each touched buffer
+  std::unordered_map<TouchedBuffer, int> buffer_bytes;
 
  private:
   bool EnterItervar_(VarExpr var, int64_t length, AnnotationType ann_type);
   void ExitItervar_();
-  void EnterMem_(VarExpr buffer_var, Expr index);
+  void EnterMem_(VarExpr buffer_var, Expr index, DataType dtype);
   void ExitMem_();
 
   int64_t topdown_product_{1};
@@ -390,6 +390,7 @@ void GetBinds(const Array<Tensor>& args,
 * \param loop_partition True if the LoopPartition pass should be included.
 * \param out_arg_list Returns the arguments for the Stmt.
 * \param config The build configuration.
+* \param target The target to lower for.
 * \return The built Stmt.
 */
 Stmt BuildStmt(Schedule sch,
@@ -397,7 +398,8 @@ Stmt BuildStmt(Schedule sch,
                const std::unordered_map<Tensor, Buffer>& binds,
                bool loop_partition,
                Array<ObjectRef> *out_arg_list,
-               const BuildConfig& config) {
+               const BuildConfig& config,
+               const Target& target) {
   sch = sch.normalize();
 
   // Phase 0
@@ -419,7 +421,7 @@ Stmt BuildStmt(Schedule sch,
   if (config->disable_vectorize) {
     stmt = ir::SkipVectorize(stmt);
   } else {
-    stmt = ir::VectorizeLoop(stmt);
+    stmt = ir::VectorizeLoop(stmt, target);
   }
   stmt = ir::InjectVirtualThread(stmt);
   stmt = ir::InjectDoubleBuffer(stmt, config->double_buffer_split_loop);
@@ -444,9 +446,10 @@ Array<LoweredFunc> lower(Schedule sch,
                          const Array<Tensor>& args,
                          const std::string& name,
                          const std::unordered_map<Tensor, Buffer>& binds,
-                         const BuildConfig& config) {
+                         const BuildConfig& config,
+                         const Target& target) {
   Array<ObjectRef> out_arg_list;
-  auto stmt = BuildStmt(sch, args, binds, true, &out_arg_list, config);
+  auto stmt = BuildStmt(sch, args, binds, true, &out_arg_list, config, target);
   return Array<LoweredFunc>({ ir::MakeAPI(stmt, name, out_arg_list, 0, config->restricted_func) });
 }
 
@@ -509,7 +512,7 @@ Array<Array<LoweredFunc> > split_dev_host_funcs(const Array<LoweredFunc>& funcs,
 
   for (size_t i = 0; i < fdevice.size(); ++i) {
     auto func = fdevice[i];
-    func = ir::LowerIntrin(func, target->target_name);
+    func = ir::LowerIntrin(func, target->str());
     fdevice.Set(i, func);
   }
 
@@ -524,13 +527,17 @@ Array<Array<LoweredFunc> > split_dev_host_funcs(const Array<LoweredFunc>& funcs,
     auto func = fhost[i];
     func = ir::BindDeviceType(func, target->device_type);
     func = ir::LowerDeviceStorageAccessInfo(func);
+    if (target_host->target_name == "llvm" &&
+        config->inject_stream_hint) {
+      func = ir::InjectStreamHint(func);
+    }
     func = ir::LowerTVMBuiltin(func);
     fhost.Set(i, func);
   }
 
   for (size_t i = 0; i < fhost.size(); ++i) {
     auto func = fhost[i];
-    func = ir::LowerIntrin(func, target_host->target_name);
+    func = ir::LowerIntrin(func, target_host->str());
     func = ir::LowerDeviceStorageAccessInfo(func);
     func = ir::CombineContextCall(func);
     fhost.Set(i, func);
@@ -679,6 +686,7 @@ TVM_STATIC_IR_FUNCTOR(IRPrinter, vtable)
   p->stream << "disable_select_rewriting=" << op->disable_select_rewriting;
   p->stream << "disable_vectorize=" << op->disable_vectorize;
   p->stream << "disable_assert=" << op->disable_assert;
+  p->stream << "inject_stream_hint=" << op->inject_stream_hint;
   p->stream << ")";
 });
 
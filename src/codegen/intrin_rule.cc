@@ -74,6 +74,30 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.default.sigmoid")
     *rv = one / (one + exp(-call->args[0]));
   });
 
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.default.q_multiply_shift")
+.set_body([](const TVMArgs& args, TVMRetValue* rv){
+    Expr e = args[0];
+    const Call* call = e.as<Call>();
+    CHECK(call != nullptr);
+    CHECK_EQ(call->args.size(), 4U);
+
+    // q_multiply_shift(x, y, q, s) = round(x * y * 2^(s - q)), ties towards
+    // +inf, evaluated in int64 so that the product cannot overflow.
+    Expr x = call->args[0];
+    Expr y = call->args[1];
+    Expr q = call->args[2];
+    Expr s = call->args[3];
+    DataType hp_dtype = DataType::Int(64, call->dtype.lanes());
+    Expr zero = make_const(s.dtype(), 0);
+    Expr left_shift = cast(hp_dtype, max(s, zero));
+    Expr right_shift = cast(hp_dtype, max(zero - s, zero) + q);
+    Expr one = make_const(hp_dtype, 1);
+
+    Expr prod = (cast(hp_dtype, x) << left_shift) * cast(hp_dtype, y);
+    prod = prod + (one << (right_shift - one));
+    *rv = cast(call->dtype, prod >> right_shift);
+  });
+
 }  // namespace intrin
 }  // namespace codegen
 }  // namespace tvm
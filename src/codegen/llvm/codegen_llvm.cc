@@ -106,6 +106,7 @@ void CodeGenLLVM::InitFuncState() {
   alias_var_set_.clear();
   alloc_storage_info_.clear();
   volatile_buf_.clear();
+  nontemporal_buf_.clear();
   analyzer_.reset(new arith::Analyzer());
 }
 
@@ -387,6 +388,14 @@ void CodeGenLLVM::AddAliasInfo(llvm::Instruction* inst,
       md_builder_->createTBAAStructTagNode(meta, meta, 0));
 }
 
+void CodeGenLLVM::AddNonTemporalInfo(llvm::StoreInst* store, const Variable* buffer) {
+  if (!nontemporal_buf_.count(buffer)) return;
+  llvm::MDNode* node = llvm::MDNode::get(
+      *ctx_, {llvm::ConstantAsMetadata::get(ConstInt32(1))});
+  store->setMetadata(llvm::LLVMContext::MD_nontemporal, node);
+  ++num_nontemporal_store_;
+}
+
 void CodeGenLLVM::GetAlignment(DataType t,
                                const Variable* buf_var,
                                const Expr& index,
@@ -950,6 +959,9 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Let* op) {
 }
 
 llvm::Value* CodeGenLLVM::VisitExpr_(const Load* op) {
+  if (!is_one(op->predicate)) {
+    return CreateMaskedLoad(op);
+  }
   DataType t = op->dtype;
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -994,6 +1006,89 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Load* op) {
   return ret;
 }
 
+llvm::Value* CodeGenLLVM::CreateMaskedLoad(const Load* op) {
+  DataType t = op->dtype;
+  CHECK(!volatile_buf_.count(op->buffer_var.get()))
+      << "predicated load from volatile buffer is not supported";
+  llvm::Value* buffer = MakeValue(op->buffer_var);
+  llvm::Value* mask = MakeValue(op->predicate);
+  llvm::Value* zero = llvm::Constant::getNullValue(LLVMType(t));
+  int alignment, native_bits;
+  if (t.lanes() == 1) {
+    // scalar load under a branch.
+    using llvm::BasicBlock;
+    llvm::Value* ptr = CreateBufferPtr(t, buffer, MakeValue(op->index));
+    BasicBlock* pre_block = builder_->GetInsertBlock();
+    BasicBlock* then_block = BasicBlock::Create(*ctx_, "load_then", function_);
+    BasicBlock* end_block = BasicBlock::Create(*ctx_, "load_end", function_);
+    builder_->CreateCondBr(mask, then_block, end_block);
+    builder_->SetInsertPoint(then_block);
+    GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
+    llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, alignment);
+    AddAliasInfo(load, op->buffer_var.get(), op->index, t);
+    builder_->CreateBr(end_block);
+    builder_->SetInsertPoint(end_block);
+    llvm::PHINode* phi = builder_->CreatePHI(LLVMType(t), 2);
+    phi->addIncoming(load, then_block);
+    phi->addIncoming(zero, pre_block);
+    return phi;
+  }
+  if (const Ramp* ramp = op->index.as<Ramp>()) {
+    if (is_one(ramp->stride)) {
+      unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(
+          buffer->getType())->getAddressSpace();
+      GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+      llvm::Value* ptr = CreateBufferPtr(
+          t.element_of(), buffer, MakeValue(ramp->base));
+      ptr = builder_->CreatePointerCast(ptr, LLVMType(t)->getPointerTo(addrspace));
+      return builder_->CreateMaskedLoad(ptr, alignment, mask, zero);
+    }
+  }
+  // gather of the active lanes.
+  llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, MakeValue(op->index));
+  return builder_->CreateMaskedGather(ptrs, t.bits() / 8, mask, zero);
+}
+
+void CodeGenLLVM::CreateMaskedStore(const Store* op) {
+  DataType t = op->value.dtype();
+  CHECK(!volatile_buf_.count(op->buffer_var.get()))
+      << "predicated store to volatile buffer is not supported";
+  llvm::Value* buffer = MakeValue(op->buffer_var);
+  llvm::Value* value = MakeValue(op->value);
+  llvm::Value* mask = MakeValue(op->predicate);
+  int alignment, native_bits;
+  if (t.lanes() == 1) {
+    // scalar store under a branch.
+    using llvm::BasicBlock;
+    llvm::Value* ptr = CreateBufferPtr(t, buffer, MakeValue(op->index));
+    BasicBlock* then_block = BasicBlock::Create(*ctx_, "store_then", function_);
+    BasicBlock* end_block = BasicBlock::Create(*ctx_, "store_end", function_);
+    builder_->CreateCondBr(mask, then_block, end_block);
+    builder_->SetInsertPoint(then_block);
+    GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
+    llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment);
+    AddAliasInfo(store, op->buffer_var.get(), op->index, t);
+    builder_->CreateBr(end_block);
+    builder_->SetInsertPoint(end_block);
+    return;
+  }
+  if (const Ramp* ramp = op->index.as<Ramp>()) {
+    if (is_one(ramp->stride)) {
+      unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(
+          buffer->getType())->getAddressSpace();
+      GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+      llvm::Value* ptr = CreateBufferPtr(
+          t.element_of(), buffer, MakeValue(ramp->base));
+      ptr = builder_->CreatePointerCast(ptr, LLVMType(t)->getPointerTo(addrspace));
+      builder_->CreateMaskedStore(value, ptr, alignment, mask);
+      return;
+    }
+  }
+  // scatter of the active lanes.
+  llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, MakeValue(op->index));
+  builder_->CreateMaskedScatter(value, ptrs, t.bits() / 8, mask);
+}
+
 llvm::Value* CodeGenLLVM::VisitExpr_(const Call* op) {
   if (op->call_type == Call::Intrinsic ||
       op->call_type == Call::PureIntrinsic) {
@@ -1044,7 +1139,10 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Broadcast* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const Store* op) {
-  CHECK(is_one(op->predicate));
+  if (!is_one(op->predicate)) {
+    CreateMaskedStore(op);
+    return;
+  }
   DataType t = op->value.dtype();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -1057,6 +1155,7 @@ void CodeGenLLVM::VisitStmt_(const Store* op) {
     llvm::Value* ptr = CreateBufferPtr(t, buffer, index);
     llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
     AddAliasInfo(store, op->buffer_var.get(), op->index, op->value.dtype());
+    AddNonTemporalInfo(store, op->buffer_var.get());
     return;
   } else {
     // vector store
@@ -1072,6 +1171,7 @@ void CodeGenLLVM::VisitStmt_(const Store* op) {
         ptr = builder_->CreatePointerCast(ptr, LLVMType(t)->getPointerTo(addrspace));
         llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
         AddAliasInfo(store, op->buffer_var.get(), op->index, op->value.dtype());
+        AddNonTemporalInfo(store, op->buffer_var.get());
         return;
       }
     }
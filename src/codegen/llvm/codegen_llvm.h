@@ -234,6 +234,9 @@ class CodeGenLLVM :
   llvm::Value* CreateBroadcast(llvm::Value* value, int lanes);
   llvm::Value* CreateBufferPtr(DataType t, llvm::Value* buffer, llvm::Value* index);
   llvm::Value* CreateBufferVecPtr(DataType t, llvm::Value* buffer, llvm::Value* index);
+  // Load and store with a lane predicate.
+  llvm::Value* CreateMaskedLoad(const Load* op);
+  void CreateMaskedStore(const Store* op);
   // Vector concatenation.
   llvm::Value* CreateVecSlice(llvm::Value* vec, int begin, int extent);
   llvm::Value* CreateVecFlip(llvm::Value* vec);
@@ -246,6 +249,8 @@ class CodeGenLLVM :
                        const VarExpr& loop_var, const Stmt& body);
   // add alias information.
   void AddAliasInfo(llvm::Instruction* load, const Variable* buffer, Expr index, DataType type);
+  // mark the store as non-temporal if the buffer is in nontemporal_buf_.
+  void AddNonTemporalInfo(llvm::StoreInst* store, const Variable* buffer);
   // The IRBuilder.
   using IRBuilder = llvm::IRBuilder<llvm::ConstantFolder, llvm::IRBuilderDefaultInserter>;
   // The current function
@@ -293,6 +298,10 @@ class CodeGenLLVM :
   std::unordered_set<const Variable*> alias_var_set_;
   // set of volatile buffer.
   std::unordered_set<const Variable*> volatile_buf_;
+  // set of buffer whose contiguous stores are non-temporal.
+  std::unordered_set<const Variable*> nontemporal_buf_;
+  // number of stores emitted with non-temporal metadata.
+  int64_t num_nontemporal_store_{0};
   /*! \brief Helper struct for debug infos. */
   struct DebugInfo {
     std::unique_ptr<llvm::DIBuilder> di_builder_;
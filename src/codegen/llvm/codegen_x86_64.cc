@@ -64,12 +64,36 @@ bool TargetHasFeature(const llvm::TargetMachine& tm, const std::string& feature)
 class CodeGenX86_64 final : public CodeGenCPU {
  public:
   llvm::Value* VisitExpr_(const Cast* op) override;
+  void VisitStmt_(const AttrStmt* op) override;
 
  private:
   llvm::Value* CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes, llvm::Type* result_ty,
                                 const std::vector<llvm::Value*>& args);
 };
 
+void CodeGenX86_64::VisitStmt_(const AttrStmt* op) {
+  if (op->attr_key != ir::attr::nontemporal_store) {
+    CodeGenCPU::VisitStmt_(op);
+    return;
+  }
+  const Variable* buf = op->node.as<Variable>();
+  CHECK(buf != nullptr);
+  bool inserted = nontemporal_buf_.insert(buf).second;
+  int64_t num_store = num_nontemporal_store_;
+  this->VisitStmt(op->body);
+  if (inserted) nontemporal_buf_.erase(buf);
+  // The buffers of one scope are marked by directly nested attributes,
+  // the innermost one fences for all of them.
+  const AttrStmt* inner = op->body.as<AttrStmt>();
+  if (inner != nullptr && inner->attr_key == ir::attr::nontemporal_store) return;
+  // Non-temporal stores are weakly ordered, fence them before
+  // the results are consumed outside of the scope.
+  if (num_nontemporal_store_ == num_store) return;
+  llvm::Function* sfence = llvm::Intrinsic::getDeclaration(
+      module_.get(), ::llvm::Intrinsic::x86_sse_sfence);
+  builder_->CreateCall(sfence, {});
+}
+
 llvm::Value* CodeGenX86_64::VisitExpr_(const Cast* op) {
   // LLVM does not automatically generate the correct instruction sequences for
   // half -> float conversion (i.e. using AVX2/AVX-512 vectorized variants of
@@ -94,6 +94,69 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.cos")
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.sin")
 .set_body(DispatchLLVMPureIntrin<::llvm::Intrinsic::sin, 1>);
 
+// q_multiply_shift of int32 Q31 vectors with the saturating doubling multiply
+// high instructions of NEON instead of an int64 product, see the default rule
+// for the semantics. sqdmulh truncates the high half, which a rounding right
+// shift by at least one (srshl) then rounds the same as the single rounding of
+// the default rule. Without right shift, sqrdmulh rounds the high half itself.
+// The results are bit exact unless x << s overflows int32, where they saturate.
+// Vectors of more than four lanes are split into int32x4 pieces, LLVM merges
+// the repeated evaluation of the operands.
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.aarch64.q_multiply_shift")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  Expr e = targs[0];
+  const ir::Call* call = e.as<ir::Call>();
+  CHECK(call != nullptr);
+  CHECK_EQ(call->args.size(), 4U);
+  const Expr& x = call->args[0];
+  const Expr& y = call->args[1];
+  const Expr& s = call->args[3];
+  Expr q = call->args[2];
+  if (const ir::Broadcast* b = q.as<ir::Broadcast>()) {
+    q = b->value;
+  }
+  const int64_t* q_value = as_const_int(q);
+  int lanes = call->dtype.lanes();
+  if (call->dtype.element_of() != DataType::Int(32) || q_value == nullptr ||
+      *q_value != 31 || (lanes != 2 && lanes % 4 != 0) ||
+      x.dtype().lanes() != lanes || y.dtype().lanes() != lanes ||
+      s.dtype().lanes() != lanes) {
+    *rv = e;
+    return;
+  }
+
+  auto neon = [](unsigned id, Expr a, Expr b) {
+    Array<Expr> cargs{ir::UIntImm::make(DataType::UInt(32), id),
+                      ir::UIntImm::make(DataType::UInt(32), 1), a, b};
+    return ir::Call::make(a.dtype(), "llvm_intrin", cargs, ir::Call::PureIntrinsic);
+  };
+  auto lower = [&neon](Expr a, Expr b, Expr shift) {
+    Expr zero = make_zero(a.dtype());
+    Expr right = ir::Max::make(zero - shift, zero);
+    Expr as = neon(::llvm::Intrinsic::aarch64_neon_sqshl, a, ir::Max::make(shift, zero));
+    Expr high = neon(::llvm::Intrinsic::aarch64_neon_sqdmulh, as, b);
+    return ir::Select::make(ir::EQ::make(right, zero),
+                            neon(::llvm::Intrinsic::aarch64_neon_sqrdmulh, as, b),
+                            neon(::llvm::Intrinsic::aarch64_neon_srshl, high, zero - right));
+  };
+  if (lanes <= 4) {
+    *rv = lower(x, y, s);
+    return;
+  }
+  auto slice = [](const Expr& v, int begin) {
+    Array<Expr> indices;
+    for (int i = begin; i < begin + 4; ++i) {
+      indices.push_back(ir::IntImm::make(DataType::Int(32), i));
+    }
+    return ir::Shuffle::make({v}, indices);
+  };
+  Array<Expr> pieces;
+  for (int i = 0; i < lanes; i += 4) {
+    pieces.push_back(lower(slice(x, i), slice(y, i), slice(s, i)));
+  }
+  *rv = ir::Shuffle::make_concat(pieces);
+});
+
 }  // namespace llvm
 }  // namespace codegen
 }  // namespace tvm
@@ -34,6 +34,7 @@
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Intrinsics.h>
 #if TVM_LLVM_VERSION >= 100
+#include <llvm/IR/IntrinsicsAArch64.h>
 #include <llvm/IR/IntrinsicsAMDGPU.h>
 #include <llvm/IR/IntrinsicsARM.h>
 #include <llvm/IR/IntrinsicsNVPTX.h>
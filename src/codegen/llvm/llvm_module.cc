@@ -334,6 +334,15 @@ TVM_REGISTER_API("codegen.llvm_lookup_intrinsic_id")
     *rv = static_cast<int64_t>(LookupLLVMIntrinsic(args[0]));
   });
 
+// The architecture name of the triple of a llvm target string, e.g. "aarch64".
+TVM_REGISTER_API("codegen.llvm_target_arch")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    std::string triple, mcpu, mattr;
+    llvm::TargetOptions opt;
+    ParseLLVMTargetOptions(args[0], &triple, &mcpu, &mattr, &opt);
+    *rv = llvm::Triple::getArchTypeName(llvm::Triple(triple).getArch()).str();
+  });
+
 TVM_REGISTER_API("codegen.build_llvm")
 .set_body([](TVMArgs args, TVMRetValue* rv) {
     auto n = make_object<LLVMModuleNode>();
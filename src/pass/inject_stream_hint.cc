@@ -0,0 +1,345 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_stream_hint.cc
+ * \brief Inject software prefetch and non-temporal store hints
+ *  into the streaming loops of CPU host functions.
+ *
+ *  A streaming loop is an innermost loop that walks its buffers with a
+ *  constant stride, does little arithmetic per access and touches more
+ *  data than fits in the private caches.
+ *  - Strided reads are prefetched a fixed number of bytes ahead.
+ *    Scalar loops that stay within a cache line per iteration are left
+ *    to the hardware prefetcher, since the per-line branch would keep
+ *    LLVM from vectorizing them.
+ *  - Contiguous writes to output buffers that are never read by the
+ *    function are marked with attr::nontemporal_store, so the code
+ *    generator can bypass the cache for large outputs.
+ *  Loops with unknown trip counts are never rewritten.
+ *
+ *  The size thresholds can be dropped with TVM_STREAM_HINT_FORCE=1,
+ *  which apps/benchmark/stream_hint_bench.py uses to measure them.
+ */
+#include <tvm/ir.h>
+#include <tvm/ir_functor_ext.h>
+#include <tvm/ir_pass.h>
+#include <tvm/arithmetic.h>
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace ir {
+
+// Cache line size assumed for the prefetch granularity.
+constexpr int64_t kCacheLineBytes = 64;
+// How far ahead of the current access the data is prefetched.
+constexpr int64_t kPrefetchBytes = 1024;
+// Minimum bytes touched by a loop nest to be considered streaming.
+constexpr int64_t kMinStreamBytes = 256 * 1024;
+// Minimum bytes written by a loop nest to use non-temporal stores.
+constexpr int64_t kMinNonTemporalBytes = 4 * 1024 * 1024;
+// Minimum bytes written between two fences of non-temporal stores.
+constexpr int64_t kMinFenceBytes = 4096;
+// Maximum arithmetic operations per memory access of a streaming loop.
+constexpr int kMaxOpsPerAccess = 4;
+
+// Whether the size thresholds are ignored, read once per process.
+static bool ForceStreamHint() {
+  static const bool force = [] {
+    const char* val = getenv("TVM_STREAM_HINT_FORCE");
+    return val != nullptr && atoi(val) != 0;
+  }();
+  return force;
+}
+
+// Collect the buffers that are read or escape in the function,
+// and the buffers that are passed in as function arguments.
+class StreamBufferCollector final : public StmtExprVisitor {
+ public:
+  void VisitExpr_(const Load* op) final {
+    loaded.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const Variable* op) final {
+    opaque.insert(op);
+  }
+  void VisitStmt_(const LetStmt* op) final {
+    if (const Call* call = op->value.as<Call>()) {
+      if (call->is_intrinsic(intrinsic::tvm_struct_get) &&
+          call->args.size() == 3 &&
+          is_const_int(call->args[2], intrinsic::kArrData)) {
+        external.insert(op->var.get());
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  std::unordered_set<const Variable*> loaded;
+  std::unordered_set<const Variable*> opaque;
+  std::unordered_set<const Variable*> external;
+};
+
+// Access pattern of the loop body with respect to the loop variable.
+class StreamAccessCollector final : public StmtExprVisitor {
+ public:
+  struct Access {
+    // The memory access, either Load or Store.
+    const Object* node;
+    // The buffer accessed.
+    Var buffer;
+    // The data type of the access.
+    DataType dtype;
+    // The scalar index of the first lane.
+    Expr base;
+    // Elements advanced per loop iteration.
+    int64_t stride;
+  };
+
+  explicit StreamAccessCollector(const Var& loop_var)
+      : loop_var_(loop_var) {}
+
+  void VisitStmt_(const For* op) final {
+    complex_body = true;
+  }
+  void VisitStmt_(const Allocate* op) final {
+    complex_body = true;
+  }
+  void VisitStmt_(const Store* op) final {
+    ++num_access;
+    Record(op, op->buffer_var, op->value.dtype(), op->index, &stores);
+    this->VisitExpr(op->value);
+    VisitIndex(op->index);
+  }
+  void VisitExpr_(const Load* op) final {
+    ++num_access;
+    if (in_index_) {
+      indirect = true;
+    } else {
+      Record(op, op->buffer_var, op->dtype, op->index, &loads);
+    }
+    VisitIndex(op->index);
+  }
+  void VisitExpr(const Expr& e) final {
+    // count the arithmetic outside of the address computation.
+    if (!e->IsInstance<Load>() && !e->IsInstance<Variable>() &&
+        !e->IsInstance<IntImm>() && !e->IsInstance<UIntImm>() &&
+        !e->IsInstance<FloatImm>() && !in_index_) {
+      // calls are usually lowered into multiple instructions.
+      num_ops += e->IsInstance<Call>() ? kMaxOpsPerAccess : 1;
+    }
+    StmtExprVisitor::VisitExpr(e);
+  }
+
+  std::vector<Access> loads;
+  std::vector<Access> stores;
+  int64_t num_ops{0};
+  int64_t num_access{0};
+  // Whether the body contains loops or allocations.
+  bool complex_body{false};
+  // Whether there is indirect memory access like A[B[i]].
+  bool indirect{false};
+
+ private:
+  void VisitIndex(const Expr& index) {
+    bool in_index = in_index_;
+    in_index_ = true;
+    this->VisitExpr(index);
+    in_index_ = in_index;
+  }
+  void Record(const Object* node, const Var& buffer, DataType dtype,
+              const Expr& index, std::vector<Access>* out) {
+    Expr base = index;
+    if (const Ramp* ramp = index.as<Ramp>()) {
+      if (!is_one(ramp->stride)) return;
+      base = ramp->base;
+    } else if (dtype.lanes() != 1) {
+      return;
+    }
+    Array<Expr> coeff = arith::DetectLinearEquation(base, {loop_var_});
+    if (coeff.size() != 2) return;
+    const int64_t* stride = as_const_int(coeff[0]);
+    if (stride == nullptr || *stride <= 0) return;
+    out->push_back(Access{node, buffer, dtype, base, *stride});
+  }
+
+  Var loop_var_;
+  bool in_index_{false};
+};
+
+class StreamHintInjector final : public StmtMutator {
+ public:
+  explicit StreamHintInjector(const StreamBufferCollector& buffers)
+      : buffers_(buffers) {}
+
+  Stmt Inject(Stmt body) {
+    nt_scope_.emplace_back();
+    body = this->VisitStmt(body);
+    return WrapNonTemporal(body);
+  }
+
+  Stmt VisitStmt_(const For* op) final {
+    const int64_t* extent = as_const_int(op->extent);
+    int64_t total_trip = total_trip_;
+    int64_t scope_trip = scope_trip_;
+    bool parallel = op->for_type == ForType::Parallel;
+    if (parallel) {
+      nt_scope_.emplace_back();
+      scope_trip_ = 1;
+    }
+    total_trip_ = MulTrip(total_trip_, extent);
+    scope_trip_ = MulTrip(scope_trip_, extent);
+    Stmt stmt = RewriteStream(op, parallel);
+    if (!stmt.defined()) {
+      stmt = StmtMutator::VisitStmt_(op);
+    }
+    total_trip_ = total_trip;
+    scope_trip_ = scope_trip;
+    if (parallel) {
+      op = stmt.as<For>();
+      stmt = For::make(op->loop_var, op->min, op->extent,
+                       op->for_type, op->device_api,
+                       WrapNonTemporal(op->body));
+    }
+    return stmt;
+  }
+
+ private:
+  // Multiply the trip count, -1 means unknown.
+  static int64_t MulTrip(int64_t trip, const int64_t* extent) {
+    if (trip < 0 || extent == nullptr) return -1;
+    return trip * (*extent);
+  }
+  // Whether bytes touched by trip iterations reach the threshold.
+  // Unknown trip counts never reach it.
+  static bool Reach(int64_t trip, int64_t bytes_per_iter, int64_t threshold) {
+    if (trip < 0) return false;
+    return ForceStreamHint() || trip * bytes_per_iter >= threshold;
+  }
+  // Rewrite the innermost loop, return undefined Stmt if it is not streaming.
+  Stmt RewriteStream(const For* op, bool parallel) {
+    if (!as_const_int(op->min) || !as_const_int(op->extent)) return Stmt();
+    StreamAccessCollector acc(op->loop_var);
+    acc(op->body);
+    if (acc.complex_body || acc.num_access == 0) return Stmt();
+    if (acc.num_ops > kMaxOpsPerAccess * acc.num_access) return Stmt();
+    int64_t bytes_per_iter = 0;
+    for (const auto& a : acc.loads) {
+      bytes_per_iter += a.stride * a.dtype.bytes();
+    }
+    for (const auto& a : acc.stores) {
+      bytes_per_iter += a.stride * a.dtype.bytes();
+    }
+    if (!Reach(total_trip_, bytes_per_iter, kMinStreamBytes)) return Stmt();
+
+    std::vector<Stmt> prefetch;
+    if (!acc.indirect) {
+      // one prefetch stream per buffer and stride.
+      std::vector<std::pair<const Variable*, int64_t> > streams;
+      for (const auto& a : acc.loads) {
+        auto key = std::make_pair(a.buffer.get(), a.stride);
+        if (a.dtype.lanes() == 1 &&
+            a.stride * a.dtype.bytes() < kCacheLineBytes) continue;
+        if (std::find(streams.begin(), streams.end(), key) != streams.end()) continue;
+        streams.push_back(key);
+        prefetch.push_back(MakePrefetch(op, a));
+      }
+    }
+    bool marked = false;
+    if (!parallel) {
+      for (const auto& a : acc.stores) {
+        const Store* store = static_cast<const Store*>(a.node);
+        const Variable* buf = a.buffer.get();
+        int64_t nbytes = a.stride * a.dtype.bytes();
+        if (a.stride != a.dtype.lanes() || !is_one(store->predicate)) continue;
+        if (!buffers_.external.count(buf) || buffers_.loaded.count(buf) ||
+            buffers_.opaque.count(buf)) continue;
+        if (!Reach(total_trip_, nbytes, kMinNonTemporalBytes)) continue;
+        if (!Reach(scope_trip_, nbytes, kMinFenceBytes)) continue;
+        auto& scope = nt_scope_.back();
+        if (std::find_if(scope.begin(), scope.end(), [buf](const Var& v) {
+              return v.get() == buf;
+            }) == scope.end()) {
+          scope.push_back(a.buffer);
+        }
+        marked = true;
+      }
+    }
+    if (prefetch.empty() && !marked) return Stmt();
+    if (prefetch.empty()) return GetRef<Stmt>(op);
+    prefetch.push_back(op->body);
+    return For::make(op->loop_var, op->min, op->extent, op->for_type,
+                     op->device_api, Block::make(prefetch));
+  }
+  // Prefetch the data that will be accessed kPrefetchBytes ahead,
+  // once per cache line. The index is clamped to the last iteration,
+  // so the prefetch address stays within the buffer.
+  Stmt MakePrefetch(const For* op, const StreamAccessCollector::Access& a) {
+    const Var& loop_var = op->loop_var;
+    int64_t stride_bytes = a.stride * a.dtype.bytes();
+    int64_t dist = std::max<int64_t>(1, (kPrefetchBytes + stride_bytes - 1) / stride_bytes);
+    int64_t every = std::max<int64_t>(1, kCacheLineBytes / stride_bytes);
+    std::unordered_map<const Variable*, Expr> vmap;
+    int64_t last = *as_const_int(op->min) + *as_const_int(op->extent) - 1;
+    vmap[loop_var.get()] = min(loop_var + make_const(loop_var.dtype(), dist),
+                               make_const(loop_var.dtype(), last));
+    Expr load = Load::make(a.dtype.element_of(), a.buffer,
+                           Substitute(a.base, vmap), const_true());
+    Expr address = Call::make(DataType::Handle(), intrinsic::tvm_address_of,
+                              {load}, Call::PureIntrinsic);
+    Stmt stmt = Evaluate::make(Call::make(
+        DataType::Int(32), Call::prefetch, {address, 0, 3, 1}, Call::Intrinsic));
+    if (every > 1) {
+      stmt = IfThenElse::make(
+          floormod(loop_var, make_const(loop_var.dtype(), every)) == 0, stmt);
+    }
+    return stmt;
+  }
+  // Mark the non-temporal buffers of the innermost scope.
+  Stmt WrapNonTemporal(Stmt body) {
+    for (const Var& buf : nt_scope_.back()) {
+      body = AttrStmt::make(buf, attr::nontemporal_store,
+                            make_const(DataType::Int(32), 1), body);
+    }
+    nt_scope_.pop_back();
+    return body;
+  }
+
+  const StreamBufferCollector& buffers_;
+  // trip count of all the enclosing loops.
+  int64_t total_trip_{1};
+  // trip count of the enclosing loops within the current fence scope.
+  int64_t scope_trip_{1};
+  // buffers with non-temporal stores of each fence scope.
+  std::vector<std::vector<Var> > nt_scope_;
+};
+
+LoweredFunc InjectStreamHint(LoweredFunc f) {
+  StreamBufferCollector buffers;
+  buffers(f->body);
+  auto n = make_object<LoweredFuncNode>(*f.operator->());
+  n->body = StreamHintInjector(buffers).Inject(f->body);
+  return LoweredFunc(n);
+}
+
+}  // namespace ir
+}  // namespace tvm
@@ -46,7 +46,15 @@ class IntrinInjecter : public tvm::arith::IRMutatorWithAnalyzer {
     patterns_.push_back("tvm.intrin.rule." + starget + ".");
     patterns_.push_back("tvm.intrin.rule.default.");
     fma_ = runtime::Registry::Get(patterns_[0] + "fma");
-    if (target == "stackvm") {
+    // Rules specific to the architecture of a llvm target go first, e.g.
+    // tvm.intrin.rule.llvm.aarch64.q_multiply_shift.
+    if (starget == "llvm") {
+      if (const runtime::PackedFunc* farch = runtime::Registry::Get("codegen.llvm_target_arch")) {
+        std::string arch = (*farch)(target);
+        patterns_.insert(patterns_.begin(), "tvm.intrin.rule.llvm." + arch + ".");
+      }
+    }
+    if (starget == "stackvm") {
       support_bitwise_op_ = false;
     }
   }
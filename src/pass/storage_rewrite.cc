@@ -26,6 +26,8 @@
 #include <tvm/ir_pass.h>
 #include <tvm/ir_functor_ext.h>
 #include <tvm/target_info.h>
+#include <tvm/runtime/device_api.h>
+#include <algorithm>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -131,18 +133,26 @@ class LinearAccessPatternFinder final : public StmtExprVisitor {
     if (op->is_intrinsic(intrinsic::tvm_address_of)) {
       const Load* l = op->args[0].as<Load>();
       this->VisitExpr(l->index);
+    } else if (op->is_intrinsic(intrinsic::tvm_access_ptr)) {
+      // access_ptr is remapped with the buffer offset,
+      // so it does not expose the raw address.
+      CHECK_EQ(op->args.size(), 5U);
+      for (size_t i = 0; i < op->args.size(); ++i) {
+        const Variable* buf = op->args[i].as<Variable>();
+        if (i == 1 && buf != nullptr) {
+          this->Touch(buf);
+        } else {
+          this->VisitExpr(op->args[i]);
+        }
+      }
     } else {
       StmtExprVisitor::VisitExpr_(op);
     }
   }
   void VisitExpr_(const Variable* buf) final {
     // Directly reference to the variable count as a read.
-    auto it = alloc_info_.find(buf);
-    if (it != alloc_info_.end() && it->second.alloc) {
-      CHECK_LT(it->second.level, scope_.size())
-          << " buf=" << buf->name_hint;
-      scope_[it->second.level].touched.push_back(buf);
-    }
+    if (alloc_info_.count(buf)) opaque_access_.insert(buf);
+    this->Touch(buf);
   }
   template<typename T>
   void VisitNewScope(const T* op) {
@@ -199,8 +209,18 @@ class LinearAccessPatternFinder final : public StmtExprVisitor {
   std::vector<StmtEntry> linear_seq_;
   // The storage scope of each buffer
   std::unordered_map<const Variable*, AllocEntry> alloc_info_;
+  // Buffers whose address is directly referenced.
+  std::unordered_set<const Variable*> opaque_access_;
 
  private:
+  void Touch(const Variable* buf) {
+    auto it = alloc_info_.find(buf);
+    if (it != alloc_info_.end() && it->second.alloc) {
+      CHECK_LT(it->second.level, scope_.size())
+          << " buf=" << buf->name_hint;
+      scope_[it->second.level].touched.push_back(buf);
+    }
+  }
   // Whether already in thread env.
   bool in_thread_env_{false};
   // The scope stack.
@@ -347,6 +367,7 @@ class StoragePlanRewriter : public StmtExprMutator {
     finder(stmt);
     this->LivenessAnalysis(finder.linear_seq_);
     this->PlanMemory(finder.linear_seq_, finder.alloc_info_);
+    opaque_access_ = std::move(finder.opaque_access_);
     this->PrepareNewAlloc();
     // start rewrite
     stmt = operator()(std::move(stmt));
@@ -503,6 +524,10 @@ class StoragePlanRewriter : public StmtExprMutator {
     // This allows effective sharing among different types as long as their alignment
     // requirement fits into the max_simd_bits.
     uint64_t bits_offset{0};
+    // The first and last index in the linear sequence where
+    // any of the allocs of this entry is alive.
+    size_t live_begin{std::numeric_limits<size_t>::max()};
+    size_t live_end{0};
   };
 
   // Alllocate entry of node.
@@ -632,6 +657,96 @@ class StoragePlanRewriter : public StmtExprMutator {
           }
         }
       }
+      PackArena(vec);
+    }
+  }
+  // Whether the entry can be placed into a packed arena.
+  // Return the size of the entry in bits, or 0 if it cannot.
+  uint64_t ArenaBits(const StorageEntry* e) const {
+    // Offsets are aligned to the workspace alignment.
+    const uint64_t align_bits = runtime::kAllocAlignment * 8;
+    if (e->scope.tag.length() != 0 ||
+        e->scope.rank != StorageRank::kGlobal) return 0;
+    if (e->bits_offset != 0 || !e->merged_children.empty()) return 0;
+    const Allocate* alloc = e->new_alloc.as<Allocate>();
+    if (alloc == nullptr || alloc->dtype.is_handle()) return 0;
+    int32_t const_size = alloc->constant_allocation_size();
+    if (const_size <= 0) return 0;
+    uint64_t nbits = static_cast<uint64_t>(const_size) *
+        alloc->dtype.bits() * alloc->dtype.lanes();
+    // Small buffers stay on the stack, only pack the ones
+    // that will be lowered to workspace requests.
+    if (nbits < static_cast<uint64_t>(runtime::kMaxStackAlloca) * 8) return 0;
+    for (const Allocate* op : e->allocs) {
+      if (opaque_access_.count(op->buffer_var.get())) return 0;
+      if (!is_one(op->condition)) return 0;
+      uint64_t elem_bits = op->dtype.bits() * op->dtype.lanes();
+      if (align_bits % elem_bits != 0) return 0;
+    }
+    return nbits;
+  }
+  // Pack the workspace allocations of one attach scope into
+  // a single arena, giving each entry a static offset.
+  //
+  // Entries whose live ranges overlap get disjoint ranges in the arena,
+  // the others can share space. Offsets are assigned greedily,
+  // largest entry first, at the lowest aligned offset that does not
+  // conflict with any already placed live entry.
+  void PackArena(const std::vector<StorageEntry*>& vec) {
+    const uint64_t align_bits = runtime::kAllocAlignment * 8;
+    std::vector<std::pair<StorageEntry*, uint64_t> > cand;
+    for (StorageEntry* e : vec) {
+      uint64_t nbits = ArenaBits(e);
+      if (nbits != 0) cand.emplace_back(e, nbits);
+    }
+    if (cand.size() < 2) return;
+    std::stable_sort(cand.begin(), cand.end(),
+                     [](const std::pair<StorageEntry*, uint64_t>& lhs,
+                        const std::pair<StorageEntry*, uint64_t>& rhs) {
+                       return lhs.second > rhs.second;
+                     });
+    std::vector<uint64_t> offsets;
+    uint64_t total_bits = 0;
+    for (size_t i = 0; i < cand.size(); ++i) {
+      StorageEntry* e = cand[i].first;
+      // placed entries that are alive at the same time, sorted by offset.
+      std::vector<std::pair<uint64_t, uint64_t> > conflict;
+      for (size_t j = 0; j < i; ++j) {
+        StorageEntry* p = cand[j].first;
+        if (p->live_begin <= e->live_end && e->live_begin <= p->live_end) {
+          conflict.emplace_back(offsets[j], cand[j].second);
+        }
+      }
+      std::sort(conflict.begin(), conflict.end());
+      uint64_t offset = 0;
+      for (const auto& c : conflict) {
+        if (offset + cand[i].second <= c.first) break;
+        uint64_t end = c.first + c.second;
+        end = (end + align_bits - 1) / align_bits * align_bits;
+        offset = std::max(offset, end);
+      }
+      offsets.push_back(offset);
+      total_bits = std::max(total_bits, offset + cand[i].second);
+    }
+    // The largest entry is placed at offset 0 and hosts the arena.
+    StorageEntry* root = cand[0].first;
+    const Allocate* root_alloc = root->new_alloc.as<Allocate>();
+    DataType arena_type = root_alloc->dtype;
+    uint64_t type_bits = arena_type.bits() * arena_type.lanes();
+    uint64_t arena_elem = (total_bits + type_bits - 1) / type_bits;
+    DataType size_type = DataType::Int(32);
+    if (arena_elem > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      size_type = DataType::Int(64);
+    }
+    root->new_alloc = Allocate::make(
+        root->alloc_var, arena_type,
+        {make_const(size_type, static_cast<int64_t>(arena_elem))},
+        const_true(), Evaluate::make(0));
+    for (size_t i = 1; i < cand.size(); ++i) {
+      StorageEntry* e = cand[i].first;
+      e->new_alloc = Stmt();
+      e->alloc_var = root->alloc_var;
+      e->bits_offset = offsets[i];
     }
   }
   // New allocation for merged data
@@ -776,6 +891,7 @@ class StoragePlanRewriter : public StmtExprMutator {
             dst_entry = FindAlloc(ae.alloc, thread_scope_, ae.storage_scope);
           }
           dst_entry->allocs.emplace_back(ae.alloc);
+          dst_entry->live_begin = std::min(dst_entry->live_begin, i);
           alloc_map_[var] = dst_entry;
         }
       }
@@ -803,6 +919,8 @@ class StoragePlanRewriter : public StmtExprMutator {
       // In both cases, we need to handle the kill event correctly
       if (it != event_map_.end() && seq[i].scope_pair_offset <= 0) {
         for (const Variable* var : it->second.kill) {
+          StorageEntry* e = alloc_map_.at(var);
+          e->live_end = std::max(e->live_end, i);
           // skip space which are already replaced by inplace
           if (!inplace_flag.count(var)) {
             this->Free(var);
@@ -928,6 +1046,8 @@ class StoragePlanRewriter : public StmtExprMutator {
   std::unordered_map<const Variable*, StorageEntry*> alloc_map_;
   // The allocations
   std::vector<std::unique_ptr<StorageEntry> > alloc_vec_;
+  // Buffers whose address is directly referenced.
+  std::unordered_set<const Variable*> opaque_access_;
   // analyzer
   arith::Analyzer analyzer_;
 };
@@ -25,6 +25,11 @@
 #include <tvm/ir_pass.h>
 #include <tvm/ir_functor_ext.h>
 #include <tvm/arithmetic.h>
+#include <tvm/build_module.h>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <string>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -93,10 +98,81 @@ class VecAllocAccess : public StmtExprMutator {
   int var_lanes_;
 };
 
+// Guard the memory accesses of a vectorized expression or store
+// sequence with a lane mask, so the lanes whose condition is false
+// never touch memory.
+class AccessPredicator : public StmtExprMutator {
+ public:
+  explicit AccessPredicator(Expr mask)
+      : mask_(mask), lanes_(mask.dtype().lanes()) {}
+
+  Stmt VisitStmt(const Stmt& stmt) final {
+    if (!stmt.as<Store>() && !stmt.as<Block>()) {
+      fail = true;
+      return stmt;
+    }
+    return StmtExprMutator::VisitStmt(stmt);
+  }
+  Expr VisitExpr_(const Load* op) final {
+    Expr index = this->VisitExpr(op->index);
+    if (op->dtype.lanes() != lanes_ || index.dtype().lanes() != lanes_) {
+      fail = true;
+      return GetRef<Expr>(op);
+    }
+    return Load::make(op->dtype, op->buffer_var, index, Mask(op->predicate));
+  }
+  Stmt VisitStmt_(const Store* op) final {
+    Expr value = this->VisitExpr(op->value);
+    Expr index = this->VisitExpr(op->index);
+    if (value.dtype().lanes() != lanes_ ||
+        index.dtype().lanes() != lanes_) {
+      fail = true;
+      return GetRef<Stmt>(op);
+    }
+    return Store::make(op->buffer_var, value, index, Mask(op->predicate));
+  }
+  // The masked lanes still evaluate the arithmetic,
+  // reject operations that may trap on the filler values.
+  Expr VisitExpr_(const Div* op) final {
+    CheckDivisor(op->b);
+    return StmtExprMutator::VisitExpr_(op);
+  }
+  Expr VisitExpr_(const Mod* op) final {
+    CheckDivisor(op->b);
+    return StmtExprMutator::VisitExpr_(op);
+  }
+  Expr VisitExpr_(const FloorDiv* op) final {
+    CheckDivisor(op->b);
+    return StmtExprMutator::VisitExpr_(op);
+  }
+  Expr VisitExpr_(const FloorMod* op) final {
+    CheckDivisor(op->b);
+    return StmtExprMutator::VisitExpr_(op);
+  }
+  Expr VisitExpr_(const Call* op) final {
+    if (!op->is_pure()) fail = true;
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  bool fail{false};
+
+ private:
+  Expr Mask(const Expr& predicate) {
+    if (is_one(predicate)) return mask_;
+    return And::make(BroadcastTo(predicate, lanes_), mask_);
+  }
+  void CheckDivisor(const Expr& b) {
+    if (!b.dtype().is_float() && !is_const(b)) fail = true;
+  }
+
+  Expr mask_;
+  int lanes_;
+};
+
 class Vectorizer : public StmtExprMutator {
  public:
-  Vectorizer(Var var, int var_lanes)
-      : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool predicated = false)
+      : var_(var), var_lanes_(var_lanes), predicated_(predicated) {
     ramp_ = Ramp::make(0, 1, var_lanes);
   }
 
@@ -241,6 +317,10 @@ class Vectorizer : public StmtExprMutator {
   Expr MutateIfThenElseExpr_(const Call *op) {
     Expr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_vector())  {
+      if (predicated_) {
+        Expr ret = PredicateIfThenElseExpr_(op, cond);
+        if (ret.defined()) return ret;
+      }
       need_scalarize_ = true;
       return GetRef<Expr>(op);
     }
@@ -259,6 +339,23 @@ class Vectorizer : public StmtExprMutator {
           {cond, t, f}, op->call_type, op->func, op->value_index);
     }
   }
+  // Vector condition of IfThenElse expr, select between both branches
+  // with their memory accesses masked by the lanes that use them.
+  Expr PredicateIfThenElseExpr_(const Call* op, const Expr& cond) {
+    if (cond.dtype().lanes() != var_lanes_) return Expr();
+    Expr t = this->VisitExpr(op->args[1]);
+    Expr f = this->VisitExpr(op->args[2]);
+    if (need_scalarize_) return Expr();
+    AccessPredicator pt(cond), pf(Not::make(cond));
+    t = pt(BroadcastTo(t, var_lanes_));
+    f = pf(BroadcastTo(f, var_lanes_));
+    if (pt.fail || pf.fail ||
+        t.dtype().lanes() != var_lanes_ ||
+        f.dtype().lanes() != var_lanes_) {
+      return Expr();
+    }
+    return Select::make(cond, t, f);
+  }
   // Call
   Expr VisitExpr_(const Call* op) final {
     if (op->name == intrinsic::tvm_if_then_else) {
@@ -381,6 +478,10 @@ class Vectorizer : public StmtExprMutator {
     CHECK(!op->condition.dtype().is_vector());
     Expr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (predicated_) {
+        Stmt ret = PredicateIfThenElse_(op, condition);
+        if (ret.defined()) return ret;
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -396,6 +497,19 @@ class Vectorizer : public StmtExprMutator {
       return IfThenElse::make(condition, then_case, else_case);
     }
   }
+  // Vector condition of IfThenElse, turn the stores of both
+  // branches into masked stores.
+  Stmt PredicateIfThenElse_(const IfThenElse* op, const Expr& condition) {
+    if (condition.dtype().lanes() != var_lanes_) return Stmt();
+    AccessPredicator pt(condition);
+    Stmt then_case = pt(this->VisitStmt(op->then_case));
+    if (pt.fail) return Stmt();
+    if (!op->else_case.defined()) return then_case;
+    AccessPredicator pf(Not::make(condition));
+    Stmt else_case = pf(this->VisitStmt(op->else_case));
+    if (pf.fail) return Stmt();
+    return Block::make(then_case, else_case);
+  }
   // LetStmt
   Stmt VisitStmt_(const LetStmt* op) final {
     LOG(WARNING) << "Cannot vectorize with LetStmt, remove it with Simplify Before Vectorize";
@@ -449,6 +563,8 @@ class Vectorizer : public StmtExprMutator {
   int var_lanes_;
   // ramp representing the var.
   Expr ramp_;
+  // whether vector conditions can become masked memory accesses.
+  bool predicated_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
   // The lets
@@ -517,25 +633,171 @@ class Vectorizer : public StmtExprMutator {
   }
 };
 
+// Find the widest scalar element accessed by the loop body.
+class MaxElemBitsFinder : public StmtExprVisitor {
+ public:
+  void VisitExpr_(const Load* op) final {
+    Update(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitStmt_(const Store* op) final {
+    Update(op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  int max_bits{0};
+
+ private:
+  void Update(DataType t) {
+    if (!t.is_handle()) max_bits = std::max(max_bits, t.bits() * t.lanes());
+  }
+};
+
+// The x86 vector feature that the given feature depends on.
+std::string ParentFeature(const std::string& feature) {
+  if (feature == "avx512f") return "avx2";
+  if (feature.compare(0, 6, "avx512") == 0) return "avx512f";
+  if (feature == "avx2") return "avx";
+  return "";
+}
+
+// The vector features enabled by the -mcpu and -mattr options of an llvm target.
+// "+f" in -mattr enables f and the features it depends on, "-f" disables f
+// and the features that depend on it, in the order they are given after -mcpu.
+// CPUs that are not listed, including -mcpu=native, add no features.
+std::unordered_set<std::string> GetTargetFeatures(const Target& target) {
+  static const std::unordered_map<std::string, std::string> cpu_features = {
+    {"sandybridge", "avx"}, {"ivybridge", "avx"}, {"corei7-avx", "avx"},
+    {"core-avx-i", "avx"}, {"btver2", "avx"}, {"bdver1", "avx"},
+    {"bdver2", "avx"}, {"bdver3", "avx"}, {"bdver4", "avx"},
+    {"haswell", "avx2"}, {"broadwell", "avx2"}, {"skylake", "avx2"},
+    {"core-avx2", "avx2"}, {"znver1", "avx2"}, {"znver2", "avx2"},
+    {"skylake-avx512", "avx512f"}, {"cascadelake", "avx512f"},
+    {"cooperlake", "avx512f"}, {"cannonlake", "avx512f"},
+    {"icelake-client", "avx512f"}, {"icelake-server", "avx512f"},
+    {"tigerlake", "avx512f"}, {"knl", "avx512f"}, {"knm", "avx512f"},
+    {"a64fx", "sve"}};
+  std::unordered_set<std::string> features;
+  if (!target.defined() || target->target_name != "llvm") return features;
+  auto enable = [&features](std::string f) {
+    for (; !f.empty(); f = ParentFeature(f)) features.insert(f);
+  };
+  auto disable = [&features](const std::string& f) {
+    for (auto it = features.begin(); it != features.end();) {
+      std::string g = *it;
+      while (!g.empty() && g != f) g = ParentFeature(g);
+      it = g.empty() ? std::next(it) : features.erase(it);
+    }
+  };
+  std::vector<std::string> attrs;
+  for (const std::string& opt : target->options()) {
+    if (opt.compare(0, 6, "-mcpu=") == 0) {
+      auto it = cpu_features.find(opt.substr(6));
+      if (it != cpu_features.end()) enable(it->second);
+    } else if (opt.compare(0, 7, "-mattr=") == 0) {
+      std::istringstream is(opt.substr(7));
+      std::string attr;
+      while (std::getline(is, attr, ',')) attrs.push_back(attr);
+    }
+  }
+  for (const std::string& attr : attrs) {
+    if (attr.empty()) continue;
+    if (attr[0] == '-') {
+      disable(attr.substr(1));
+    } else {
+      enable(attr[0] == '+' ? attr.substr(1) : attr);
+    }
+  }
+  return features;
+}
+
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(const Target& target) {
+    std::unordered_set<std::string> features = GetTargetFeatures(target);
+    if (features.count("avx512f")) {
+      vector_bits_ = 512;
+    } else if (features.count("avx")) {
+      vector_bits_ = 256;
+    }
+    // whether masked vector memory accesses are lowered natively.
+    predicated_ = features.count("avx512f") || features.count("sve");
+  }
+
   Stmt VisitStmt_(const For* op) final {
     if (op->for_type == ForType::Vectorized) {
       CHECK(is_zero(op->min));
       int lanes = 0;
       bool succ = arith::GetConstInt(op->extent, &lanes);
-      if (!succ || lanes < 1) {
+      if (!succ) {
+        return VersionLoop(op);
+      }
+      if (lanes < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, lanes)(op->body);
+      return Vectorizer(op->loop_var, lanes, predicated_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  // Version a loop with symbolic extent into a vectorized main loop
+  // and a scalar epilogue, or a single masked vector iteration when
+  // the target has masked memory accesses.
+  //
+  // for (i, 0, n) vectorized
+  //   body(i)
+  // =>
+  // for (i.v, 0, n / lanes)
+  //   body(i.v * lanes + ramp(0, 1, lanes))
+  // for (i.t, 0, n - n / lanes * lanes)
+  //   body(n / lanes * lanes + i.t)
+  Stmt VersionLoop(const For* op) {
+    MaxElemBitsFinder finder;
+    finder(op->body);
+    int lanes = vector_bits_ / std::max(8, finder.max_bits);
+    if (finder.max_bits == 0 || lanes < 2) {
+      return For::make(op->loop_var, op->min, op->extent, ForType::Serial,
+                       op->device_api, this->VisitStmt(op->body));
+    }
+    DataType t = op->loop_var.dtype();
+    Expr vlanes = make_const(t, lanes);
+    Expr main_extent = floordiv(op->extent, vlanes);
+    Expr tail_begin = main_extent * vlanes;
+
+    Var vo(op->loop_var->name_hint + ".v", t);
+    std::unordered_map<const Variable*, Expr> vmap;
+    vmap[op->loop_var.get()] = vo * vlanes + op->loop_var;
+    Stmt main_body = Vectorizer(op->loop_var, lanes, predicated_)(
+        Substitute(op->body, vmap));
+    Stmt main_loop = For::make(vo, make_zero(t), main_extent, ForType::Serial,
+                               op->device_api, main_body);
+
+    if (predicated_) {
+      // one masked vector iteration covers the remainder.
+      vmap[op->loop_var.get()] = tail_begin + op->loop_var;
+      Stmt tail_body = IfThenElse::make(
+          tail_begin + op->loop_var < op->extent, Substitute(op->body, vmap));
+      tail_body = Vectorizer(op->loop_var, lanes, true)(tail_body);
+      return Block::make(main_loop, IfThenElse::make(tail_begin < op->extent, tail_body));
+    }
+    Var vt(op->loop_var->name_hint + ".t", t);
+    vmap[op->loop_var.get()] = tail_begin + vt;
+    Stmt tail_loop = For::make(vt, make_zero(t), op->extent - tail_begin,
+                               ForType::Serial, op->device_api,
+                               Substitute(this->VisitStmt(op->body), vmap));
+    return Block::make(main_loop, tail_loop);
+  }
+  // Native vector register width of the target, used for the lanes
+  // of loops whose extent does not fix them.
+  int vector_bits_{128};
+  bool predicated_{false};
 };
 
-Stmt VectorizeLoop(Stmt stmt) {
-  return LoopVectorizer()(std::move(stmt));
+Stmt VectorizeLoop(Stmt stmt, const Target& target) {
+  Target t = target.defined() ? target : Target::Current(true);
+  return LoopVectorizer(t)(std::move(stmt));
 }
 
 class VectorizeSkipper : public StmtMutator {
@@ -362,7 +362,13 @@ class RelayBuildModule : public runtime::ModuleNode {
     }
 
     // Fuse the operations if it is needed.
+    // The target is made visible to the fusion cost model, if any.
+    std::unique_ptr<With<Target>> target_scope;
+    if (targets.size() == 1) {
+      target_scope.reset(new With<Target>((*targets.begin()).second));
+    }
     relay_module = transform::FuseOps()(relay_module);
+    target_scope.reset();
     relay_module = transform::InferType()(relay_module);
     CHECK(relay_module.defined());
 
@@ -734,7 +734,8 @@ class CompileEngineImpl : public CompileEngineNode {
     } else {
       tvm::BuildConfig bcfg = BuildConfig::Create();
       std::unordered_map<Tensor, Buffer> binds;
-      cache_node->funcs = tvm::lower(spair.first, all_args, cache_node->func_name, binds, bcfg);
+      cache_node->funcs = tvm::lower(spair.first, all_args, cache_node->func_name, binds, bcfg,
+                                     key->target);
     }
     value->cached_func = CachedFunc(cache_node);
     return value;
@@ -769,7 +770,8 @@ class CompileEngineImpl : public CompileEngineNode {
     }
     tvm::BuildConfig bcfg = BuildConfig::Create();
     std::unordered_map<Tensor, Buffer> binds;
-    cache_node->funcs = tvm::lower(spair.first, all_args, cache_node->func_name, binds, bcfg);
+    cache_node->funcs = tvm::lower(spair.first, all_args, cache_node->func_name, binds, bcfg,
+                                   key->target);
     value->cached_func = CachedFunc(cache_node);
     return value;
   }
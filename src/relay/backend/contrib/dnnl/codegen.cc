@@ -22,6 +22,7 @@
  * \brief Implementation of DNNL codegen APIs.
  */
 
+#include <dmlc/json.h>
 #include <tvm/relay/attrs/nn.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
@@ -30,7 +31,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <fstream>
+#include <map>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "../codegen_c/codegen_c.h"
 
@@ -50,6 +54,33 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     out_.push_back({node->name_hint(), 0});
   }
 
+  void VisitExpr_(const ConstantNode* cn) final {
+    // Constants are emitted as static arrays, so the DNNL kernels can
+    // keep the weights reordered across calls. The bits of the floats are
+    // written as is, which keeps them exact and allows inf and nan.
+    runtime::NDArray array = cn->data;
+    CHECK(runtime::TypeMatch(array->dtype, kDLFloat, 32))
+        << "Only support float constants";
+    CHECK_EQ(array->ctx.device_type, kDLCPU);
+    int size = 1;
+    for (int i = 0; i < array->ndim; ++i) {
+      size *= static_cast<int>(array->shape[i]);
+    }
+    const uint32_t* bits = static_cast<const uint32_t*>(array->data);
+    std::string name = ext_func_id_ + "_const_" + std::to_string(const_idx_++);
+    std::ostringstream os;
+    os << "static union { uint32_t bits[" << size << "]; float data[" << size << "]; } "
+       << name << " = {{" << std::hex;
+    for (int i = 0; i < size; ++i) {
+      if (i != 0) os << ", ";
+      os << "0x" << bits[i];
+    }
+    os << "}};";
+    static_decl_.push_back(os.str());
+    out_.clear();
+    out_.push_back({name + ".data", size});
+  }
+
   void VisitExpr_(const TupleGetItemNode* op) final {
     // Do nothing
   }
@@ -77,7 +108,7 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
       decl_stream << "dnnl_add";
       args = Add(call);
     } else {
-      LOG(FATAL) << "Unsupported op: " << AsText(call->op, false);
+      LOG(FATAL) << "Unsupported op: " << op_node->name;
     }
 
     // Make function call with input buffers when visiting arguments
@@ -113,7 +144,11 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     for (size_t i = 0; i < args.size(); ++i) {
       decl_stream << ", " << args[i];
     }
-    decl_stream << ");";
+
+    // The kernel handle of the call site
+    std::string handle = ext_func_id_ + "_kernel_" + std::to_string(kernel_idx_++);
+    static_decl_.push_back("static DNNLKernelHandle " + handle + ";");
+    decl_stream << ", &" << handle << ");";
     ext_func_body.push_back(decl_stream.str());
 
     // Update output buffer
@@ -122,6 +157,9 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
   }
 
   std::string JIT(void) {
+    for (const auto& decl : static_decl_) {
+      code_stream_ << decl << "\n";
+    }
     return JitImpl(ext_func_id_, ext_func_args_, buf_decl_, ext_func_body, out_);
   }
 
@@ -149,6 +187,9 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     args.push_back(std::to_string(conv2d_attr->strides[0].as<IntImm>()->value));
     args.push_back(std::to_string(conv2d_attr->strides[1].as<IntImm>()->value));
 
+    // Args: whether the weights are constant
+    args.push_back(IsConstant(call->args[1]));
+
     return args;
   }
 
@@ -162,6 +203,9 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     args.push_back(std::to_string(ishape[1]));
     args.push_back(std::to_string(wshape[0]));
 
+    // Args: whether the weights are constant
+    args.push_back(IsConstant(call->args[1]));
+
     return args;
   }
 
@@ -190,6 +234,10 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     // Args: epsilon
     args.push_back(std::to_string(bn_attr->epsilon));
 
+    // Args: whether gamma and beta are constant
+    args.push_back(call->args[1].as<ConstantNode>() && call->args[2].as<ConstantNode>()
+                   ? "1" : "0");
+
     return args;
   }
 
@@ -205,6 +253,10 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
     return args;
   }
 
+  std::string IsConstant(const Expr& expr) const {
+    return expr.as<ConstantNode>() ? "1" : "0";
+  }
+
   /*! \brief The id of the external dnnl ext_func. */
   std::string ext_func_id_{""};
   /*!
@@ -218,6 +270,12 @@ class CodegenDNNL : public ExprVisitor, public CodegenCBase {
   std::vector<std::string> ext_func_body;
   /*! \brief The declaration of intermeidate buffers. */
   std::vector<std::string> buf_decl_;
+  /*! \brief The index to track the constant arrays. */
+  int const_idx_{0};
+  /*! \brief The index to track the kernel handles. */
+  int kernel_idx_{0};
+  /*! \brief The declaration of the constant arrays and the kernel handles. */
+  std::vector<std::string> static_decl_;
   /*! \brief The name of the the outputs. */
   std::vector<std::pair<std::string, int>> out_;
 };
@@ -294,17 +352,248 @@ class DNNLModuleCodegen : public CSourceModuleCodegenBase {
   std::ostringstream code_stream_;
 };
 
+/*!
+ * \brief Serialize a DNNL function into the JSON graph executed by the DNNL
+ * JSON runtime. The params become input nodes in order and the constants
+ * become const nodes, whose data is passed to the runtime separately.
+ */
+class DNNLJSONSerializer : public ExprVisitor {
+ public:
+  explicit DNNLJSONSerializer(const Function& func) {
+    for (const auto& param : func->params) {
+      node_id_[param.get()] = AddNode("input", param->name_hint(), {}, GetShape(param), {});
+      arg_nodes_.push_back(node_id_[param.get()]);
+    }
+    heads_.push_back(GetNodeId(func->body));
+  }
+
+  /*! \brief Get the JSON graph. */
+  std::string GetJSON() const {
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("nodes", nodes_);
+    writer.WriteObjectKeyValue("arg_nodes", arg_nodes_);
+    writer.WriteObjectKeyValue("heads", heads_);
+    writer.EndObject();
+    return os.str();
+  }
+
+  /*! \brief Get the data of the const nodes in order. */
+  const std::vector<runtime::NDArray>& GetConsts() const { return consts_; }
+
+  void VisitExpr_(const VarNode* node) final {
+    LOG(FATAL) << "Free variable " << node->name_hint() << " in DNNL function";
+  }
+
+  void VisitExpr_(const ConstantNode* cn) final {
+    CHECK(runtime::TypeMatch(cn->data->dtype, kDLFloat, 32))
+        << "Only support float constants";
+    CHECK_EQ(cn->data->ctx.device_type, kDLCPU);
+    node_id_[cn] = AddNode("const", "", {}, GetShape(GetRef<Constant>(cn)), {});
+    consts_.push_back(cn->data);
+  }
+
+  void VisitExpr_(const TupleGetItemNode* node) final {
+    // only the normalized output of batch_norm is used.
+    const auto* call = node->tuple.as<CallNode>();
+    CHECK(call && IsOp(call, "nn.batch_norm") && node->index == 0)
+        << "DNNL only supports the first output of batch_norm";
+    node_id_[node] = GetNodeId(node->tuple);
+  }
+
+  void VisitExpr_(const CallNode* call) final {
+    const auto* op_node = call->op.as<OpNode>();
+    CHECK(op_node) << "DNNL expects calls to primitive operators";
+    std::vector<int> inputs;
+    for (const auto& arg : call->args) {
+      inputs.push_back(GetNodeId(arg));
+    }
+    NodeAttrs attrs;
+    std::vector<int64_t> shape;
+    if (IsOp(call, "nn.conv2d")) {
+      const auto* conv2d_attr = call->attrs.as<Conv2DAttrs>();
+      CHECK(conv2d_attr);
+      CHECK_EQ(conv2d_attr->data_layout, "NCHW");
+      CHECK(conv2d_attr->kernel_layout == "OIHW" || conv2d_attr->kernel_layout == "")
+          << "DNNL only supports OIHW kernels";
+      attrs["strides"] = GetValues(conv2d_attr->strides);
+      attrs["padding"] = GetPadding(conv2d_attr->padding);
+      attrs["dilation"] = GetValues(conv2d_attr->dilation);
+      attrs["groups"] = {static_cast<double>(conv2d_attr->groups)};
+    } else if (IsOp(call, "nn.bias_add")) {
+      const auto* bias_attr = call->attrs.as<BiasAddAttrs>();
+      CHECK(bias_attr);
+      attrs["axis"] = {static_cast<double>(bias_attr->axis)};
+    } else if (IsOp(call, "nn.batch_norm")) {
+      const auto* bn_attr = call->attrs.as<BatchNormAttrs>();
+      CHECK(bn_attr);
+      CHECK_EQ(bn_attr->axis, 1) << "DNNL only supports batch_norm on channels";
+      CHECK(bn_attr->center && bn_attr->scale) << "DNNL expects both gamma and beta";
+      attrs["epsilon"] = {bn_attr->epsilon};
+      shape = GetShape(call->args[0]);
+    } else if (!IsOp(call, "nn.dense") && !IsOp(call, "nn.relu") && !IsOp(call, "add")) {
+      LOG(FATAL) << "Unsupported op: " << op_node->name;
+    }
+    if (shape.empty()) shape = GetShape(GetRef<Call>(call));
+    node_id_[call] = AddNode(op_node->name, "", inputs, shape, attrs);
+  }
+
+ private:
+  using NodeAttrs = std::map<std::string, std::vector<double> >;
+
+  /*! \brief A node of the JSON graph. */
+  struct JSONNode {
+    std::string op;
+    std::string name;
+    std::vector<int> inputs;
+    std::vector<int64_t> shape;
+    NodeAttrs attrs;
+
+    void Save(dmlc::JSONWriter* writer) const {
+      writer->BeginObject();
+      writer->WriteObjectKeyValue("op", op);
+      writer->WriteObjectKeyValue("name", name);
+      writer->WriteObjectKeyValue("inputs", inputs);
+      writer->WriteObjectKeyValue("shape", shape);
+      writer->WriteObjectKeyValue("attrs", attrs);
+      writer->EndObject();
+    }
+  };
+
+  int AddNode(const std::string& op, const std::string& name, const std::vector<int>& inputs,
+              const std::vector<int64_t>& shape, const NodeAttrs& attrs) {
+    nodes_.push_back(JSONNode{op, name, inputs, shape, attrs});
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+
+  int GetNodeId(const Expr& expr) {
+    if (!node_id_.count(expr.get())) {
+      VisitExpr(expr);
+    }
+    CHECK(node_id_.count(expr.get())) << "Unsupported expression in DNNL function";
+    return node_id_.at(expr.get());
+  }
+
+  static bool IsOp(const CallNode* call, const std::string& op_name) {
+    const auto* op_node = call->op.as<OpNode>();
+    return op_node && op_node->name == op_name;
+  }
+
+  static std::vector<int64_t> GetShape(const Expr& expr) {
+    const auto* ttype = expr->checked_type().as<TensorTypeNode>();
+    CHECK(ttype) << "DNNL expects tensor types";
+    CHECK(ttype->dtype == Float(32)) << "DNNL only supports float32";
+    std::vector<int64_t> shape;
+    for (const auto& dim : ttype->shape) {
+      const int64_t* value = as_const_int(dim);
+      CHECK(value) << "DNNL expects static shapes";
+      shape.push_back(*value);
+    }
+    return shape;
+  }
+
+  static std::vector<double> GetValues(const Array<IndexExpr>& values) {
+    std::vector<double> ret;
+    for (const auto& value : values) {
+      const int64_t* v = as_const_int(value);
+      CHECK(v);
+      ret.push_back(static_cast<double>(*v));
+    }
+    return ret;
+  }
+
+  /*! \brief Normalize the padding to (top, left, bottom, right). */
+  static std::vector<double> GetPadding(const Array<IndexExpr>& padding) {
+    std::vector<double> pad = GetValues(padding);
+    if (pad.size() == 1) return {pad[0], pad[0], pad[0], pad[0]};
+    if (pad.size() == 2) return {pad[0], pad[1], pad[0], pad[1]};
+    CHECK_EQ(pad.size(), 4U) << "Invalid padding";
+    return pad;
+  }
+
+  /*! \brief The node id of each visited expression. */
+  std::unordered_map<const Object*, int> node_id_;
+  std::vector<JSONNode> nodes_;
+  std::vector<int> arg_nodes_;
+  std::vector<int> heads_;
+  std::vector<runtime::NDArray> consts_;
+};
+
+/*!
+ * \brief Create one DNNL JSON runtime module for the functions, which
+ * dispatches to the subgraph of each function by its external symbol.
+ */
+runtime::Module CreateDNNLJSONModule(const std::vector<Function>& funcs) {
+  CHECK(!funcs.empty()) << "No function to compile with DNNL";
+  // The strings must outlive the call, as the arguments only point to them.
+  std::vector<std::string> symbols, graph_jsons;
+  std::vector<std::vector<runtime::NDArray> > consts;
+  int num_args = 0;
+  for (const auto& func : funcs) {
+    const auto* name_node =
+        FunctionGetAttr(func, attr::kExternalSymbol).as<tvm::ir::StringImm>();
+    CHECK(name_node != nullptr) << "Fail to retrieve external symbol.";
+    DNNLJSONSerializer serializer(func);
+    symbols.push_back(name_node->value);
+    graph_jsons.push_back(serializer.GetJSON());
+    consts.push_back(serializer.GetConsts());
+    num_args += 3 + static_cast<int>(consts.back().size());
+  }
+
+  const auto* pf = runtime::Registry::Get("module.dnnl_json_module_create");
+  CHECK(pf != nullptr) << "Cannot find DNNL JSON runtime to create the external runtime module";
+  std::vector<TVMValue> values(num_args);
+  std::vector<int> type_codes(num_args);
+  runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+  int idx = 0;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    setter(idx++, symbols[i]);
+    setter(idx++, graph_jsons[i]);
+    setter(idx++, static_cast<int>(consts[i].size()));
+    for (const auto& c : consts[i]) {
+      setter(idx++, c);
+    }
+  }
+  runtime::TVMRetValue rv;
+  pf->CallPacked(runtime::TVMArgs(values.data(), type_codes.data(), num_args), &rv);
+  return rv;
+}
+
 /*!
  * \brief The external compiler/codegen tool. It takes a Relay expression/module and
- * compile it into a runtime module.
+ * compile it into a runtime module. Each function is executed as a graph of DNNL
+ * primitives by the DNNL JSON runtime, all the functions of a module share one
+ * runtime module.
  */
 runtime::Module DNNLCompiler(const ObjectRef& ref) {
+  std::vector<Function> funcs;
+  if (ref->IsInstance<FunctionNode>()) {
+    funcs.push_back(Downcast<Function>(ref));
+  } else if (ref->IsInstance<relay::ModuleNode>()) {
+    relay::Module mod = Downcast<relay::Module>(ref);
+    for (const auto& it : mod->functions) {
+      funcs.push_back(Downcast<Function>(it.second));
+    }
+  } else {
+    LOG(FATAL) << "The input ref is expected to be a Relay function or module";
+  }
+  return CreateDNNLJSONModule(funcs);
+}
+
+/*!
+ * \brief Generate the C source that calls the DNNL kernels per op, which can be
+ * exported and compiled without the DNNL JSON runtime.
+ */
+runtime::Module DNNLCSourceCompiler(const ObjectRef& ref) {
   DNNLModuleCodegen dnnl;
   return dnnl.CreateCSourceModule(ref);
 }
 
 TVM_REGISTER_API("relay.ext.dnnl").set_body_typed(DNNLCompiler);
 
+TVM_REGISTER_API("relay.ext.dnnl_csource").set_body_typed(DNNLCSourceCompiler);
+
 }  // namespace contrib
 }  // namespace relay
 }  // namespace tvm
@@ -25,6 +25,9 @@
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/analysis.h>
+#include <tvm/runtime/device_api.h>
+#include <algorithm>
+#include <limits>
 #include "../../common/arena.h"
 
 namespace tvm {
@@ -44,6 +47,10 @@ struct StorageToken {
   int device_type{0};
   /*! \brief The storage id */
   int64_t storage_id{-1};
+  /*! \brief The step at which the token is allocated. */
+  size_t live_begin{0};
+  /*! \brief The last step at which the token is alive. */
+  size_t live_end{std::numeric_limits<size_t>::max()};
 };
 
 class StorageAllocaBaseVisitor : public ExprVisitor {
@@ -189,6 +196,12 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
 
 class StorageAllocator : public StorageAllocaBaseVisitor {
  public:
+  /*!
+   * \param match_range Scale used for rough size match when reusing
+   *  a freed token, 0 disables the reuse.
+   */
+  explicit StorageAllocator(size_t match_range = 16)
+      : match_range_(match_range) {}
   /*!
    * \return totoal number of bytes allocated
    */
@@ -233,6 +246,46 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     }
     return smap;
   }
+  /*!
+   * \brief Pack all the allocated tokens of each device into one arena.
+   *
+   *  Tokens whose live ranges overlap get disjoint byte ranges.
+   *  Offsets are assigned greedily, largest token first, at the lowest
+   *  aligned offset that does not conflict with an already placed token.
+   *
+   * \return The byte offset of each storage id inside its device arena.
+   */
+  std::vector<int64_t> PackOffsets() const {
+    const size_t align = runtime::kAllocAlignment;
+    std::vector<const StorageToken*> order(data_.begin(), data_.end());
+    std::stable_sort(order.begin(), order.end(),
+                     [](const StorageToken* lhs, const StorageToken* rhs) {
+                       return lhs->max_bytes > rhs->max_bytes;
+                     });
+    std::vector<int64_t> offsets(data_.size(), 0);
+    std::vector<const StorageToken*> placed;
+    for (const StorageToken* tok : order) {
+      // placed tokens alive at the same time, as (offset, end) pairs.
+      std::vector<std::pair<size_t, size_t> > conflict;
+      for (const StorageToken* p : placed) {
+        if (p->device_type == tok->device_type &&
+            p->live_begin <= tok->live_end &&
+            tok->live_begin <= p->live_end) {
+          size_t begin = static_cast<size_t>(offsets[p->storage_id]);
+          conflict.emplace_back(begin, begin + p->max_bytes);
+        }
+      }
+      std::sort(conflict.begin(), conflict.end());
+      size_t offset = 0;
+      for (const auto& c : conflict) {
+        if (offset + tok->max_bytes <= c.first) break;
+        offset = std::max(offset, DivRoundUp(c.second, align) * align);
+      }
+      offsets[tok->storage_id] = static_cast<int64_t>(offset);
+      placed.push_back(tok);
+    }
+    return offsets;
+  }
 
  protected:
   using StorageAllocaBaseVisitor::VisitExpr_;
@@ -249,6 +302,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         // Allocate a new token,
         StorageToken* allocated_tok = Alloc(tok, GetMemorySize(tok));
         allocated_tok->device_type = tok->device_type;
+        // params and constants are filled before the first call runs, so
+        // they are live from the start however late they are first used.
+        allocated_tok->live_begin = 0;
         // ensure it never get de-allocated.
         allocated_tok->ref_counter += 1;
         tokens.push_back(allocated_tok);
@@ -265,6 +321,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         args.push_back(tok);
       }
     }
+    ++step_;
     // create token for the call node.
     CreateToken(op, true);
     // check if there is orphaned output that can be released immediately.
@@ -356,6 +413,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
    */
   StorageToken* Alloc(StorageToken* prototype, size_t size) {
     prototype->max_bytes = size;
+    prototype->live_begin = step_;
     prototype->storage_id = static_cast<int64_t>(data_.size());
     data_.push_back(prototype);
     return prototype;
@@ -368,6 +426,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     CHECK_GE(tok->storage_id, 0);
     CHECK_GE(tok->ref_counter, 0);
     if (tok->ref_counter == 0) {
+      tok->live_end = step_;
       free_.insert({tok->max_bytes, tok});
     }
   }
@@ -376,7 +435,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   // allocator
   common::Arena arena_;
   // scale used for rough match
-  size_t match_range_{16};
+  size_t match_range_;
+  // index of the call being planned, used as the time of liveness.
+  size_t step_{0};
   // free list of storage entry
   std::multimap<size_t, StorageToken*> free_;
   // all the storage resources available
@@ -389,8 +450,36 @@ Map<Expr, Array<IntegerArray> > GraphPlanMemory(const Function& func) {
   return StorageAllocator().Plan(func);
 }
 
+/*!
+ * \brief Plan the byte offset of every tensor inside one arena per device.
+ *
+ *  Every tensor gets its own token so the packing is not limited by the
+ *  size classes of the storage-id reuse. The result maps each expression
+ *  to the offsets of its outputs.
+ */
+Map<Expr, IntegerArray> GraphPlanMemoryOffset(const Function& func) {
+  StorageAllocator allocator(0);
+  Map<Expr, Array<IntegerArray> > smap = allocator.Plan(func);
+  std::vector<int64_t> offsets = allocator.PackOffsets();
+  Map<Expr, IntegerArray> ret;
+  for (const auto& kv : smap) {
+    std::vector<Integer> expr_offsets;
+    for (const Integer& sid : kv.second[0]) {
+      int64_t offset = offsets[sid->value];
+      CHECK_LE(offset, std::numeric_limits<int>::max())
+          << "Arena offset exceeds the range of int32";
+      expr_offsets.push_back(static_cast<int>(offset));
+    }
+    ret.Set(kv.first, IntegerArray(expr_offsets));
+  }
+  return ret;
+}
+
 TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory")
 .set_body_typed<Map<Expr, Array<IntegerArray> >(const Function&)>(GraphPlanMemory);
 
+TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemoryOffset")
+.set_body_typed<Map<Expr, IntegerArray>(const Function&)>(GraphPlanMemoryOffset);
+
 }  // namespace relay
 }  // namespace tvm
@@ -202,6 +202,8 @@ class GraphRuntimeCodegen
   LoweredOutput Codegen(relay::Function func) {
     auto pf = GetPackedFunc("relay.backend.GraphPlanMemory");
     storage_device_map_ = (*pf)(func);
+    auto pf_offset = GetPackedFunc("relay.backend.GraphPlanMemoryOffset");
+    storage_offset_map_ = (*pf_offset)(func);
     // First we convert all the parameters into input nodes.
     for (auto param : func->params) {
       auto node_ptr = GraphInputNode::make_node_ptr(param->name_hint(), GraphAttrs());
@@ -267,6 +269,13 @@ class GraphRuntimeCodegen
       storage_info.push_back(v->value);
     }
     node->attrs_["storage_id"] = std::move(storage_info);
+    // byte offset inside the per device arena
+    CHECK(storage_offset_map_.count(expr)) << "Expr is not existing in arena plan";
+    std::vector<int64_t> storage_offset;
+    for (auto& v : storage_offset_map_[expr]) {
+      storage_offset.push_back(v->value);
+    }
+    node->attrs_["storage_offset"] = std::move(storage_offset);
     // type
     std::vector<int64_t> device_types;
     for (auto& v : storage_device_info[1]) {
@@ -529,6 +538,7 @@ class GraphRuntimeCodegen
     size_t num_entry = 0;
     ShapeVector shapes;
     std::vector<size_t> storage_ids;
+    std::vector<size_t> storage_offsets;
     std::vector<size_t> device_types;
     std::vector<std::string> dltypes;
     std::vector<size_t> node_row_ptr{0};
@@ -543,6 +553,9 @@ class GraphRuntimeCodegen
       shapes.insert(shapes.end(), shape_vec.begin(), shape_vec.end());
       dltypes.insert(dltypes.end(), dtype_vec.begin(), dtype_vec.end());
       storage_ids.insert(storage_ids.end(), storage_id.begin(), storage_id.end());
+      const auto& storage_offset =
+          dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+      storage_offsets.insert(storage_offsets.end(), storage_offset.begin(), storage_offset.end());
       if (node->attrs_.count("device_index")) {
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
         device_types.insert(device_types.end(), dev_types.begin(), dev_types.end());
@@ -558,6 +571,8 @@ class GraphRuntimeCodegen
     attrs["shape"].emplace_back(shapes);
     attrs["storage_id"].emplace_back(std::string("list_int"));
     attrs["storage_id"].emplace_back(storage_ids);
+    attrs["storage_offset"].emplace_back(std::string("list_int"));
+    attrs["storage_offset"].emplace_back(storage_offsets);
     if (device_types.size()) {
       attrs["device_index"].emplace_back(std::string("list_int"));
       attrs["device_index"].emplace_back(device_types);
@@ -600,6 +615,8 @@ class GraphRuntimeCodegen
   std::unordered_map<std::string, runtime::NDArray> params_;
   /*! \brief plan memory of device result */
   Map<Expr, Array<IntegerArray>> storage_device_map_;
+  /*! \brief byte offset of each result in the arena plan */
+  Map<Expr, IntegerArray> storage_offset_map_;
   /*! \brief lowered funcs */
   std::unordered_map<std::string, std::unordered_set<LoweredFunc, ObjectHash, ObjectEqual>>
       lowered_funcs_;
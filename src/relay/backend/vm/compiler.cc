@@ -509,6 +509,11 @@ class VMFunctionCompiler : ExprFunctor<void(const Expr& expr)> {
       } else {
         op_index = context_->seen_funcs[cfunc->funcs[0]];
       }
+      // Remember kernels with dynamic shapes so that the VM
+      // can specialize them for the shapes it sees at runtime.
+      if (IsDynamic(func->checked_type()) && !context_->dynamic_funcs.count(op_index)) {
+        context_->dynamic_funcs[op_index] = std::make_pair(func, target);
+      }
     }
 
     Emit(Instruction::InvokePacked(op_index,
@@ -945,6 +950,46 @@ Module VMCompiler::OptimizeModule(const Module& mod, const TargetsMap& targets)
   return seq(mod);
 }
 
+/*!
+ * \brief Create the specializer of a primitive function with dynamic shapes.
+ *
+ *  The specializer is called with the input and output tensors of the
+ *  primitive, binds every parameter to the concrete shape of its input and
+ *  JIT-compiles the resulting static function. It returns nothing when the
+ *  primitive cannot be specialized.
+ *
+ * \param func The primitive function.
+ * \param target The target to compile the kernel for.
+ * \return The specializer.
+ */
+PackedFunc MakeKernelSpecializer(const Function& func, const Target& target) {
+  return PackedFunc([func, target](TVMArgs args, TVMRetValue* rv) {
+    CHECK_GE(static_cast<size_t>(args.size()), func->params.size());
+    Array<Var> params;
+    tvm::Map<Var, Expr> bind_map;
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      const auto* ttype = func->params[i]->checked_type().as<TensorTypeNode>();
+      // tuple parameters are flattened by the VM, do not specialize them.
+      if (ttype == nullptr) return;
+      NDArray arg = args[i];
+      Array<IndexExpr> shape;
+      for (int64_t dim : arg.Shape()) {
+        shape.push_back(make_const(DataType::Int(32), dim));
+      }
+      Var param = VarNode::make(func->params[i]->name_hint(),
+                                TensorTypeNode::make(shape, ttype->dtype));
+      params.push_back(param);
+      bind_map.Set(func->params[i], param);
+    }
+    Function specialized = FunctionNode::make(
+        params, Bind(func->body, bind_map), Type(), {}, func->attrs);
+    auto mod = ModuleNode::FromExpr(specialized);
+    mod = transform::InferType()(mod);
+    specialized = Downcast<Function>(mod->Lookup("main"));
+    *rv = CompileEngine::Global()->JIT(CCacheKeyNode::make(specialized, target));
+  });
+}
+
 void VMCompiler::PopulateGlobalMap() {
   // First we populate global map.
   size_t global_index = 0;
@@ -1000,6 +1045,10 @@ void VMCompiler::LibraryCodegen() {
       exec_->primitive_map.insert({cfunc->funcs[0]->name, primitive_index++});
     }
   }
+  for (const auto& it : context_.dynamic_funcs) {
+    exec_->kernel_specializers[it.first] =
+        MakeKernelSpecializer(it.second.first, it.second.second);
+  }
 }
 
 runtime::Module CreateVMCompiler() {
@@ -77,6 +77,8 @@ struct VMCompilerContext {
   std::vector<CachedFunc> cached_funcs;
   // The functions that have been lowered.
   std::unordered_map<LoweredFunc, size_t, ObjectHash, ObjectEqual> seen_funcs;
+  // Primitive functions with dynamic shapes and their targets, keyed by op index
+  std::unordered_map<Index, std::pair<Function, Target>> dynamic_funcs;
 };
 
 
@@ -595,6 +595,13 @@ bool AlphaEqual(const Type& lhs, const Type& rhs) {
 }
 
 bool AlphaEqual(const Expr& lhs, const Expr& rhs) {
+  if (lhs.same_as(rhs)) return true;
+  // fast reject when both structural hashes are already known.
+  if (lhs.defined() && rhs.defined()) {
+    size_t lhs_hash = lhs->structural_hash_.value;
+    size_t rhs_hash = rhs->structural_hash_.value;
+    if (lhs_hash != 0 && rhs_hash != 0 && lhs_hash != rhs_hash) return false;
+  }
   return AlphaEqualHandler(false, false).ExprEqual(lhs, rhs);
 }
 
@@ -280,9 +280,13 @@ class RelayHashHandler:
       hash = Combine(hash, ExprHash(arg));
     }
 
-    for (auto t : call->type_args) {
-      CHECK(t.defined());
-      hash = Combine(hash, TypeHash(t));
+    // type_args of primitive ops are ignored by AlphaEqual,
+    // keep the hash consistent with it.
+    if (!IsPrimitiveOp(call->op)) {
+      for (auto t : call->type_args) {
+        CHECK(t.defined());
+        hash = Combine(hash, TypeHash(t));
+      }
     }
 
     hash = Combine(hash, AttrHash(call->attrs));
@@ -425,11 +429,23 @@ size_t StructuralHash::operator()(const Type& type) const {
 }
 
 size_t StructuralHash::operator()(const Expr& expr) const {
-  return RelayHashHandler().ExprHash(expr);
+  if (!expr.defined()) {
+    return RelayHashHandler().ExprHash(expr);
+  }
+  // The hash of a subexpression depends on the binding context it is
+  // visited in, so only the hash of the root expression is cached.
+  size_t& cached = expr->structural_hash_.value;
+  if (cached == 0) {
+    cached = RelayHashHandler().ExprHash(expr);
+  }
+  return cached;
 }
 
 TVM_REGISTER_API("relay._analysis._expr_hash")
 .set_body_typed<int64_t(ObjectRef)>([](ObjectRef ref) {
+  if (ref.defined() && ref->IsInstance<ExprNode>()) {
+    return static_cast<int64_t>(StructuralHash()(Downcast<Expr>(ref)));
+  }
   return static_cast<int64_t>(RelayHashHandler().Hash(ref));
 });
 
@@ -159,5 +159,86 @@ RELAY_REGISTER_CMP_OP("greater_equal")
 .set_support_level(4)
 .set_attr<FTVMCompute>("FTVMCompute", RELAY_BINARY_COMPUTE(topi::greater_equal));
 
+
+// relay.fixed_point_multiply
+bool FixedPointMultiplyRel(const Array<Type>& types,
+                           int num_inputs,
+                           const Attrs& attrs,
+                           const TypeReporter& reporter) {
+  CHECK_EQ(types.size(), 4);
+  const auto* data = types[0].as<TensorTypeNode>();
+  if (data == nullptr) return false;
+  CHECK(data->dtype == DataType::Int(32))
+      << "fixed_point_multiply expects int32 data, but got " << data->dtype;
+  for (size_t i = 1; i < 3; ++i) {
+    const auto* param = types[i].as<TensorTypeNode>();
+    if (param == nullptr) return false;
+    CHECK(param->dtype == DataType::Int(32))
+        << "fixed_point_multiply expects int32 multiplier and shift, but got " << param->dtype;
+    CHECK_LE(param->shape.size(), data->shape.size())
+        << "The multiplier and the shift must broadcast to the data";
+    size_t offset = data->shape.size() - param->shape.size();
+    for (size_t j = 0; j < param->shape.size(); ++j) {
+      const int64_t* dim = as_const_int(param->shape[j]);
+      CHECK((dim != nullptr && *dim == 1) ||
+            reporter->AssertEQ(param->shape[j], data->shape[offset + j]))
+          << "The multiplier and the shift must broadcast to the data";
+    }
+  }
+  reporter->Assign(types[3], TensorTypeNode::make(data->shape, data->dtype));
+  return true;
+}
+
+Array<Array<Layout> > FixedPointMultiplyLayout(const Attrs& attrs,
+                                               const Array<Layout>& new_in_layouts,
+                                               const Array<Layout>& old_in_layouts,
+                                               const Array<Array<IndexExpr>>& old_in_shapes) {
+  // The multiplier and the shift each follow the data like the rhs of a binary broadcast.
+  auto pair = [](const Array<Layout>& layouts, size_t i) {
+    return layouts.defined() ? Array<Layout>{layouts[0], layouts[i]} : layouts;
+  };
+  Array<Layout> in_layouts;
+  Array<Layout> out_layouts;
+  for (size_t i = 1; i < 3; ++i) {
+    auto inferred = BinaryBroadcastLayout(attrs, pair(new_in_layouts, i),
+                                          pair(old_in_layouts, i),
+                                          {old_in_shapes[0], old_in_shapes[i]});
+    if (inferred[0].size() != 2 || !inferred[1][0].defined()) {
+      return Array<Array<Layout> >{{Layout::Undef(), Layout::Undef(), Layout::Undef()},
+                                   {Layout::Undef()}};
+    }
+    if (i == 1) in_layouts.push_back(inferred[0][0]);
+    in_layouts.push_back(inferred[0][1]);
+    out_layouts = inferred[1];
+  }
+  return Array<Array<Layout> >{in_layouts, out_layouts};
+}
+
+Expr MakeFixedPointMultiply(Expr data, Expr multiplier, Expr shift) {
+  static const Op& op = Op::Get("fixed_point_multiply");
+  return CallNode::make(op, {data, multiplier, shift}, Attrs(), {});
+}
+
+TVM_REGISTER_API("relay.op._make.fixed_point_multiply")
+.set_body_typed(MakeFixedPointMultiply);
+
+RELAY_REGISTER_OP("fixed_point_multiply")
+.describe(R"code(Multiply an int32 tensor by fixed point numbers.
+
+Computes round(data * multiplier * 2^(-31 - shift)) elementwise with ties
+rounded towards +inf, where `multiplier` holds Q31 numbers and `shift` right
+shifts (negative values shift left). Both are int32 and broadcast to `data`,
+so a per-channel scale is a tensor of shape (1, C, 1, 1) for NCHW data.
+)code" TVM_ADD_FILELINE)
+.set_num_inputs(3)
+.add_argument("data", "Tensor", "The int32 input tensor.")
+.add_argument("multiplier", "Tensor", "The Q31 multipliers.")
+.add_argument("shift", "Tensor", "The right shifts.")
+.add_type_rel("FixedPointMultiply", FixedPointMultiplyRel)
+.set_attr<TOpPattern>("TOpPattern", kBroadcast)
+.set_attr<TOpIsStateful>("TOpIsStateful", false)
+.set_attr<FInferCorrectLayout>("FInferCorrectLayout", FixedPointMultiplyLayout)
+.set_support_level(10);
+
 }  // namespace relay
 }  // namespace tvm
@@ -54,11 +54,16 @@ class CommonSubexprEliminator : public ExprMutator {
       return new_expr;
     }
 
-    auto it = expr_map_.find(new_call->op);
+    // candidates are bucketed by a hash consistent with the
+    // equivalence check, so the lookup does not scan every call of the op.
+    size_t key = CallHash(new_call);
+    auto it = expr_map_.find(key);
     if (it != expr_map_.end()) {
       for (const CallNode* candidate : it->second) {
         bool is_equivalent = true;
-        if (!attrs_equal(new_call->attrs, candidate->attrs)) {
+        if (!new_call->op.same_as(candidate->op) ||
+            new_call->args.size() != candidate->args.size() ||
+            !attrs_equal(new_call->attrs, candidate->attrs)) {
           continue;
         }
         for (size_t i = 0; i < new_call->args.size(); i++) {
@@ -72,11 +77,27 @@ class CommonSubexprEliminator : public ExprMutator {
         return GetRef<Call>(candidate);
       }
     }
-    expr_map_[new_call->op].push_back(new_call);
+    expr_map_[key].push_back(new_call);
     return new_expr;
   }
 
-  std::unordered_map<Expr, std::vector<const CallNode*>, ObjectHash, ObjectEqual> expr_map_;
+  // Arguments are hashed by identity, except scalar constants which
+  // are compared by value.
+  size_t CallHash(const CallNode* call) {
+    size_t hash = ObjectHash()(call->op);
+    hash = dmlc::HashCombine(hash, AttrsHash()(call->attrs));
+    for (const Expr& arg : call->args) {
+      const auto* constant = arg.as<ConstantNode>();
+      if (constant != nullptr && constant->is_scalar()) {
+        hash = dmlc::HashCombine(hash, StructuralHash()(arg));
+      } else {
+        hash = dmlc::HashCombine(hash, ObjectHash()(arg));
+      }
+    }
+    return hash;
+  }
+
+  std::unordered_map<size_t, std::vector<const CallNode*> > expr_map_;
   runtime::TypedPackedFunc<bool(Expr)> fskip_;
 };
 
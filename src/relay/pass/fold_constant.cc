@@ -19,6 +19,16 @@
 
 /*!
  * \file constant_folding.cc
+ *
+ * \brief Fold constant subexpressions.
+ *
+ * Folding happens in two steps. The mutator first marks every call whose
+ * arguments are constants or other foldable calls as pending, without
+ * evaluating it. The maximal pending regions are then gathered into one
+ * tuple and evaluated together by a single interpreter run, so lowering,
+ * fusion and type inference happen once per pass instead of once per
+ * constant. Kernels are compiled through the global CompileEngine, whose
+ * cache is shared across invocations of the pass.
  */
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
@@ -87,9 +97,18 @@ class ConstantFolder : public ExprMutator {
         alloc_storage_op_(Op::Get("memory.alloc_storage")),
         cast_op_(Op::Get("cast")) {}
 
+  // Fold all constant subexpressions of expr.
+  Expr Fold(const Expr& expr) {
+    Expr res = this->Mutate(expr);
+    if (pending_.empty()) return res;
+    Array<Expr> roots = PendingRootCollector(pending_).Collect(res);
+    if (roots.size() == 0) return res;
+    return ConstantSubstitutor(roots, BatchEvaluate(roots)).Mutate(res);
+  }
+
   Expr VisitExpr_(const LetNode* op) final {
     Expr value = this->Mutate(op->value);
-    if (value.as<ConstantNode>()) {
+    if (value.as<ConstantNode>() || pending_.count(value)) {
       memo_[op->var] = value;
       return this->Mutate(op->body);
     } else {
@@ -139,15 +158,14 @@ class ConstantFolder : public ExprMutator {
 
     bool all_const_args = true;
     for (Expr arg : call->args) {
-      if (!checker_.Check(arg)) {
+      if (!IsConstOrPending(arg)) {
         all_const_args = false;
       }
     }
     if (all_const_args) {
-      return ConstEvaluate(res);
-    } else {
-      return res;
+      pending_.insert(res);
     }
+    return res;
   }
 
   Expr VisitExpr_(const TupleGetItemNode* op) final {
@@ -155,9 +173,10 @@ class ConstantFolder : public ExprMutator {
     op = res.as<TupleGetItemNode>();
     if (const auto* tuple = op->tuple.as<TupleNode>()) {
       return tuple->fields[op->index];
-    } else {
-      return res;
+    } else if (pending_.count(op->tuple)) {
+      pending_.insert(res);
     }
+    return res;
   }
 
  private:
@@ -167,6 +186,8 @@ class ConstantFolder : public ExprMutator {
   ConstantChecker checker_;
   // Module
   Module module_;
+  // Calls (and projections of them) that are foldable but not yet evaluated.
+  std::unordered_set<Expr, ObjectHash, ObjectEqual> pending_;
 
   // Cache the following ops for equivalence checking in this pass.
   const Op& shape_of_op_;
@@ -195,17 +216,64 @@ class ConstantFolder : public ExprMutator {
       return Expr();
     }
   }
-  // Constant evaluate a expression.
-  Expr ConstEvaluate(Expr expr) {
-    std::vector<transform::Pass> passes = {transform::FuseOps(0),
-                                           transform::InferType()};
-    Function func;
-    if (expr.as<FunctionNode>()) {
-      func = Downcast<Function>(expr);
-    } else {
-      // TODO(@jroesch): fix this
-      func = FunctionNode::make(FreeVars(expr), expr, Type(), FreeTypeVars(expr, module_), {});
+  // Whether expr is a constant, a pending call, or a tuple of those.
+  bool IsConstOrPending(const Expr& expr) {
+    if (pending_.count(expr)) return true;
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const auto& field : tuple->fields) {
+        if (!IsConstOrPending(field)) return false;
+      }
+      return true;
+    }
+    return checker_.Check(expr);
+  }
+
+  // Collect the outermost pending expressions, in post-order.
+  class PendingRootCollector : private ExprVisitor {
+   public:
+    explicit PendingRootCollector(
+        const std::unordered_set<Expr, ObjectHash, ObjectEqual>& pending)
+        : pending_(pending) {}
+
+    Array<Expr> Collect(const Expr& expr) {
+      this->VisitExpr(expr);
+      return roots_;
+    }
+
+   private:
+    void VisitExpr(const Expr& expr) final {
+      if (pending_.count(expr)) {
+        if (seen_.insert(expr).second) roots_.push_back(expr);
+        return;
+      }
+      ExprVisitor::VisitExpr(expr);
     }
+
+    const std::unordered_set<Expr, ObjectHash, ObjectEqual>& pending_;
+    std::unordered_set<Expr, ObjectHash, ObjectEqual> seen_;
+    Array<Expr> roots_;
+  };
+
+  // Replace each evaluated root by its folded value.
+  class ConstantSubstitutor : public ExprMutator {
+   public:
+    ConstantSubstitutor(const Array<Expr>& roots, const Array<Expr>& values) {
+      CHECK_EQ(roots.size(), values.size());
+      for (size_t i = 0; i < roots.size(); ++i) {
+        memo_[roots[i]] = values[i];
+      }
+    }
+  };
+
+  // Evaluate a batch of closed expressions with a single interpreter run.
+  Array<Expr> BatchEvaluate(const Array<Expr>& exprs) {
+    // ToANormalForm makes subexpressions shared between roots evaluate once.
+    std::vector<transform::Pass> passes = {transform::FuseOps(0),
+                                           transform::InferType(),
+                                           transform::ToANormalForm()};
+    Expr batch = TupleNode::make(exprs);
+    Function func = FunctionNode::make(
+        {}, batch, Type(), FreeTypeVars(batch, module_), {});
     auto mod = ModuleNode::make(
       {},
       module_->type_definitions,
@@ -214,9 +282,15 @@ class ConstantFolder : public ExprMutator {
     mod->Add(global, func);
     auto seq = transform::Sequential(passes);
     mod = seq(mod);
-    auto entry_func = mod->Lookup("main");
-    expr = expr.as<FunctionNode>() == nullptr ? entry_func->body : entry_func;
-    return ValueToExpr(executor_(expr));
+    Value value = executor_(mod->Lookup("main")->body);
+    const auto* tuple = value.as<TupleValueNode>();
+    CHECK(tuple != nullptr);
+    CHECK_EQ(tuple->fields.size(), exprs.size());
+    Array<Expr> results;
+    for (Value field : tuple->fields) {
+      results.push_back(ValueToExpr(field));
+    }
+    return results;
   }
 
   // Evaluate a call to the shape_of operator for tensors with constant
@@ -269,7 +343,8 @@ class ConstantFolder : public ExprMutator {
     auto cast_attrs = make_object<CastAttrs>();
     cast_attrs->dtype = param->dtype;
     Expr ret = CallNode::make(cast_op_, { shape }, Attrs(cast_attrs), {});
-    return ConstEvaluate(ret);
+    pending_.insert(ret);
+    return ret;
   }
 };
 
@@ -284,7 +359,7 @@ Expr FoldConstant(const Expr& expr, const Module& mod) {
   With<BuildConfig> fresh_build_ctx(BuildConfig::Create());
 
   return ConstantFolder(CreateInterpreter(
-      mod, ctx, target), mod).Mutate(expr);
+      mod, ctx, target), mod).Fold(expr);
 }
 
 namespace transform {
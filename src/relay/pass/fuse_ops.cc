@@ -24,6 +24,7 @@
  * \brief This is a backend-aware optimization pass.
  *   Fuse necessary ops into a single one.
  */
+#include <tvm/build_module.h>
 #include <tvm/expr_operator.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
@@ -72,12 +73,56 @@ namespace relay {
       will still run correctly.
   - CommitFuse: mark all the nodes between source and post-dominator as the same group.
   - We use an Union-Find data structure to manage the groups.
+
+  Cost model guided fusion:
+
+  By default every candidate that passes CheckPath is fused. When the
+  PassContext carries a fusion cost model, each candidate is summarized into
+  a few features (bytes of intermediates that no longer need to be
+  materialized, estimated flops, number of new group inputs) and the cost
+  model decides whether to fuse. The cost model is also offered relaxed
+  candidates the greedy rules never fuse, such as an injective chain into a
+  reduction, so memory-bound chains can be fused more aggressively.
 */
 using common::LinkNode;
 using common::LinkedList;
 
 constexpr uint32_t kMaxFusedOps = 256;
 
+/*!
+ * \brief The default fusion cost model.
+ *
+ *  On CPU, fusion is refused when the candidate brings in more input
+ *  streams than there are vector registers while saving less than an L1
+ *  cache worth of memory traffic. Relaxed candidates are fused on CPU once
+ *  the intermediate they remove no longer fits in the L2 cache.
+ *
+ * \param features The features of the fusion candidate.
+ * \return Whether to fuse.
+ */
+bool DefaultFusionCostModel(Map<std::string, Integer> features) {
+  constexpr int64_t kL1CacheBytes = 32 << 10;
+  constexpr int64_t kL2CacheBytes = 256 << 10;
+  Target target = Target::Current(true);
+  bool is_cpu = !target.defined() || target->device_type == kDLCPU;
+  int64_t bytes_saved = features["bytes_saved"]->value;
+  int64_t num_inputs = features["num_inputs"]->value;
+  bool relaxed = features["relaxed"]->value != 0;
+  if (!is_cpu) return !relaxed;
+
+  int64_t num_vector_registers = 16;
+  if (target.defined()) {
+    if (target->device_name == "arm_cpu") num_vector_registers = 32;
+    for (const std::string& opt : target->options()) {
+      if (opt.find("avx512") != std::string::npos) num_vector_registers = 32;
+    }
+  }
+  if (relaxed) {
+    return bytes_saved >= kL2CacheBytes && num_inputs <= num_vector_registers;
+  }
+  return num_inputs <= num_vector_registers || bytes_saved >= kL1CacheBytes;
+}
+
 static const Op& stop_fusion_op = Op::Get("annotation.stop_fusion");
 
 /*!
@@ -512,8 +557,9 @@ DominatorTree DominatorTree::PostDom(common::Arena* arena,
  */
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(common::Arena* arena, int opt_level)
-      : arena_(arena), opt_level_(opt_level) {}
+  explicit GraphPartitioner(common::Arena* arena, int opt_level,
+                            PackedFunc cost_model = nullptr)
+      : arena_(arena), opt_level_(opt_level), cost_model_(cost_model) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -565,6 +611,8 @@ class GraphPartitioner {
   common::Arena* arena_;
   /*! \brief optimization level for fuse operation. */
   int opt_level_;
+  /*! \brief The fusion cost model, greedy fusion if not set. */
+  PackedFunc cost_model_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -668,6 +716,128 @@ class GraphPartitioner {
     CommitFuse_(src, sink, target);
   }
 
+  // Number of elements of a tensor type, 0 if unknown.
+  static int64_t NumElements(const Type& type) {
+    const auto* ttype = type.as<TensorTypeNode>();
+    if (ttype == nullptr) return 0;
+    int64_t elements = 1;
+    for (const auto& dim : ttype->shape) {
+      const auto* extent = dim.as<IntImm>();
+      if (extent == nullptr) return 0;
+      elements *= extent->value;
+    }
+    return elements;
+  }
+  // Number of bytes of the tensor produced by a node, 0 if unknown.
+  static int64_t OutputBytes(const IndexedForwardGraph::Node* node) {
+    if (!node->ref->IsInstance<ExprNode>()) return 0;
+    const auto* expr = static_cast<const ExprNode*>(node->ref);
+    if (!expr->checked_type_.defined()) return 0;
+    const auto* ttype = expr->checked_type_.as<TensorTypeNode>();
+    if (ttype == nullptr) return 0;
+    return (ttype->dtype.bits() * ttype->dtype.lanes() + 7) / 8 * NumElements(expr->checked_type_);
+  }
+  /*!
+   * \brief Estimate the arithmetic operations of a node, 0 if unknown.
+   *  Elementwise and broadcast ops do one operation per output element,
+   *  reductions one per input element, and injective ops only move data.
+   */
+  static int64_t EstimateFlops(const IndexedForwardGraph::Node* node) {
+    const auto* call = node->ref->IsInstance<CallNode>() ?
+        static_cast<const CallNode*>(node->ref) : nullptr;
+    if (call == nullptr || !call->checked_type_.defined()) return 0;
+    switch (node->pattern) {
+      case kElemWise:
+      case kBroadcast:
+        return NumElements(call->checked_type_);
+      case kCommReduce: {
+        int64_t flops = 0;
+        for (const Expr& arg : call->args) {
+          if (arg->checked_type_.defined()) flops += NumElements(arg->checked_type_);
+        }
+        return flops;
+      }
+      default:
+        return 0;
+    }
+  }
+  // Internal implementation of CollectPath
+  void CollectPath_(IndexedForwardGraph::Node* src,
+                    IndexedForwardGraph::Node* sink,
+                    std::vector<IndexedForwardGraph::Node*>* path) {
+    if (src == sink) return;
+    if (visited_.count(src)) return;
+    visited_.insert(src);
+    path->push_back(src);
+    for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+      CollectPath_(link->value.node, sink, path);
+    }
+  }
+  /*!
+   * \brief Ask the cost model whether to fuse src into its post-dominator sink.
+   * \param graph The graph.
+   * \param src The source node.
+   * \param sink The termination node.
+   * \param relaxed Whether the candidate is beyond the greedy fusion rules.
+   * \return Whether to fuse.
+   */
+  bool ShouldFuse(const IndexedForwardGraph& graph,
+                  IndexedForwardGraph::Node* src,
+                  IndexedForwardGraph::Node* sink,
+                  bool relaxed) {
+    if (cost_model_ == nullptr) return !relaxed;
+    std::vector<IndexedForwardGraph::Node*> path;
+    visited_.clear();
+    CollectPath_(src, sink, &path);
+    Group* sink_group = groups_[sink->index]->FindRoot();
+    int64_t bytes_saved = 0, flops = 0;
+    std::unordered_set<const Object*> inputs;
+    for (auto* node : path) {
+      int64_t bytes = OutputBytes(node);
+      // the intermediate is neither written nor read back.
+      bytes_saved += 2 * bytes;
+      flops += EstimateFlops(node);
+      const auto* call = node->ref->IsInstance<CallNode>() ?
+          static_cast<const CallNode*>(node->ref) : nullptr;
+      if (call == nullptr) continue;
+      Group* node_group = groups_[node->index]->FindRoot();
+      for (const Expr& arg : call->args) {
+        auto it = graph.node_map.find(arg.get());
+        if (it == graph.node_map.end()) continue;
+        if (visited_.count(it->second)) continue;
+        Group* arg_group = groups_[it->second->index]->FindRoot();
+        if (arg_group == sink_group || arg_group == node_group) continue;
+        inputs.insert(arg.get());
+      }
+    }
+    Map<std::string, Integer> features;
+    features.Set("src_pattern", static_cast<int>(src->pattern));
+    features.Set("sink_pattern", static_cast<int>(sink_group->pattern));
+    features.Set("num_nodes", static_cast<int>(sink_group->num_nodes + path.size()));
+    features.Set("num_inputs", static_cast<int>(inputs.size()));
+    features.Set("bytes_saved", IntImm::make(DataType::Int(64), bytes_saved));
+    features.Set("flops", IntImm::make(DataType::Int(64), flops));
+    features.Set("relaxed", static_cast<int>(relaxed));
+    bool fuse = cost_model_(features);
+    return fuse;
+  }
+  /*!
+   * \brief Fuse src into sink if the path satisfies fcond
+   *  and the cost model, if any, agrees.
+   */
+  template<typename F>
+  void TryFuse(const IndexedForwardGraph& graph,
+               IndexedForwardGraph::Node* src,
+               IndexedForwardGraph::Node* sink,
+               F fcond,
+               bool relaxed = false) {
+    if (!CheckPath(src, sink, fcond)) return;
+    if (cost_model_ != nullptr || relaxed) {
+      if (!ShouldFuse(graph, src, sink, relaxed)) return;
+    }
+    CommitFuse(src, sink);
+  }
+
   // Initialize the groups.
   void InitGroups(const IndexedForwardGraph& graph) {
     groups_.resize(graph.post_dfs_order.size());
@@ -719,9 +889,7 @@ class GraphPartitioner {
           };
           // dom_root_group can also be tuple, as in inception layers
           // CheckPath is needed to avoid fusing two intermediate tuples
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph, graph_node, dom_node->parent->gnode, fcond);
         }
         continue;
       }
@@ -744,9 +912,7 @@ class GraphPartitioner {
           auto fcond = [](OpPatternKind kind, bool is_sink) {
             return kind <= kBroadcast;
           };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph, graph_node, dom_node->parent->gnode, fcond);
         }
       } else if (group_node->pattern <= kBroadcast) {
         // Pre-condition: can only be fused to parent which is injective or reduction.
@@ -767,21 +933,29 @@ class GraphPartitioner {
                       kind == kOutEWiseFusable);
             }
           };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph, graph_node, dom_node->parent->gnode, fcond);
         }
       } else if (group_node->pattern == kInjective || group_node->pattern == kTuple) {
         // defer injective fusion to second phase.
         // so conv2d always finishes fusing.
         if (phase != 1) continue;
+        Group* dom_root_group = groups_[dom_parent_gindex]->FindRoot();
+        if (cost_model_ != nullptr &&
+            group_node->pattern == kInjective &&
+            dom_root_group->pattern == kCommReduce) {
+          // Relaxed candidate: let the cost model decide whether the
+          // injective chain is worth fusing into the reduction.
+          auto fcond = [](OpPatternKind kind, bool is_sink) {
+            return kind <= kInjective || (is_sink && kind == kCommReduce);
+          };
+          TryFuse(graph, graph_node, dom_node->parent->gnode, fcond, true);
+          continue;
+        }
         // Check if all path are injective.
         auto fcond = [](OpPatternKind kind, bool is_sink) {
           return kind <= kInjective;
         };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-          CommitFuse(graph_node, dom_node->parent->gnode);
-        }
+        TryFuse(graph, graph_node, dom_node->parent->gnode, fcond);
       } else {
         // do nothing.
         CHECK(group_node->pattern == kCommReduce);
@@ -806,10 +980,10 @@ GraphPartitioner::Partition(const IndexedForwardGraph& graph) {
 class FuseMutator : private ExprMutator {
  public:
   // Run the transform
-  Expr Transform(const Expr& body, int fuse_opt_level) {
+  Expr Transform(const Expr& body, int fuse_opt_level, PackedFunc cost_model) {
     // setup the group map.
     auto graph = IndexedForwardGraph::Create(&arena_, body);
-    auto groups = GraphPartitioner(&arena_, fuse_opt_level).Partition(
+    auto groups = GraphPartitioner(&arena_, fuse_opt_level, cost_model).Partition(
         graph);
     for (size_t nid = 0; nid < graph.post_dfs_order.size(); ++nid) {
       CHECK(graph.post_dfs_order[nid]->ref != nullptr);
@@ -969,8 +1143,9 @@ class FuseMutator : private ExprMutator {
   }
 };
 
-Expr FuseOps(const Expr& expr, int fuse_opt_level, const Module& module) {
-  return FuseMutator().Transform(expr, fuse_opt_level);
+Expr FuseOps(const Expr& expr, int fuse_opt_level, const Module& module,
+            PackedFunc cost_model) {
+  return FuseMutator().Transform(expr, fuse_opt_level, cost_model);
 }
 
 namespace transform {
@@ -979,7 +1154,7 @@ Pass FuseOps(int fuse_opt_level) {
   runtime::TypedPackedFunc<Function(Function, Module, PassContext)> pass_func =
     [=](Function f, Module m, PassContext pc) {
     int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
-    return Downcast<Function>(FuseOps(f, opt_level, m));
+    return Downcast<Function>(FuseOps(f, opt_level, m, pc->fusion_cost_model));
   };
   return CreateFunctionPass(pass_func, 1, "FuseOps",
                             {ir::StringImm::make("InferType")});
@@ -988,6 +1163,9 @@ Pass FuseOps(int fuse_opt_level) {
 TVM_REGISTER_API("relay._transform.FuseOps")
 .set_body_typed(FuseOps);
 
+TVM_REGISTER_API("relay._transform.DefaultFusionCostModel")
+.set_body_typed(DefaultFusionCostModel);
+
 }  // namespace transform
 
 }  // namespace relay
@@ -535,10 +535,12 @@ TVM_REGISTER_API("relay._transform.PassContext")
   int fallback_device = args[1];
   tvm::Array<tvm::Expr> required = args[2];
   tvm::Array<tvm::Expr> disabled = args[3];
+  PackedFunc fusion_cost_model = args[4];
   pctx->opt_level = opt_level;
   pctx->fallback_device = fallback_device;
   pctx->required_pass = std::move(required);
   pctx->disabled_pass = std::move(disabled);
+  pctx->fusion_cost_model = std::move(fusion_cost_model);
   *ret = pctx;
 });
 
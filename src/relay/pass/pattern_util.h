@@ -36,6 +36,7 @@
 #include <tvm/relay/attrs/reduce.h>
 #include <string>
 #include <utility>
+#include <vector>
 
 
 namespace tvm {
@@ -244,6 +245,34 @@ inline Constant MakeConstantScalar(DataType dtype, T value) {
   return ConstantNode::make(arr);
 }
 
+/*!
+ * \brief Create a Constant with a tensor.
+ *
+ * \param dtype The data type.
+ * \param shape The shape of the tensor.
+ * \param values The values of the tensor in row major order.
+ * \return A Constant.
+ */
+template<typename T>
+inline Constant MakeConstantTensor(DataType dtype, std::vector<int64_t> shape,
+                                   const std::vector<T>& values) {
+  runtime::NDArray arr = runtime::NDArray::Empty(shape, dtype, {kDLCPU, 0});
+  TVM_DTYPE_DISPATCH(dtype, DType, {
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (dtype == DataType::Float(16)) {
+        // convert to float16
+        // storage is uint16_t
+        static_cast<DType*>(arr->data)[i] =
+          __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
+              static_cast<float>(values[i]));
+      } else {
+        static_cast<DType*>(arr->data)[i] = values[i];
+      }
+    }
+  })
+  return ConstantNode::make(arr);
+}
+
 /*!
  * \brief Check if two expressions are equal scalars.
  * \param a The expression to be checked.
@@ -538,6 +567,8 @@ Expr MakeExpandDims(Expr data, int axis, int num_newaxis);
 
 Expr MakeLayoutTransform(Expr data, std::string src_layout, std::string dst_layout);
 
+Expr MakeFixedPointMultiply(Expr data, Expr multiplier, Expr shift);
+
 Expr StopFusion(Expr data);
 
 Expr CastHint(Expr data, DataType dtype);
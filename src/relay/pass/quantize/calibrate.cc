@@ -26,6 +26,13 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 #include "./quantize.h"
 
 namespace tvm {
@@ -63,6 +70,7 @@ class StatsCollector : private ExprMutator {
       new_attrs->kind = QAnnotateKind::kQIdentity;
       new_attrs->sign = attrs->sign;
       new_attrs->rounding = attrs->rounding;
+      new_attrs->axis = -1;
       Expr identity_quantize = CallNode::make(new_call->op, new_args, Attrs{new_attrs}, {});
 
       // add non-const expressions to profile data
@@ -95,6 +103,332 @@ Expr CreateStatsCollector(const Expr& expr) {
 TVM_REGISTER_API("relay._quantize.CreateStatsCollector")
 .set_body_typed(CreateStatsCollector);
 
+/*!
+ * \brief A histogram of the values of a tensor over [-range, range], which is
+ *  accumulated batch by batch without keeping the values.
+ */
+class Histogram {
+ public:
+  explicit Histogram(int num_bins) : counts_(num_bins, 0) {}
+
+  /*!
+   * \brief Add values to the histogram, NaN and infinite values are ignored.
+   *  When a value is out of the range, the range grows by an odd factor, so
+   *  that each old bin lies in exactly one new bin and the counts stay exact.
+   */
+  void Update(const float* data, int64_t size) {
+    double max_abs = 0;
+    for (int64_t i = 0; i < size; ++i) {
+      if (std::isfinite(data[i])) {
+        max_abs = std::max(max_abs, static_cast<double>(std::abs(data[i])));
+      }
+    }
+    if (max_abs > range_) {
+      Rescale(max_abs);
+    }
+    int num_bins = static_cast<int>(counts_.size());
+    if (range_ == 0) {
+      for (int64_t i = 0; i < size; ++i) {
+        counts_[num_bins / 2] += std::isfinite(data[i]);
+      }
+      return;
+    }
+    double scale = num_bins / (2 * range_);
+    for (int64_t i = 0; i < size; ++i) {
+      if (std::isfinite(data[i])) {
+        counts_[Bin(data[i], range_, scale, num_bins)] += 1;
+      }
+    }
+  }
+
+  /*! \brief The counts of the bins, which cover [-range, range] evenly. */
+  const std::vector<int64_t>& counts() const {
+    return counts_;
+  }
+
+  /*! \brief The half width of the histogram, at least the maximal absolute value. */
+  double range() const {
+    return range_;
+  }
+
+  /*!
+   * \brief Find the threshold whose quantized distribution has the minimal KL
+   *  divergence to the reference distribution, as in
+   *  http://on-demand.gputechconf.com/gtc/2017/presentation/s7310-8-bit-inference-with-tensorrt.pdf
+   */
+  double FindThresholdByKL(int num_quantized_bins) const {
+    int num_bins = static_cast<int>(counts_.size());
+    int zero_bin_idx = num_bins / 2;
+    int num_half_quantized_bins = num_quantized_bins / 2;
+    CHECK_GE(num_bins, num_quantized_bins);
+    std::vector<double> prefix(num_bins + 1, 0);
+    for (int i = 0; i < num_bins; ++i) {
+      prefix[i + 1] = prefix[i] + counts_[i];
+    }
+    double min_divergence = std::numeric_limits<double>::infinity();
+    double opt_threshold = range_;
+    std::vector<double> p, q, quantized_bins(num_quantized_bins);
+    // i is the number of bins on half axis excluding the zero bin.
+    for (int i = num_half_quantized_bins; i <= zero_bin_idx; ++i) {
+      int start = zero_bin_idx - i;
+      int stop = zero_bin_idx + i + 1;
+      int size = stop - start;
+      // the reference distribution p, with the outliers in the end bins.
+      p.assign(counts_.begin() + start, counts_.begin() + stop);
+      p.front() += prefix[start];
+      p.back() += prefix[num_bins] - prefix[stop];
+      // merge the bins into num_quantized_bins bins, then expand them back
+      // over the non-zero bins to get the quantized distribution q.
+      int num_merged_bins = size / num_quantized_bins;
+      q.assign(size, 0);
+      for (int j = 0; j < num_quantized_bins; ++j) {
+        int begin = start + j * num_merged_bins;
+        int end = j == num_quantized_bins - 1 ? stop : begin + num_merged_bins;
+        quantized_bins[j] = prefix[end] - prefix[begin];
+        int norm = 0;
+        for (int k = begin - start; k < end - start; ++k) {
+          norm += p[k] != 0;
+        }
+        if (norm == 0) continue;
+        for (int k = begin - start; k < end - start; ++k) {
+          if (p[k] != 0) q[k] = quantized_bins[j] / norm;
+        }
+      }
+      double divergence = Smooth(&p) && Smooth(&q) ?
+          KLDivergence(p, q) : std::numeric_limits<double>::infinity();
+      if (divergence < min_divergence) {
+        min_divergence = divergence;
+        opt_threshold = Edge(stop);
+      }
+    }
+    return opt_threshold;
+  }
+
+  /*! \brief Find the threshold below which percentile of the absolute values are. */
+  double FindThresholdByPercentile(double percentile) const {
+    int num_bins = static_cast<int>(counts_.size());
+    int zero_bin_idx = num_bins / 2;
+    double total = 0;
+    for (int64_t count : counts_) {
+      total += count;
+    }
+    double covered = counts_[zero_bin_idx];
+    for (int i = 0; zero_bin_idx + i + 1 < num_bins; ++i) {
+      if (covered >= percentile * total) {
+        return Edge(zero_bin_idx + i + 1);
+      }
+      covered += counts_[zero_bin_idx - i - 1] + counts_[zero_bin_idx + i + 1];
+    }
+    return range_;
+  }
+
+ private:
+  // The bin of a finite value in [-range, range], the same as numpy.histogram
+  // computes it up to rounding.
+  static int Bin(double value, double range, double scale, int num_bins) {
+    double bin = std::min(std::max((value + range) * scale, 0.0), num_bins - 1.0);
+    return static_cast<int>(bin);
+  }
+
+  double Edge(int i) const {
+    return -range_ + i * (2 * range_ / counts_.size());
+  }
+
+  void Rescale(double max_abs) {
+    // A histogram of zeros keeps them in the zero bin.
+    if (range_ == 0) {
+      range_ = max_abs;
+      return;
+    }
+    // Growing [-r, r] to [-f * r, f * r] with an odd f shifts the old bin
+    // edges by (f - 1) / 2 * num_bins old widths, so they are also edges of the
+    // new bins, which are f old widths wide. f is bounded to avoid overflow.
+    const int64_t kMaxFactor = (1 << 20) + 1;
+    int num_bins = static_cast<int>(counts_.size());
+    while (range_ < max_abs) {
+      int64_t factor = static_cast<int64_t>(
+          std::min(std::ceil(max_abs / range_), static_cast<double>(kMaxFactor)));
+      factor += factor % 2 == 0;
+      int64_t shift = (factor - 1) / 2 * num_bins;
+      std::vector<int64_t> counts(num_bins, 0);
+      for (int i = 0; i < num_bins; ++i) {
+        counts[(i + shift) / factor] += counts_[i];
+      }
+      counts_.swap(counts);
+      range_ *= factor;
+    }
+  }
+
+  // Replace the zeros of a distribution by eps and take the same amount off
+  // the non-zero values, return false if the distribution is malformed.
+  static bool Smooth(std::vector<double>* hist, double eps = 0.0001) {
+    int64_t num_zeros = 0;
+    for (double v : *hist) {
+      num_zeros += v == 0;
+    }
+    int64_t num_nonzeros = static_cast<int64_t>(hist->size()) - num_zeros;
+    if (num_nonzeros == 0) return false;
+    double eps1 = eps * num_zeros / num_nonzeros;
+    for (double& v : *hist) {
+      v = v == 0 ? eps : v - eps1;
+      if (v <= 0) return false;
+    }
+    return true;
+  }
+
+  // The KL divergence of the distributions after normalization.
+  static double KLDivergence(const std::vector<double>& p, const std::vector<double>& q) {
+    double p_sum = 0, q_sum = 0;
+    for (size_t i = 0; i < p.size(); ++i) {
+      p_sum += p[i];
+      q_sum += q[i];
+    }
+    double divergence = 0;
+    for (size_t i = 0; i < p.size(); ++i) {
+      double pi = p[i] / p_sum;
+      divergence += pi * std::log(pi / (q[i] / q_sum));
+    }
+    return divergence;
+  }
+
+  /*! \brief The counts of the bins. */
+  std::vector<int64_t> counts_;
+  /*! \brief The half width of the histogram, zero until a non-zero value is seen. */
+  double range_{0};
+};
+
+/*!
+ * \brief The histograms of the outputs of a profile graph, see CreateStatsCollector.
+ */
+class CalibrationStatsNode : public Object {
+ public:
+  int num_bins;
+  std::vector<Histogram> hists;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("num_bins", &num_bins);
+  }
+
+  static constexpr const char* _type_key = "relay.quantize.CalibrationStats";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CalibrationStatsNode, Object);
+};
+
+TVM_REGISTER_NODE_TYPE(CalibrationStatsNode);
+
+// Call flayer(i) for each layer on the thread pool.
+template<typename FLayer>
+void ParallelForLayers(int num_layers, const FLayer& flayer) {
+  struct Closure {
+    const FLayer* flayer;
+    int num_layers;
+  };
+  Closure closure{&flayer, num_layers};
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    const Closure* c = static_cast<const Closure*>(cdata);
+    for (int i = task_id; i < c->num_layers; i += penv->num_task) {
+      (*c->flayer)(i);
+    }
+    return 0;
+  };
+  TVMBackendParallelLaunch(flambda, &closure, 0);
+}
+
+TVM_REGISTER_API("relay._quantize.CreateCalibrationStats")
+.set_body_typed<ObjectRef(int, int)>([](int num_layers, int num_bins) {
+  auto n = make_object<CalibrationStatsNode>();
+  n->num_bins = num_bins;
+  n->hists.assign(num_layers, Histogram(num_bins));
+  return ObjectRef(n);
+});
+
+/*
+ * \brief Accumulate the outputs of a graph runtime that runs a profile graph,
+ *  which is called after each batch of the calibration dataset. The outputs
+ *  are read in place, they are only copied when they are not on CPU.
+ */
+TVM_REGISTER_API("relay._quantize.CalibrationStatsUpdate")
+.set_body_typed<void(ObjectRef, runtime::Module)>([](ObjectRef ref, runtime::Module rt) {
+  auto* stats = const_cast<CalibrationStatsNode*>(ref.as<CalibrationStatsNode>());
+  CHECK(stats != nullptr);
+  runtime::PackedFunc get_output = rt.GetFunction("get_output");
+  int num_outputs = rt.GetFunction("get_num_outputs")();
+  CHECK_EQ(static_cast<size_t>(num_outputs), stats->hists.size());
+  std::vector<runtime::NDArray> outputs;
+  for (int i = 0; i < num_outputs; ++i) {
+    runtime::NDArray output = get_output(i);
+    CHECK(output->dtype.code == kDLFloat && output->dtype.bits == 32 &&
+          output->dtype.lanes == 1)
+        << "Calibration expects float32 outputs";
+    if (output->strides != nullptr) {
+      int64_t expected_stride = 1;
+      for (int d = output->ndim - 1; d >= 0; --d) {
+        CHECK(output->shape[d] == 1 || output->strides[d] == expected_stride)
+            << "Calibration expects compact outputs";
+        expected_stride *= output->shape[d];
+      }
+    }
+    if (output->ctx.device_type != kDLCPU) {
+      output = output.CopyTo(DLContext{kDLCPU, 0});
+    }
+    outputs.push_back(output);
+  }
+  ParallelForLayers(num_outputs, [&](int i) {
+    const DLTensor* t = outputs[i].operator->();
+    int64_t size = 1;
+    for (int d = 0; d < t->ndim; ++d) {
+      size *= t->shape[d];
+    }
+    // The outputs of an arena planned graph are views at a byte offset.
+    const float* data = reinterpret_cast<const float*>(
+        static_cast<const char*>(t->data) + t->byte_offset);
+    stats->hists[i].Update(data, size);
+  });
+});
+
+/*
+ * \brief The int64 bin counts of the histogram of a layer, the bins cover
+ *  [-range, range] evenly, see CalibrationStatsRange.
+ */
+TVM_REGISTER_API("relay._quantize.CalibrationStatsHistogram")
+.set_body_typed<runtime::NDArray(ObjectRef, int)>([](ObjectRef ref, int layer) {
+  const auto* stats = ref.as<CalibrationStatsNode>();
+  CHECK(stats != nullptr);
+  const std::vector<int64_t>& counts = stats->hists.at(layer).counts();
+  runtime::NDArray ret = runtime::NDArray::Empty(
+      {static_cast<int64_t>(counts.size())}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
+  std::copy(counts.begin(), counts.end(), static_cast<int64_t*>(ret->data));
+  return ret;
+});
+
+TVM_REGISTER_API("relay._quantize.CalibrationStatsRange")
+.set_body_typed<double(ObjectRef, int)>([](ObjectRef ref, int layer) {
+  const auto* stats = ref.as<CalibrationStatsNode>();
+  CHECK(stats != nullptr);
+  return stats->hists.at(layer).range();
+});
+
+/*
+ * \brief Find the threshold of each layer in parallel, mode is "kl_divergence"
+ *  or "percentile". The result is a float32 NDArray.
+ */
+TVM_REGISTER_API("relay._quantize.CalibrationStatsFindScales")
+.set_body_typed<runtime::NDArray(ObjectRef, std::string, double)>(
+    [](ObjectRef ref, std::string mode, double percentile) {
+  const auto* stats = ref.as<CalibrationStatsNode>();
+  CHECK(stats != nullptr);
+  CHECK(mode == "kl_divergence" || mode == "percentile") << "Unknown calibrate mode " << mode;
+  int num_layers = static_cast<int>(stats->hists.size());
+  runtime::NDArray scales = runtime::NDArray::Empty(
+      {num_layers}, DLDataType{kDLFloat, 32, 1}, DLContext{kDLCPU, 0});
+  float* data = static_cast<float*>(scales->data);
+  ParallelForLayers(num_layers, [&](int i) {
+    data[i] = static_cast<float>(mode == "percentile" ?
+        stats->hists[i].FindThresholdByPercentile(percentile) :
+        stats->hists[i].FindThresholdByKL(255));
+  });
+  return scales;
+});
+
 }  // namespace quantize
 }  // namespace relay
 }  // namespace tvm
@@ -48,7 +48,14 @@ bool SimulatedQuantizeRel(const Array<Type>& types,
   CHECK(data != nullptr);
   CHECK_NE(data->shape.size(), 0) << "Input shape cannot be empty";
 
-  reporter->Assign(types[1], TensorTypeNode::make({}, DataType::Float(32)));    // dom_scale
+  if (param->axis >= 0) {
+    // per-channel dom_scale, one scale for each channel along axis
+    CHECK_LT(param->axis, static_cast<int>(data->shape.size()));
+    reporter->Assign(types[1], TensorTypeNode::make({data->shape[param->axis]},
+                                                    DataType::Float(32)));    // dom_scale
+  } else {
+    reporter->Assign(types[1], TensorTypeNode::make({}, DataType::Float(32)));  // dom_scale
+  }
   reporter->Assign(types[2], TensorTypeNode::make({}, DataType::Float(32)));    // clip_min
   reporter->Assign(types[3], TensorTypeNode::make({}, DataType::Float(32)));    // clip_max
   reporter->Assign(types[4], types[0]);                               // output
@@ -59,7 +66,8 @@ RELAY_REGISTER_OP("relay.op.annotation.simulated_quantize")
 .describe(R"code(simulated quantize op)code" TVM_ADD_FILELINE)
 .set_num_inputs(4)
 .add_argument("data", "Tensor", "The input data.")
-.add_argument("dom_scale", "Tensor", "The domain scale of input data. It should be a scalar")
+.add_argument("dom_scale", "Tensor", "The domain scale of input data. It should be a scalar, "
+              "or a 1-D tensor of the channels along axis for per-channel quantization")
 .add_argument("clip_min", "Tensor", "lower bound. It should be a scalar")
 .add_argument("clip_max", "Tensor", "upper bound. It should be a scalar")
 .set_attrs_type<SimulatedQuantizeAttrs>()
@@ -67,13 +75,14 @@ RELAY_REGISTER_OP("relay.op.annotation.simulated_quantize")
 .add_type_rel("SimulatedQuantize", SimulatedQuantizeRel);
 
 TVM_REGISTER_API("relay._quantize.simulated_quantize")
-.set_body_typed<Expr(Expr, Expr, Expr, Expr, int, bool, std::string)>(
+.set_body_typed<Expr(Expr, Expr, Expr, Expr, int, bool, std::string, int)>(
   [](Expr data, Expr dom_scale, Expr clip_min, Expr clip_max,
-     int kind, bool sign, std::string rounding) {
+     int kind, bool sign, std::string rounding, int axis) {
     auto attrs = make_object<SimulatedQuantizeAttrs>();
     attrs->kind = kind;
     attrs->sign = sign;
     attrs->rounding = rounding;
+    attrs->axis = axis;
     static const Op& op = Op::Get("relay.op.annotation.simulated_quantize");
     return CallNode::make(op, {data, dom_scale, clip_min, clip_max}, Attrs(attrs), {});
   });
@@ -125,7 +134,9 @@ TVM_STATIC_IR_FUNCTOR(IRPrinter, vtable)
   p->stream << "nbit_activation=" << op->nbit_activation << ", ";
   p->stream << "calibrate_mode=" << op->calibrate_mode << ", ";
   p->stream << "global_scale=" << op->global_scale << ", ";
+  p->stream << "calibrate_percentile=" << op->calibrate_percentile << ", ";
   p->stream << "weight_scale=" << op->weight_scale << ", ";
+  p->stream << "per_channel=" << op->per_channel << ", ";
   p->stream << "skip_conv_layers==" << op->skip_conv_layers << ", ";
   p->stream << "do_simulation==" << op->do_simulation << ", ";
   p->stream << "round_for_shift==" << op->round_for_shift << ", ";
@@ -46,6 +46,7 @@ struct SimulatedQuantizeAttrs : public tvm::AttrsNode<SimulatedQuantizeAttrs> {
   int kind;
   bool sign;
   std::string rounding;
+  int axis;
 
   TVM_DECLARE_ATTRS(SimulatedQuantizeAttrs, "relay.attrs.SimulatedQuantizeAttrs") {
     TVM_ATTR_FIELD(kind)
@@ -54,6 +55,8 @@ struct SimulatedQuantizeAttrs : public tvm::AttrsNode<SimulatedQuantizeAttrs> {
         .describe("whether to use signed data type.");
     TVM_ATTR_FIELD(rounding).set_default("round")
         .describe("rounding mode. Can be 'floor', 'ceil', 'round'");
+    TVM_ATTR_FIELD(axis).set_default(-1)
+        .describe("the channel axis of a per-channel dom_scale, -1 for a scalar dom_scale.");
   }
 };
 
@@ -72,7 +75,9 @@ class QConfigNode : public Object {
   DataType dtype_activation = DataType::Int(32);
   std::string calibrate_mode = "global_scale";
   double global_scale = 8.0;
+  double calibrate_percentile = 0.9999;
   std::string weight_scale = "power2";
+  bool per_channel = false;
   Array<Expr> skip_conv_layers = Array<Expr>(ObjectPtr<Object>(nullptr));
   bool do_simulation = false;
   bool round_for_shift = true;
@@ -88,7 +93,9 @@ class QConfigNode : public Object {
     v->Visit("dtype_activation", &dtype_activation);
     v->Visit("calibrate_mode", &calibrate_mode);
     v->Visit("global_scale", &global_scale);
+    v->Visit("calibrate_percentile", &calibrate_percentile);
     v->Visit("weight_scale", &weight_scale);
+    v->Visit("per_channel", &per_channel);
     v->Visit("skip_conv_layers", &skip_conv_layers);
     v->Visit("do_simulation", &do_simulation);
     v->Visit("round_for_shift", &round_for_shift);
@@ -28,6 +28,8 @@
 #include <tvm/relay/transform.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
+#include <algorithm>
+#include <vector>
 #include "./quantize.h"
 #include "../pattern_util.h"
 #include "../../qnn/util.h"
@@ -124,6 +126,60 @@ inline Expr MulAndDiv(Expr data, float s1, float s2, DataType dtype,
   }
 }
 
+/* \brief Reshape a 1-D per-channel scale to broadcast along axis of a ndim tensor */
+inline Expr ExpandPerChannelScale(const Expr& scale, int axis, size_t ndim) {
+  const auto* n = scale.as<ConstantNode>();
+  CHECK(n && n->data->ndim == 1)
+      << "per-channel dom_scale should be a 1-D constant";
+  size_t num_channels = static_cast<size_t>(n->data->shape[0]);
+  const float* values = static_cast<const float*>(n->data->data);
+  std::vector<int64_t> shape(ndim, 1);
+  shape[axis] = static_cast<int64_t>(num_channels);
+  return MakeConstantTensor(DataType::Float(32), shape,
+                            std::vector<float>(values, values + num_channels));
+}
+
+/* \brief Get the values of a scale constant, one for a scalar and one per channel otherwise */
+inline std::vector<float> GetScaleValues(const Expr& scale) {
+  const auto* n = scale.as<ConstantNode>();
+  CHECK(n);
+  int64_t size = 1;
+  for (int64_t i = 0; i < n->data->ndim; ++i) {
+    size *= n->data->shape[i];
+  }
+  const float* values = static_cast<const float*>(n->data->data);
+  return std::vector<float>(values, values + size);
+}
+
+/*
+ * \brief Requantize the int32 output of conv2d or dense with per-channel weight
+ *  scales to a single dom_scale, so that the rest of the graph stays per-tensor.
+ *
+ *  Output channel c has the scale s_in * s_w[c]. It is rescaled to
+ *  s_in * max(s_w) with the fixed point multiplier s_w[c] / max(s_w) <= 1,
+ *  which cannot overflow the activation type. The multiplication is an
+ *  elementwise epilogue and gets fused into the conv2d/dense.
+ */
+Expr PerChannelToPerTensor(Expr data, float lhs_scale, const Expr& rhs_scale,
+                           const Array<IndexExpr>& out_shape, int axis, Expr* dom_scale) {
+  const QConfig& cfg = QConfig::Current();
+  std::vector<float> scales = GetScaleValues(rhs_scale);
+  float max_scale = *std::max_element(scales.begin(), scales.end());
+  std::vector<double> multipliers;
+  for (float scale : scales) {
+    multipliers.push_back(static_cast<double>(scale) / max_scale);
+  }
+  *dom_scale = MakeConstantScalar(DataType::Float(32), lhs_scale * max_scale);
+  if (cfg->dtype_activation == DataType::Int(32)) {
+    Expr fused = qnn::FusedFixedPointMultiply(data, multipliers, out_shape.size(), axis,
+                                              cfg->rounding);
+    if (fused.defined()) return fused;
+  }
+  data = qnn::FixedPointMultiplyPerChannel(Cast(data, DataType::Int(64)), multipliers,
+                                           out_shape, axis, cfg->rounding);
+  return Cast(data, cfg->dtype_activation);
+}
+
 Expr QuantizeRealize(const Call& ref_call,
                      const Array<Expr>& new_args,
                      const ObjectRef& ctx) {
@@ -136,7 +192,6 @@ Expr QuantizeRealize(const Call& ref_call,
   Expr clip_min = new_args[2];
   Expr clip_max = new_args[3];
 
-  float dom_scale_imm = GetScalarFromConstant<float>(dom_scale);
   float clip_min_imm = GetScalarFromConstant<float>(clip_min);
   float clip_max_imm = GetScalarFromConstant<float>(clip_max);
 
@@ -172,6 +227,15 @@ Expr QuantizeRealize(const Call& ref_call,
       data = Clip(data, clip_min_imm, clip_max_imm);
       return QRealizeIntExprNode::make(data, dom_scale, n->dtype);
     } else {
+      if (n->dtype == DataType::Int(32)) {
+        Expr fused = qnn::FusedFixedPointMultiply(
+            data, {idom_scale_imm / odom_scale_imm},
+            ref_call->type_as<TensorTypeNode>()->shape.size(), -1, cfg->rounding);
+        if (fused.defined()) {
+          data = Clip(fused, clip_min_imm, clip_max_imm);
+          return QRealizeIntExprNode::make(data, dom_scale, n->dtype);
+        }
+      }
       data = Cast(data, DataType::Int(64));
       data = qnn::FixedPointMultiply(data, idom_scale_imm / odom_scale_imm,
                                      ref_call->type_as<TensorTypeNode>()->shape,
@@ -184,6 +248,15 @@ Expr QuantizeRealize(const Call& ref_call,
   // quantize from real
   CHECK(!new_args[0]->IsInstance<TempExprNode>());
   Expr data = new_args[0];
+  if (param->axis >= 0) {
+    // per-channel quantize, only used for weights, the dom_scale is kept
+    // in the shape that broadcasts along the channel axis.
+    dom_scale = ExpandPerChannelScale(dom_scale, param->axis,
+                                      ref_call->type_as<TensorTypeNode>()->shape.size());
+    Expr round_data = Clip(Round(Divide(data, dom_scale)), clip_min_imm, clip_max_imm);
+    return QRealizeIntExprNode::make(round_data, dom_scale, DataType::Float(32));
+  }
+  float dom_scale_imm = GetScalarFromConstant<float>(dom_scale);
   Expr scaled_data = Multiply(data, MakeConstantScalar(DataType::Float(32), 1 / dom_scale_imm));
   Expr round_data = Clip(Round(scaled_data), clip_min_imm, clip_max_imm);
   return QRealizeIntExprNode::make(round_data, dom_scale, DataType::Float(32));
@@ -227,6 +300,17 @@ Expr Conv2dRealize(const Call& ref_call,
 
   Expr ret = CallNode::make(ref_call->op,
     {ldata, rdata}, Attrs(attrs), ref_call->type_args);
+  if (!rhs->dom_scale.as<ConstantNode>()->is_scalar()) {
+    // per-channel weight
+    Layout out_layout(attrs->out_layout == "" ? attrs->data_layout : attrs->out_layout);
+    int axis = out_layout.IndexOf(LayoutAxis::Get('C'));
+    CHECK_GE(axis, 0) << "conv2d output layout " << out_layout << " has no channel axis";
+    Expr dom_scale;
+    ret = PerChannelToPerTensor(ret, GetScalarFromConstant<float>(lhs->dom_scale),
+                                rhs->dom_scale, ref_call->type_as<TensorTypeNode>()->shape,
+                                axis, &dom_scale);
+    return QRealizeIntExprNode::make(ret, dom_scale, out_dtype);
+  }
   Expr mul = Multiply(lhs->dom_scale, rhs->dom_scale);
   Expr dom_scale = FoldConstantOpt(mul);
   return QRealizeIntExprNode::make(ret, dom_scale, out_dtype);
@@ -261,6 +345,15 @@ Expr DenseRealize(const Call& ref_call,
 
   Expr ret = CallNode::make(ref_call->op,
           {ldata, rdata}, Attrs(attrs), ref_call->type_args);
+  if (!rhs->dom_scale.as<ConstantNode>()->is_scalar()) {
+    // per-channel weight, the units are the last axis of the output
+    const auto& out_shape = ref_call->type_as<TensorTypeNode>()->shape;
+    Expr dom_scale;
+    ret = PerChannelToPerTensor(ret, GetScalarFromConstant<float>(lhs->dom_scale),
+                                rhs->dom_scale, out_shape,
+                                static_cast<int>(out_shape.size()) - 1, &dom_scale);
+    return QRealizeIntExprNode::make(ret, dom_scale, out_dtype);
+  }
   Expr mul = Multiply(lhs->dom_scale, rhs->dom_scale);
   Expr dom_scale = FoldConstantOpt(mul);
   return QRealizeIntExprNode::make(ret, dom_scale, out_dtype);
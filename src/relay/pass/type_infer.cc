@@ -93,6 +93,131 @@ struct ResolvedTypeInfo {
   Array<Type> type_args = Array<Type>(ObjectPtr<Object>(nullptr));
 };
 
+/*!
+ * \brief Decide whether the checked_type_ already attached to an
+ *  expression from a previous round of inference can be reused.
+ *
+ * Relay nodes are immutable, and every mutator creates fresh nodes
+ * (with an empty checked_type_) along the path to a rewritten
+ * subexpression. A subtree in which every node still carries a
+ * complete checked type, and every variable a type annotation, was
+ * therefore left untouched since it was last inferred and does not
+ * need to be re-solved.
+ *
+ * Subtrees referring to global variables are never reused, because the
+ * signature of the callee may have changed in the module.
+ * Results are memoized so each node is inspected at most once.
+ */
+class CheckedTypeReuseChecker : private ExprFunctor<bool(const Expr&)> {
+ public:
+  bool Check(const Expr& expr) {
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) return it->second;
+    bool ret = this->VisitExpr(expr);
+    memo_[expr.get()] = ret;
+    return ret;
+  }
+
+ private:
+  class IncompleteTypeDetector : public TypeVisitor {
+   public:
+    void VisitType_(const IncompleteTypeNode* op) final {
+      found = true;
+    }
+    bool found{false};
+  };
+
+  static bool HasCompleteType(const Expr& expr) {
+    if (!expr->checked_type_.defined()) return false;
+    IncompleteTypeDetector detector;
+    detector.VisitType(expr->checked_type_);
+    return !detector.found;
+  }
+
+  bool CheckNode(const Expr& expr, const Array<Expr>& children) {
+    if (!HasCompleteType(expr)) return false;
+    for (const Expr& child : children) {
+      if (!Check(child)) return false;
+    }
+    return true;
+  }
+
+  bool VisitExpr_(const VarNode* op) final {
+    return op->type_annotation.defined() && HasCompleteType(GetRef<Var>(op));
+  }
+
+  bool VisitExpr_(const GlobalVarNode* op) final {
+    return false;
+  }
+
+  bool VisitExpr_(const OpNode* op) final {
+    return true;
+  }
+
+  bool VisitExpr_(const ConstantNode* op) final {
+    return HasCompleteType(GetRef<Constant>(op));
+  }
+
+  bool VisitExpr_(const ConstructorNode* op) final {
+    return HasCompleteType(GetRef<Constructor>(op));
+  }
+
+  bool VisitExpr_(const TupleNode* op) final {
+    return CheckNode(GetRef<Tuple>(op), op->fields);
+  }
+
+  bool VisitExpr_(const TupleGetItemNode* op) final {
+    return CheckNode(GetRef<TupleGetItem>(op), {op->tuple});
+  }
+
+  bool VisitExpr_(const FunctionNode* op) final {
+    Array<Expr> children;
+    for (const Var& param : op->params) {
+      children.push_back(param);
+    }
+    children.push_back(op->body);
+    return op->ret_type.defined() && CheckNode(GetRef<Function>(op), children);
+  }
+
+  bool VisitExpr_(const CallNode* op) final {
+    Array<Expr> children = op->args;
+    children.push_back(op->op);
+    return CheckNode(GetRef<Call>(op), children);
+  }
+
+  bool VisitExpr_(const LetNode* op) final {
+    return CheckNode(GetRef<Let>(op), {op->var, op->value, op->body});
+  }
+
+  bool VisitExpr_(const IfNode* op) final {
+    return CheckNode(GetRef<If>(op), {op->cond, op->true_branch, op->false_branch});
+  }
+
+  bool VisitExpr_(const RefCreateNode* op) final {
+    return CheckNode(GetRef<RefCreate>(op), {op->value});
+  }
+
+  bool VisitExpr_(const RefReadNode* op) final {
+    return CheckNode(GetRef<RefRead>(op), {op->ref});
+  }
+
+  bool VisitExpr_(const RefWriteNode* op) final {
+    return CheckNode(GetRef<RefWrite>(op), {op->ref, op->value});
+  }
+
+  bool VisitExpr_(const MatchNode* op) final {
+    // Pattern variables are only reachable through the clause bodies,
+    // so checking the bodies also covers their annotations.
+    Array<Expr> children{op->data};
+    for (const Clause& c : op->clauses) {
+      children.push_back(c->rhs);
+    }
+    return CheckNode(GetRef<Match>(op), children);
+  }
+
+  std::unordered_map<const Object*, bool> memo_;
+};
+
 //
 // The inference algorithm can roughly be devided into three stages:
 // - Populate the constraints by visiting the expression (TypeInferencer.GetType)
@@ -100,6 +225,11 @@ struct ResolvedTypeInfo {
 // - Solve the constraints (solver_.Solve)
 // - Recreate expression with the resolved checked_type (Resolver.VisitExpr)
 //
+// Subexpressions that were left untouched since the last inference
+// (see CheckedTypeReuseChecker) keep their checked_type and are neither
+// re-solved nor rebuilt, so re-running InferType after a pass only
+// pays for the regions the pass actually rewrote.
+//
 class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
                        private PatternFunctor<void(const Pattern&, const Type&)> {
  public:
@@ -130,6 +260,15 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
   // type inferencer will populate it up
   std::unordered_map<Expr, ResolvedTypeInfo, ObjectHash, ObjectEqual> type_map_;
 
+  // expressions whose checked_type is reused from a previous inference
+  std::unordered_set<Expr, ObjectHash, ObjectEqual> reused_;
+
+  // decides which subexpressions can keep their checked_type
+  CheckedTypeReuseChecker reuse_checker_;
+
+  // The root expression of the current inference, never reused.
+  Expr root_;
+
   // The solver used by the inferencer.
   TypeSolver solver_;
   // relation function
@@ -160,6 +299,11 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
     if (it != type_map_.end() && it->second.checked_type.defined()) {
       return it->second.checked_type;
     }
+    if (CanReuseCheckedType(expr)) {
+      reused_.insert(expr);
+      type_map_[expr].checked_type = expr->checked_type_;
+      return expr->checked_type_;
+    }
     Type ret = this->VisitExpr(expr);
     CHECK(ret.defined());
     KindCheck(ret, mod_);
@@ -168,6 +312,14 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
     return ret;
   }
 
+  // Variables and operators are cheap to type on their own; only
+  // compound expressions benefit from skipping re-inference.
+  bool CanReuseCheckedType(const Expr& expr) {
+    if (expr.same_as(root_)) return false;
+    if (expr.as<VarNode>() || expr.as<OpNode>() || expr.as<GlobalVarNode>()) return false;
+    return reuse_checker_.Check(expr);
+  }
+
   void ReportFatalError(const ObjectRef& expr, const Error& err) {
     CHECK(this->current_func_.defined());
     this->err_reporter.ReportAt(this->current_func_, expr, err);
@@ -595,8 +747,15 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
 class TypeInferencer::Resolver : public ExprMutator, PatternMutator {
  public:
   Resolver(const std::unordered_map<Expr, ResolvedTypeInfo, ObjectHash, ObjectEqual>& tmap,
+           const std::unordered_set<Expr, ObjectHash, ObjectEqual>& reused,
            TypeSolver* solver)
-    : tmap_(tmap), solver_(solver) {
+    : tmap_(tmap), reused_(reused), solver_(solver) {
+  }
+
+  Expr VisitExpr(const Expr& expr) final {
+    // reused subexpressions already carry their resolved types.
+    if (reused_.count(expr)) return expr;
+    return ExprMutator::VisitExpr(expr);
   }
 
   Expr VisitExpr_(const VarNode* op) final {
@@ -765,6 +924,7 @@ class TypeInferencer::Resolver : public ExprMutator, PatternMutator {
  private:
   std::unordered_map<Var, Var, ObjectHash, ObjectEqual> vmap_;
   const std::unordered_map<Expr, ResolvedTypeInfo, ObjectHash, ObjectEqual>& tmap_;
+  const std::unordered_set<Expr, ObjectHash, ObjectEqual>& reused_;
   TypeSolver* solver_;
   // whether attach the checked type as type_annotation
   // if original type anntation is missing.
@@ -772,6 +932,7 @@ class TypeInferencer::Resolver : public ExprMutator, PatternMutator {
 };
 
 Expr TypeInferencer::Infer(Expr expr) {
+  root_ = expr;
   // Step 1: Populate the constraints.
   GetType(expr);
 
@@ -779,7 +940,7 @@ Expr TypeInferencer::Infer(Expr expr) {
   Solve();
 
   // Step 3: Attach resolved types to checked_type field.
-  auto resolved_expr = Resolver(type_map_, &solver_).VisitExpr(expr);
+  auto resolved_expr = Resolver(type_map_, reused_, &solver_).VisitExpr(expr);
   CHECK(WellFormed(resolved_expr));
   return resolved_expr;
 }
@@ -105,7 +105,8 @@ Expr ConcatenateQnnCanonicalize(const Attrs& attrs, const Array<Expr>& new_args,
 
       // Requantize the input.
       auto requantized_expr = Requantize(quantized_expr, input_shape, input_scale, input_zero_point,
-                                         output_scale, output_zero_point, input_dtype);
+                                         output_scale, output_zero_point, input_dtype, "UPWARD",
+                                         input_dtype);
       requantized_exprs.push_back(requantized_expr);
     } else {
       requantized_exprs.push_back(quantized_expr);
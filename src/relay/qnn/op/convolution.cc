@@ -572,6 +572,12 @@ Expr QnnConv2DCanonicalize(const Attrs& attrs, const Array<Expr>& new_args,
   int batch_size, in_channels, out_channels, kernel_h, kernel_w, channel_multiplier;
   std::tie(batch_size, in_channels, out_channels, kernel_h, kernel_w, channel_multiplier) =
       GetWorkload(arg_types, param);
+  // Per-channel kernel scales only change the scale of the int32 output, the
+  // lowering below is the same. They are consumed by the following requantize.
+  CHECK(param->kernel_scales.size() == 0 ||
+        static_cast<int>(param->kernel_scales.size()) == out_channels)
+      << "qnn.conv2d expects one kernel scale per output channel, got "
+      << param->kernel_scales.size() << " for " << out_channels << " channels";
 
   // Fallback to int32 conv if there is dilation or grouped conv2d
 
@@ -606,7 +612,7 @@ Expr MakeQnnConv2D(Expr data, Expr weight, int32_t input_zero_point, int32_t ker
                    Array<IndexExpr> padding, Array<IndexExpr> dilation,
                    int groups, IndexExpr channels, Array<IndexExpr> kernel_size,
                    std::string data_layout, std::string kernel_layout, std::string out_layout,
-                   DataType out_dtype) {
+                   DataType out_dtype, Array<tvm::Expr> kernel_scales) {
   auto attrs = make_object<QnnConv2DAttrs>();
   attrs->strides = std::move(strides);
   attrs->padding = std::move(padding);
@@ -622,6 +628,7 @@ Expr MakeQnnConv2D(Expr data, Expr weight, int32_t input_zero_point, int32_t ker
   attrs->kernel_zero_point = std::move(kernel_zero_point);
   attrs->input_scale = std::move(input_scale);
   attrs->kernel_scale = std::move(kernel_scale);
+  attrs->kernel_scales = std::move(kernel_scales);
   static const Op& op = Op::Get("qnn.conv2d");
   return CallNode::make(op, {data, weight}, Attrs(attrs), {});
 }
@@ -630,7 +637,9 @@ RELAY_REGISTER_OP("qnn.conv2d")
 .describe(R"code(2D quantized convolution layer.
 This operator convolves quantized weight with quantized data. The scale of the
 output quantized tensor is the product of the weight_scale and input_scale of
-the input quantized tensors. The zero point of the output quantized tensor is
+the input quantized tensors. With per-channel kernel scales, the output scale
+of each channel is the product of the input_scale and the kernel scale of that
+channel. The zero point of the output quantized tensor is
 0. By default, the dtype of output is int32. Please also refer to Requantize
 operator to understand how to scale back the int32 output to (u)int8.
 - **data**: This depends on the `layout` parameter. Input is 4D array of shape
@@ -59,7 +59,7 @@ bool QnnDenseRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
 Expr MakeQuantizedDense(Expr data, Expr weight, int32_t input_zero_point,
                         int32_t kernel_zero_point,  double input_scale,
                         double kernel_scale, IndexExpr units,
-                        DataType out_dtype) {
+                        DataType out_dtype, Array<tvm::Expr> kernel_scales) {
   auto attrs = make_object<QnnDenseAttrs>();
   attrs->units = std::move(units);
   attrs->out_dtype = out_dtype;
@@ -67,6 +67,7 @@ Expr MakeQuantizedDense(Expr data, Expr weight, int32_t input_zero_point,
   attrs->kernel_zero_point = kernel_zero_point;
   attrs->input_scale = input_scale;
   attrs->kernel_scale = kernel_scale;
+  attrs->kernel_scales = std::move(kernel_scales);
   static const Op& op = Op::Get("qnn.dense");
   return CallNode::make(op, {data, weight}, Attrs(attrs), {});
 }
@@ -133,6 +134,13 @@ Expr QnnDenseCanonicalize(const Attrs& attrs, const Array<Expr>& new_args,
   const int reduction_dim_size = get_const_int(in_shape[1]);
 
   const auto* qnn_dense_attrs = attrs.as<QnnDenseAttrs>();
+  // Per unit kernel scales only change the scale of the int32 output, the
+  // lowering below is the same. They are consumed by the following requantize.
+  const auto kernel_shape = get_shape(arg_types[1]);
+  CHECK(qnn_dense_attrs->kernel_scales.size() == 0 ||
+        static_cast<int64_t>(qnn_dense_attrs->kernel_scales.size()) ==
+        get_const_int(kernel_shape[0]))
+      << "qnn.dense expects one kernel scale per unit";
   auto zp_kernel = MakeConstantScalar(DataType::Int(32), qnn_dense_attrs->kernel_zero_point);
   auto zp_data = MakeConstantScalar(DataType::Int(32), qnn_dense_attrs->input_zero_point);
 
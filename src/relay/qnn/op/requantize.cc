@@ -25,6 +25,8 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/qnn/attrs.h>
+#include <algorithm>
+#include <vector>
 #include "../../pass/pattern_util.h"
 #include "../util.h"
 
@@ -41,6 +43,8 @@ TVM_REGISTER_NODE_TYPE(RequantizeAttrs);
  * \param input_tensor The input tensor to requantize op.
  * \param param The requantize op attrs.
  * \param input_shape The input tensor shape of the requantize op.
+ * \param in_dtype The input tensor dtype of the requantize op.
+ * \param out_dtype The output dtype of the requantize op.
  * \return The sequence of existing Relay ops.
  * \note Requantization using only integer computation. Here, the computation is
  *       converted to a fixed point computation by computing output multiplier
@@ -53,10 +57,58 @@ TVM_REGISTER_NODE_TYPE(RequantizeAttrs);
  *       3) Perform fixed point multiplication.
  *       4) Add the output zero point.
  *       5) Cast to the out_dtype.
+ *
+ *       With per-channel input scales, the fixed point multiplication of step 3
+ *       uses one multiplier and shift per channel, broadcast along the axis.
+ *       When the rounding allows it, steps 2 to 4 are done in int32 around the
+ *       fused fixed_point_multiply op instead of a chain of int64 ops.
  */
 Expr RequantizeLower(const Expr& input_tensor, const RequantizeAttrs* param,
-                     const Array<IndexExpr>& input_shape, const DataType& out_dtype) {
+                     const Array<IndexExpr>& input_shape, const DataType& in_dtype,
+                     const DataType& out_dtype) {
   double double_multiplier = param->input_scale / param->output_scale;
+  std::vector<double> double_multipliers;
+  bool is_identity_scale = param->input_scale == param->output_scale;
+  for (const auto& input_scale : param->input_scales) {
+    const auto* imm = input_scale.as<tvm::ir::FloatImm>();
+    CHECK(imm != nullptr) << "Per-channel input scales must be float constants";
+    double_multipliers.push_back(imm->value / param->output_scale);
+  }
+  if (!double_multipliers.empty()) {
+    is_identity_scale = std::all_of(double_multipliers.begin(), double_multipliers.end(),
+                                    [](double multiplier) { return multiplier == 1.0; });
+  }
+
+  // With UPWARD rounding and multipliers below one, steps 1) to 3) fuse into a
+  // single int32 fixed_point_multiply, which keeps the int64 product inside one
+  // vectorizable stage of the producer's epilogue. The zero points are only
+  // applied in int32 when that cannot wrap: an int32 input with a nonzero input
+  // zero point, or a 32-bit output with a nonzero output zero point, keeps the
+  // int64 chain below.
+  bool input_zp_fits = param->input_zero_point == 0 || in_dtype.bits() < 32;
+  bool output_zp_fits = param->output_zero_point == 0 || out_dtype.bits() < 32;
+  if (!is_identity_scale && input_zp_fits && output_zp_fits) {
+    DataType int32_dtype = DataType::Int(32);
+    auto tensor = Cast(input_tensor, int32_dtype);
+    if (param->input_zero_point != 0) {
+      tensor = Subtract(tensor, MakeConstantScalar(int32_dtype, param->input_zero_point));
+    }
+    auto scaled_int32_t = FusedFixedPointMultiply(
+        tensor, double_multipliers.empty() ? std::vector<double>{double_multiplier}
+                                           : double_multipliers,
+        input_shape.size(), param->axis, param->rounding);
+    if (scaled_int32_t.defined()) {
+      // Clip against the range shifted by the output zero point before adding
+      // it, so a product near the int32 limits cannot wrap around.
+      int64_t output_zp = param->output_zero_point;
+      auto clipped_t = Clip(scaled_int32_t, GetQmin(out_dtype) - output_zp,
+                            GetQmax(out_dtype) - output_zp);
+      if (output_zp != 0) {
+        clipped_t = Add(MakeConstantScalar(int32_dtype, param->output_zero_point), clipped_t);
+      }
+      return Cast(clipped_t, out_dtype);
+    }
+  }
 
   DataType hp_dtype = DataType::Int(64);
 
@@ -69,7 +121,10 @@ Expr RequantizeLower(const Expr& input_tensor, const RequantizeAttrs* param,
 
   // 2) If the input and output scales are same, we can skip the fixed point multiplication.
   auto scaled_int64_t = tensor;
-  if (param->input_scale != param->output_scale) {
+  if (!is_identity_scale && !double_multipliers.empty()) {
+    scaled_int64_t = FixedPointMultiplyPerChannel(scaled_int64_t, double_multipliers,
+                                                  input_shape, param->axis, param->rounding);
+  } else if (!is_identity_scale) {
     scaled_int64_t =
         FixedPointMultiply(scaled_int64_t, double_multiplier, input_shape, param->rounding);
   }
@@ -127,7 +182,7 @@ Expr RequantizeQnnCanonicalize(const Attrs& attrs, const Array<Expr>& new_args,
   CHECK(param->rounding == "UPWARD" || param->rounding == "TONEAREST")
       << "QNN requantize supports two rounding modes - UPWARD and "
       << "TONEAREST";
-  return RequantizeLower(quantized_data, param, input_shape, out_dtype);
+  return RequantizeLower(quantized_data, param, input_shape, in_tensor_type->dtype, out_dtype);
 }
 
 /*
@@ -151,6 +206,16 @@ bool RequantizeRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
   const Array<tvm::Expr> oshape = data->shape;
   // assign output type
   const RequantizeAttrs* param = attrs.as<RequantizeAttrs>();
+  if (param->input_scales.size() != 0) {
+    int ndim = static_cast<int>(oshape.size());
+    int axis = param->axis < 0 ? param->axis + ndim : param->axis;
+    CHECK(axis >= 0 && axis < ndim)
+        << "Requantize axis " << param->axis << " is out of range for input of rank " << ndim;
+    if (const auto* channels = oshape[axis].as<IntImm>()) {
+      CHECK_EQ(channels->value, static_cast<int64_t>(param->input_scales.size()))
+          << "The number of input scales should match the input channels along the axis";
+    }
+  }
   auto out_dtype = param->out_dtype;
   CHECK(out_dtype == DataType::Int(8) ||
         out_dtype == DataType::UInt(8) ||
@@ -163,9 +228,12 @@ bool RequantizeRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
 // Positional relay function to create qnn requantize operator
 // used by frontend FFI.
 Expr MakeRequantize(Expr data, double input_scale, int32_t input_zero_point, double output_scale,
-                    int32_t output_zero_point, std::string rounding, DataType out_dtype) {
+                    int32_t output_zero_point, std::string rounding, DataType out_dtype,
+                    Array<tvm::Expr> input_scales, int axis) {
   auto attrs = make_object<RequantizeAttrs>();
   attrs->input_scale = std::move(input_scale);
+  attrs->input_scales = std::move(input_scales);
+  attrs->axis = axis;
   attrs->input_zero_point = std::move(input_zero_point);
   attrs->output_scale = std::move(output_scale);
   attrs->output_zero_point = std::move(output_zero_point);
@@ -183,6 +251,9 @@ point. The computation looks like this
 
 Q_output = zp_output +  (scale_input)/(scale_output) * (Q_input - zp_input)
 
+If per-channel input scales are given, scale_input is taken from the channel
+of each element along the axis.
+
 )code" TVM_ADD_FILELINE)
 .set_attrs_type<RequantizeAttrs>()
 .set_num_inputs(1)
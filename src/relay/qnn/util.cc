@@ -22,6 +22,8 @@
  * \brief Utility functions for QNN.
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include "util.h"
 #include "../pass/pattern_util.h"
 
@@ -133,6 +135,104 @@ Expr FixedPointMultiply(Expr tensor, double multiplier,
   return tensor;
 }
 
+Expr FixedPointMultiplyPerChannel(Expr tensor, const std::vector<double>& multipliers,
+                                  const Array<IndexExpr>& input_shape, int axis,
+                                  const std::string& rounding) {
+  // Choose high precision datatype to be int64. This is for avoiding overflow
+  // in multiplication of two int32 values.
+  DataType hp_dtype = DataType::Int(64);
+  int ndim = static_cast<int>(input_shape.size());
+  axis = axis < 0 ? axis + ndim : axis;
+  CHECK(axis >= 0 && axis < ndim) << "Invalid channel axis " << axis;
+
+  // The per-channel constants are shaped to broadcast along the channel axis,
+  // so that every step below stays one elementwise op for the whole tensor.
+  size_t num_channels = multipliers.size();
+  std::vector<int64_t> const_shape(ndim, 1);
+  const_shape[axis] = static_cast<int64_t>(num_channels);
+
+  // 1) Calculating the integer multipliers and integer shifts
+  std::vector<int64_t> fixed_pt_multipliers(num_channels), left_shifts(num_channels);
+  std::vector<int64_t> right_shifts(num_channels), rounding_values(num_channels);
+  bool has_left_shift = false;
+  for (size_t i = 0; i < num_channels; ++i) {
+    int32_t fixed_point_multiplier, shift;
+    std::tie(fixed_point_multiplier, shift) = GetFixedPointMultiplierShift(multipliers[i]);
+    fixed_pt_multipliers[i] = fixed_point_multiplier;
+    left_shifts[i] = shift > 0 ? shift : 0;
+    // As in the per-tensor case, the decimal point sits between bits 31 and 30.
+    right_shifts[i] = (shift > 0 ? 0 : -shift) + 31;
+    rounding_values[i] = 1ll << (right_shifts[i] - 1);
+    has_left_shift |= left_shifts[i] != 0;
+  }
+
+  // 2) Multiply the integer multiplier
+  if (has_left_shift) {
+    tensor = LeftShift(tensor, MakeConstantTensor(hp_dtype, const_shape, left_shifts));
+  }
+
+  // 3) Perform the multiplication in higher precision.
+  tensor = Multiply(tensor, MakeConstantTensor(hp_dtype, const_shape, fixed_pt_multipliers));
+
+  // 4) Add the rounding value. For TONEAREST, negative values are rounded with
+  // one less, i.e. away from zero at the midpoints.
+  Expr round_scalar = MakeConstantTensor(hp_dtype, const_shape, rounding_values);
+  if (rounding == "TONEAREST") {
+    auto zero = MakeConstantScalar(hp_dtype, 0);
+    auto one = MakeConstantScalar(hp_dtype, 1);
+    auto is_non_negative = Cast(GreaterEqual(tensor, zero), hp_dtype);
+    tensor = Add(tensor, Subtract(is_non_negative, one));
+  } else {
+    CHECK_EQ(rounding, "UPWARD") << "Rounding mode " << rounding << " not supported.";
+  }
+  tensor = Add(tensor, round_scalar);
+
+  // 5) Right shift the result to get the final output.
+  tensor = RightShift(tensor, MakeConstantTensor(hp_dtype, const_shape, right_shifts));
+  return tensor;
+}
+
+// Whether requantization may use fixed_point_multiply, read once per process.
+static bool FusedFixedPointEnabled() {
+  static const bool enabled = [] {
+    const char* val = getenv("TVM_QNN_FUSED_FIXED_POINT");
+    return val == nullptr || atoi(val) != 0;
+  }();
+  return enabled;
+}
+
+Expr FusedFixedPointMultiply(Expr tensor, const std::vector<double>& multipliers,
+                             size_t ndim, int axis, const std::string& rounding) {
+  if (!FusedFixedPointEnabled() || rounding != "UPWARD" ||
+      std::any_of(multipliers.begin(), multipliers.end(),
+                  [](double multiplier) { return multiplier > 1.0; })) {
+    return Expr();
+  }
+
+  std::vector<int32_t> fixed_pt_multipliers, right_shifts;
+  for (double multiplier : multipliers) {
+    int32_t fixed_point_multiplier, shift;
+    std::tie(fixed_point_multiplier, shift) = GetFixedPointMultiplierShift(multiplier);
+    fixed_pt_multipliers.push_back(fixed_point_multiplier);
+    right_shifts.push_back(-shift);
+  }
+
+  // A single multiplier becomes a scalar constant, per-channel ones broadcast
+  // along the channel axis.
+  std::vector<int64_t> const_shape;
+  if (multipliers.size() > 1) {
+    int rank = static_cast<int>(ndim);
+    axis = axis < 0 ? axis + rank : axis;
+    CHECK(axis >= 0 && axis < rank) << "Invalid channel axis " << axis;
+    const_shape.assign(ndim, 1);
+    const_shape[axis] = static_cast<int64_t>(multipliers.size());
+  }
+  DataType dtype = DataType::Int(32);
+  return MakeFixedPointMultiply(tensor,
+                                MakeConstantTensor(dtype, const_shape, fixed_pt_multipliers),
+                                MakeConstantTensor(dtype, const_shape, right_shifts));
+}
+
 }  // namespace qnn
 }  // namespace relay
 }  // namespace tvm
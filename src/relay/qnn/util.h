@@ -31,6 +31,7 @@
 #include <limits>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace relay {
@@ -78,20 +79,23 @@ static inline const int32_t GetQmax(const DataType& dtype) {
 }
 
 Expr RequantizeLower(const Expr& input_tensor, const RequantizeAttrs* param,
-                     const Array<IndexExpr>& input_shape, const DataType& out_dtype);
+                     const Array<IndexExpr>& input_shape, const DataType& in_dtype,
+                     const DataType& out_dtype);
 
 static inline Expr Requantize(const Expr& data, const Array<IndexExpr>& input_shape,
                               double input_scale, int32_t input_zero_point, double output_scale,
                               int32_t output_zero_point, const DataType& out_dtype,
-                              const std::string& rounding = "UPWARD") {
+                              const std::string& rounding = "UPWARD",
+                              const DataType& in_dtype = DataType::Int(32)) {
   auto attrs = make_object<RequantizeAttrs>();
   attrs->input_scale = std::move(input_scale);
+  attrs->axis = -1;
   attrs->input_zero_point = std::move(input_zero_point);
   attrs->output_scale = std::move(output_scale);
   attrs->output_zero_point = std::move(output_zero_point);
   attrs->rounding = std::move(rounding);
   attrs->out_dtype = std::move(out_dtype);
-  return RequantizeLower(data, attrs.operator->(), input_shape, out_dtype);
+  return RequantizeLower(data, attrs.operator->(), input_shape, in_dtype, out_dtype);
 }
 
 static inline int64_t get_const_int(const tvm::Expr& x) {
@@ -126,6 +130,47 @@ Expr FixedPointMultiply(Expr tensor, double multiplier,
                         const Array<IndexExpr>& input_shape,
                         const std::string& rounding);
 
+/*
+ * \brief Fixed point multiplication between integer tensor with a floating
+ *        point multiplier per channel.
+ * \param tensor The quantized input tensor of dtype int64.
+ * \param multipliers The multipliers, one for each channel along axis.
+ * \param input_shape Shape of the input tensor.
+ * \param axis The channel axis of the input tensor.
+ * \param rounding "UPWARD" or "TONEAREST". The rounding direction when the value
+ *        is midway between two representable values.
+ * \return The sequence of Relay ops for fixed point multiplication.
+
+ * \note The steps are the same as FixedPointMultiply, except that the fixed
+ *       point multipliers, shifts and rounding values are constant tensors
+ *       broadcast along the channel axis instead of scalars.
+ */
+Expr FixedPointMultiplyPerChannel(Expr tensor, const std::vector<double>& multipliers,
+                                  const Array<IndexExpr>& input_shape, int axis,
+                                  const std::string& rounding);
+
+/*
+ * \brief Fixed point multiplication of an int32 tensor, lowered to the single
+ *        fixed_point_multiply operator instead of a chain of int64 ops.
+ * \param tensor The quantized input tensor of dtype int32.
+ * \param multipliers The multipliers, one for each channel along axis, or a
+ *        single one for the whole tensor.
+ * \param ndim Rank of the input tensor.
+ * \param axis The channel axis of the input tensor, unused for one multiplier.
+ * \param rounding "UPWARD" or "TONEAREST".
+ * \return The int32 result, or an undefined Expr when the multiplication
+ *         cannot be fused.
+ *
+ * \note fixed_point_multiply rounds ties towards +inf, so only UPWARD
+ *       rounding is fused. Multipliers must not exceed one, which guarantees
+ *       that the result still fits in int32 before the final clip. The values
+ *       are bit exact with FixedPointMultiply. Setting
+ *       TVM_QNN_FUSED_FIXED_POINT=0 disables the fusion, which
+ *       apps/benchmark/int8_cpu_bench.py uses as its baseline.
+ */
+Expr FusedFixedPointMultiply(Expr tensor, const std::vector<double>& multipliers,
+                             size_t ndim, int axis, const std::string& rounding);
+
 }  // namespace qnn
 }  // namespace relay
 }  // namespace tvm
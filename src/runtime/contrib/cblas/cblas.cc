@@ -68,48 +68,58 @@ struct CblasDgemmOp {
   }
 };
 
-struct CblasSgemmBatchOp {
+struct CblasSgemmBatchIterativeOp {
   typedef float TDatatype;
   void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, float alpha, float* A,
                   int a_stride, int lda, float* B, int b_stride, int ldb, float beta, float* C,
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = BooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = BooleanToTranspose(tb);
+    ParallelBatch(batch_size, static_cast<int64_t>(M) * N * K, [&](int i) {
+      int64_t b = i;
+      cblas_sgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A + b * a_stride, lda,
+                  B + b * b_stride, ldb, beta, C + b * c_stride, ldc);
+    });
+  }
+};
+
+struct CblasSgemmBatchOp {
+  typedef float TDatatype;
+  void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, float alpha, float* A,
+                  int a_stride, int lda, float* B, int b_stride, int ldb, float beta, float* C,
+                  int c_stride, int ldc) {
 #if USE_MKL_BLAS == 1
+    CBLAS_TRANSPOSE trans_a = BooleanToTranspose(ta);
+    CBLAS_TRANSPOSE trans_b = BooleanToTranspose(tb);
     std::vector<const float*> A_array(batch_size);
     std::vector<const float*> B_array(batch_size);
     std::vector<float*> C_array(batch_size);
     for (int i = 0; i < batch_size; ++i) {
-      A_array[i] = A + i * a_stride;
-      B_array[i] = B + i * b_stride;
-      C_array[i] = C + i * c_stride;
+      A_array[i] = A + static_cast<int64_t>(i) * a_stride;
+      B_array[i] = B + static_cast<int64_t>(i) * b_stride;
+      C_array[i] = C + static_cast<int64_t>(i) * c_stride;
     }
     cblas_sgemm_batch(CblasColMajor, &trans_a, &trans_b, &M, &N, &K, &alpha, A_array.data(), &lda,
                       B_array.data(), &ldb, &beta, C_array.data(), &ldc, 1, &batch_size);
 #else
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_sgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
+    CblasSgemmBatchIterativeOp()(batch_size, ta, tb, M, N, K, alpha, A, a_stride, lda, B,
+                                 b_stride, ldb, beta, C, c_stride, ldc);
 #endif
   }
 };
 
-struct CblasSgemmBatchIterativeOp {
-  typedef float TDatatype;
-  void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, float alpha, float* A,
-                  int a_stride, int lda, float* B, int b_stride, int ldb, float beta, float* C,
+struct CblasDgemmBatchIterativeOp {
+  typedef double TDatatype;
+  void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, double alpha, double* A,
+                  int a_stride, int lda, double* B, int b_stride, int ldb, double beta, double* C,
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = BooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = BooleanToTranspose(tb);
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_sgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
+    ParallelBatch(batch_size, static_cast<int64_t>(M) * N * K, [&](int i) {
+      int64_t b = i;
+      cblas_dgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A + b * a_stride, lda,
+                  B + b * b_stride, ldb, beta, C + b * c_stride, ldc);
+    });
   }
 };
 
@@ -118,46 +128,26 @@ struct CblasDgemmBatchOp {
   void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, double alpha, double* A,
                   int a_stride, int lda, double* B, int b_stride, int ldb, double beta, double* C,
                   int c_stride, int ldc) {
+#if USE_MKL_BLAS == 1
     CBLAS_TRANSPOSE trans_a = BooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = BooleanToTranspose(tb);
-#if USE_MKL_BLAS == 1
     std::vector<const double*> A_array(batch_size);
     std::vector<const double*> B_array(batch_size);
     std::vector<double*> C_array(batch_size);
     for (int i = 0; i < batch_size; ++i) {
-      A_array[i] = A + i * a_stride;
-      B_array[i] = B + i * b_stride;
-      C_array[i] = C + i * c_stride;
+      A_array[i] = A + static_cast<int64_t>(i) * a_stride;
+      B_array[i] = B + static_cast<int64_t>(i) * b_stride;
+      C_array[i] = C + static_cast<int64_t>(i) * c_stride;
     }
     cblas_dgemm_batch(CblasColMajor, &trans_a, &trans_b, &M, &N, &K, &alpha, A_array.data(), &lda,
                       B_array.data(), &ldb, &beta, C_array.data(), &ldc, 1, &batch_size);
 #else
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_dgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
+    CblasDgemmBatchIterativeOp()(batch_size, ta, tb, M, N, K, alpha, A, a_stride, lda, B,
+                                 b_stride, ldb, beta, C, c_stride, ldc);
 #endif
   }
 };
 
-struct CblasDgemmBatchIterativeOp {
-  typedef double TDatatype;
-  void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, double alpha, double* A,
-                  int a_stride, int lda, double* B, int b_stride, int ldb, double beta, double* C,
-                  int c_stride, int ldc) {
-    CBLAS_TRANSPOSE trans_a = BooleanToTranspose(ta);
-    CBLAS_TRANSPOSE trans_b = BooleanToTranspose(tb);
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_dgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
-  }
-};
-
 // matrix multiplication for row major
 TVM_REGISTER_GLOBAL("tvm.contrib.cblas.matmul")
 .set_body([](TVMArgs args, TVMRetValue* ret) {
@@ -170,6 +160,141 @@ TVM_REGISTER_GLOBAL("tvm.contrib.cblas.matmul")
     CallGemm(args, ret, CblasDgemmOp());
 });
 
+// Number of floats taken by the packed form of a row major K x N right
+// operand, see tvm.contrib.cblas.sgemm_pack.
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.sgemm_pack_size")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  int K = args[0];
+  int N = args[1];
+#if USE_MKL_BLAS == 1
+  // The packed column major A matrix only depends on its m and k.
+  size_t size = cblas_sgemm_pack_get_size(CblasAMatrix, N, 1, K);
+  *ret = static_cast<int64_t>((size + sizeof(float) - 1) / sizeof(float));
+#else
+  *ret = static_cast<int64_t>(K) * N;
+#endif
+});
+
+// Pack the constant right operand B of a row major matmul into the 1-D float32
+// buffer packed, which is owned by the caller and passed to matmul_prepacked.
+// With MKL it is packed with cblas_sgemm_pack, otherwise B is copied densely.
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.sgemm_pack")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* B = args[0];
+  DLTensor* packed = args[1];
+  bool transb = args[2];
+  CHECK_EQ(B->ndim, 2);
+  CHECK_EQ(packed->ndim, 1);
+  CHECK(TypeMatch(B->dtype, kDLFloat, 32));
+  CHECK(TypeMatch(packed->dtype, kDLFloat, 32));
+  CHECK_EQ(ElementStride(B), 1);
+  CHECK(!IsInPlaceTransposed(B));
+  int K = RowCount(B, transb);
+  int N = ColumnCount(B, transb);
+  const float* B_data = reinterpret_cast<const float*>(
+      static_cast<char*>(B->data) + B->byte_offset);
+  float* packed_data = reinterpret_cast<float*>(
+      static_cast<char*>(packed->data) + packed->byte_offset);
+#if USE_MKL_BLAS == 1
+  size_t size = cblas_sgemm_pack_get_size(CblasAMatrix, N, 1, K);
+  CHECK_GE(packed->shape[0] * sizeof(float), size);
+  cblas_sgemm_pack(CblasColMajor, CblasAMatrix, BooleanToTranspose(transb), N, 1, K, 1.0f,
+                   B_data, ColumnStride(B), packed_data);
+#else
+  CHECK_GE(packed->shape[0], static_cast<int64_t>(K) * N);
+  for (int64_t i = 0; i < B->shape[0]; ++i) {
+    std::copy(B_data + i * ColumnStride(B), B_data + i * ColumnStride(B) + B->shape[1],
+              packed_data + i * B->shape[1]);
+  }
+#endif
+});
+
+// matrix multiplication for row major with a right operand packed by
+// tvm.contrib.cblas.sgemm_pack with the same transb
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.matmul_prepacked")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  DLTensor* packed = args[1];
+  DLTensor* C = args[2];
+  bool transa = args[3];
+  bool transb = args[4];
+  CHECK_EQ(A->ndim, 2);
+  CHECK_EQ(packed->ndim, 1);
+  CHECK_EQ(C->ndim, 2);
+  CHECK(TypeMatch(A->dtype, kDLFloat, 32));
+  CHECK(TypeMatch(packed->dtype, kDLFloat, 32));
+  CHECK(TypeMatch(C->dtype, kDLFloat, 32));
+  CHECK_EQ(ElementStride(A), 1);
+  CHECK_EQ(ElementStride(C), 1);
+  CHECK(!IsInPlaceTransposed(C));
+  transa = IsInPlaceTransposed(A) ? !transa : transa;
+  int M = RowCount(A, transa);
+  int K = ColumnCount(A, transa);
+  int N = C->shape[1];
+  CHECK_EQ(C->shape[0], M);
+  float* A_data = reinterpret_cast<float*>(static_cast<char*>(A->data) + A->byte_offset);
+  float* packed_data = reinterpret_cast<float*>(
+      static_cast<char*>(packed->data) + packed->byte_offset);
+  float* C_data = reinterpret_cast<float*>(static_cast<char*>(C->data) + C->byte_offset);
+#if USE_MKL_BLAS == 1
+  CHECK_GE(packed->shape[0] * sizeof(float), cblas_sgemm_pack_get_size(CblasAMatrix, N, 1, K));
+  cblas_sgemm_compute(CblasColMajor, CblasPacked, BooleanToTranspose(transa), N, M, K,
+                      packed_data, transb ? K : N, A_data, ColumnStride(A), 0.0f, C_data,
+                      ColumnStride(C));
+#else
+  CHECK_GE(packed->shape[0], static_cast<int64_t>(K) * N);
+  CblasSgemmOp()(transb, transa, N, M, K, 1.0f, packed_data, transb ? K : N, A_data,
+                 ColumnStride(A), 0.0f, C_data, ColumnStride(C));
+#endif
+});
+
+#if USE_DNNL == 1 || USE_MKL_BLAS == 1
+// int8 matrix multiplication for row major, C(int32) = A(uint8) * B(int8)
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.matmul_u8s8s32")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  DLTensor* B = args[1];
+  DLTensor* C = args[2];
+  bool transa = args[3];
+  bool transb = args[4];
+  CHECK_EQ(A->ndim, 2);
+  CHECK_EQ(B->ndim, 2);
+  CHECK_EQ(C->ndim, 2);
+  CHECK(TypeMatch(A->dtype, kDLUInt, 8));
+  CHECK(TypeMatch(B->dtype, kDLInt, 8));
+  CHECK(TypeMatch(C->dtype, kDLInt, 32));
+  CHECK_EQ(ElementStride(A), 1);
+  CHECK_EQ(ElementStride(B), 1);
+  CHECK_EQ(ElementStride(C), 1);
+  // C can never be transposed.
+  CHECK(!IsInPlaceTransposed(C));
+  // Reversed strides indicates an in-place transpose operation.
+  transa = IsInPlaceTransposed(A) ? !transa : transa;
+  transb = IsInPlaceTransposed(B) ? !transb : transb;
+  int M = RowCount(A, transa);
+  int K = ColumnCount(A, transa);
+  int N = ColumnCount(B, transb);
+  CHECK_EQ(RowCount(B, transb), K);
+  const uint8_t* A_data = reinterpret_cast<const uint8_t*>(
+      static_cast<char*>(A->data) + A->byte_offset);
+  const int8_t* B_data = reinterpret_cast<const int8_t*>(
+      static_cast<char*>(B->data) + B->byte_offset);
+  int32_t* C_data = reinterpret_cast<int32_t*>(static_cast<char*>(C->data) + C->byte_offset);
+  int32_t c_offset = 0;
+#if USE_DNNL == 1
+  CHECK_EQ(dnnl_gemm_u8s8s32(BooleanToTransposeChar(transa), BooleanToTransposeChar(transb), 'F',
+                             M, N, K, 1.0f, A_data, ColumnStride(A), 0, B_data, ColumnStride(B),
+                             0, 0.0f, C_data, ColumnStride(C), &c_offset),
+           dnnl_success);
+#else
+  // MKL takes the unsigned operand first, despite the name.
+  cblas_gemm_s8u8s32(CblasRowMajor, BooleanToTranspose(transa), BooleanToTranspose(transb),
+                     CblasFixOffset, M, N, K, 1.0f, A_data, ColumnStride(A), 0, B_data,
+                     ColumnStride(B), 0, 0.0f, C_data, ColumnStride(C), &c_offset);
+#endif
+});
+#endif
+
 TVM_REGISTER_GLOBAL("tvm.contrib.cblas.batch_matmul")
 .set_body([](TVMArgs args, TVMRetValue* ret) {
   DLTensor* A = args[0];
@@ -23,6 +23,7 @@
  */
 #pragma once
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/util.h>
 #include <algorithm>
@@ -105,6 +106,36 @@ inline void CallGemm(TVMArgs args, TVMRetValue *ret, TGemmOp op) {
      ColumnStride(C));
 }
 
+// Batches of GEMMs with at most this many multiply-adds each are spread over
+// the thread pool, larger ones are left to the threading of the BLAS library.
+constexpr int64_t kParallelBatchMaxGemmSize = 1 << 18;
+
+// Call fgemm(i) for every GEMM i of a batch.
+template <typename FGemm>
+inline void ParallelBatch(int batch_size, int64_t gemm_size, const FGemm &fgemm) {
+  struct Closure {
+    const FGemm *fgemm;
+    int batch_size;
+  };
+  Closure closure{&fgemm, batch_size};
+  auto flambda = [](int task_id, TVMParallelGroupEnv *penv, void *cdata) {
+    const Closure *c = static_cast<const Closure *>(cdata);
+    int step = (c->batch_size + penv->num_task - 1) / penv->num_task;
+    int end = std::min(c->batch_size, (task_id + 1) * step);
+    for (int i = task_id * step; i < end; ++i) {
+      (*c->fgemm)(i);
+    }
+    return 0;
+  };
+  if (batch_size > 1 && gemm_size <= kParallelBatchMaxGemmSize) {
+    TVMBackendParallelLaunch(flambda, &closure, 0);
+  } else {
+    for (int i = 0; i < batch_size; ++i) {
+      fgemm(i);
+    }
+  }
+}
+
 inline int ColumnStride3D(DLTensor *tensor) {
   // If the tensor itself is transposed then it will have strides
   // backward from what we expect.  Regardless, the max of the strides
@@ -25,11 +25,14 @@
 #include "dnnl_kernel.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -39,207 +42,381 @@ namespace runtime {
 namespace contrib {
 
 using namespace dnnl;
+using tag = memory::format_tag;
+using dt = memory::data_type;
 
-typedef struct {
-  void** data;
-} DnnlPackedArgs;
+/*!
+ * \brief The engine the kernels are created on and the stream of the
+ *  calling thread on it. The engine is shared, so a kernel created by one
+ *  thread can run on the stream of another.
+ */
+struct DNNLContext {
+  engine eng;
+  stream strm;
+
+  DNNLContext() : eng(GlobalEngine()), strm(eng) {}
+
+  static DNNLContext* ThreadLocal() {
+    static thread_local DNNLContext inst;
+    return &inst;
+  }
+
+ private:
+  static const engine& GlobalEngine() {
+    static engine eng(engine::kind::cpu, 0);
+    return eng;
+  }
+};
+
+/*!
+ * \brief Get the kernel of a call site, create it on the first call.
+ *  The caller holds the mutex of the handle.
+ */
+template <typename Kernel, typename FCreate>
+Kernel* GetKernel(DNNLKernelHandle* handle, FCreate fcreate) {
+  if (handle->kernel == nullptr) {
+    handle->kernel = fcreate();
+    handle->deleter = [](void* kernel) { delete static_cast<Kernel*>(kernel); };
+  }
+  return static_cast<Kernel*>(handle->kernel);
+}
 
-// Read from memory, write to handle
-inline void read_from_dnnl_memory(void* handle, const memory& mem) {
-  size_t bytes = mem.get_desc().get_size();
+/*!
+ * \brief A caller buffer in plain layout and its counterpart in the layout
+ *  picked by the primitive, the two share the memory when the layouts match.
+ */
+class ArgMemory {
+ public:
+  ArgMemory(const memory::desc& user_md, const memory::desc& prim_md,
+            const engine& eng, bool is_input)
+      : user_(user_md, eng, DNNL_MEMORY_NONE) {
+    if (user_md == prim_md) {
+      prim_ = user_;
+    } else {
+      prim_ = memory(prim_md, eng);
+      reorder_ = is_input ? reorder(user_, prim_) : reorder(prim_, user_);
+      reordered_ = true;
+    }
+  }
+  /*! \brief Bind the input buffer and reorder it into the primitive layout. */
+  const memory& In(void* handle, stream& strm) {
+    user_.set_data_handle(handle);
+    if (reordered_) reorder_.execute(strm, user_, prim_);
+    return prim_;
+  }
+  /*! \brief Bind the output buffer, call Out after the primitive executes. */
+  const memory& Bind(void* handle) {
+    user_.set_data_handle(handle);
+    return prim_;
+  }
+  /*! \brief Reorder the result back into the output buffer. */
+  void Out(stream& strm) {
+    if (reordered_) reorder_.execute(strm, prim_, user_);
+  }
+
+ private:
+  memory user_;
+  memory prim_;
+  reorder reorder_;
+  bool reordered_{false};
+};
 
-  uint8_t* src = static_cast<uint8_t*>(mem.get_data_handle());
-  std::copy(src, src + bytes, reinterpret_cast<uint8_t*>(handle));
+/*!
+ * \brief Weights in the layout of the primitive, reordered once when
+ *  they are constant and on every call otherwise.
+ */
+class WeightMemory {
+ public:
+  WeightMemory(const memory::desc& user_md, const memory::desc& prim_md,
+               void* weights, bool is_const, DNNLContext* ctx)
+      : arg_(user_md, prim_md, ctx->eng, true), is_const_(is_const) {
+    if (is_const_) {
+      prim_ = arg_.In(weights, ctx->strm);
+      ctx->strm.wait();
+    }
+  }
+  const memory& Get(void* weights, DNNLContext* ctx) {
+    return is_const_ ? prim_ : arg_.In(weights, ctx->strm);
+  }
+
+ private:
+  ArgMemory arg_;
+  memory prim_;
+  bool is_const_;
+};
+
+/*! \brief Zero filled bias in the layout of the primitive. */
+inline memory ZeroBias(const memory::desc& md, const engine& eng) {
+  memory bias(md, eng);
+  memset(bias.get_data_handle(), 0, md.get_size());
+  return bias;
 }
 
+class Conv2dKernel {
+ public:
+  Conv2dKernel(float* weights, int p_N_, int p_C_, int p_H_, int p_W_, int p_O_,
+               int p_G_, int p_Ph_, int p_Pw_, int p_Kh_, int p_Kw_, int p_Sh_,
+               int p_Sw_, int p_const_, DNNLContext* ctx) {
+    memory::dims conv2d_src_tz = {p_N_, p_C_, p_H_, p_W_};
+    memory::dims conv2d_weights_tz = {p_O_, p_C_, p_Kh_, p_Kw_};
+    if (p_G_ > 1) conv2d_weights_tz = {p_G_, p_O_ / p_G_, p_C_ / p_G_, p_Kh_, p_Kw_};
+    memory::dims conv2d_bias_tz = {p_O_};
+    memory::dims conv2d_dst_tz = {p_N_, p_O_,
+                                  (p_H_ - p_Kh_ + 2 * p_Ph_ + p_Sh_) / p_Sh_,
+                                  (p_W_ - p_Kw_ + 2 * p_Pw_ + p_Sw_) / p_Sw_};
+    memory::dims conv2d_strides = {p_Sh_, p_Sw_};
+    memory::dims conv2d_padding = {p_Ph_, p_Pw_};
+
+    auto user_src_md = memory::desc({conv2d_src_tz}, dt::f32, tag::nchw);
+    auto user_weights_md = memory::desc(
+        {conv2d_weights_tz}, dt::f32, (p_G_ > 1) ? tag::goihw : tag::oihw);
+    auto user_dst_md = memory::desc({conv2d_dst_tz}, dt::f32, tag::nchw);
+
+    auto conv2d_src_md = memory::desc({conv2d_src_tz}, dt::f32, tag::any);
+    auto conv2d_bias_md = memory::desc({conv2d_bias_tz}, dt::f32, tag::any);
+    auto conv2d_weights_md = memory::desc({conv2d_weights_tz}, dt::f32, tag::any);
+    auto conv2d_dst_md = memory::desc({conv2d_dst_tz}, dt::f32, tag::any);
+
+    auto conv2d_desc = convolution_forward::desc(
+        prop_kind::forward_inference, algorithm::convolution_direct,
+        conv2d_src_md, conv2d_weights_md, conv2d_bias_md, conv2d_dst_md,
+        conv2d_strides, conv2d_padding, conv2d_padding);
+    auto conv2d_prim_desc = convolution_forward::primitive_desc(conv2d_desc, ctx->eng);
+
+    conv_ = convolution_forward(conv2d_prim_desc);
+    src_.reset(new ArgMemory(user_src_md, conv2d_prim_desc.src_desc(), ctx->eng, true));
+    dst_.reset(new ArgMemory(user_dst_md, conv2d_prim_desc.dst_desc(), ctx->eng, false));
+    weights_.reset(new WeightMemory(user_weights_md, conv2d_prim_desc.weights_desc(),
+                                    weights, p_const_ != 0, ctx));
+    bias_ = ZeroBias(conv2d_prim_desc.bias_desc(), ctx->eng);
+  }
+
+  void Run(float* data, float* weights, float* out, DNNLContext* ctx) {
+    conv_.execute(ctx->strm, {{DNNL_ARG_SRC, src_->In(data, ctx->strm)},
+                              {DNNL_ARG_WEIGHTS, weights_->Get(weights, ctx)},
+                              {DNNL_ARG_BIAS, bias_},
+                              {DNNL_ARG_DST, dst_->Bind(out)}});
+    dst_->Out(ctx->strm);
+    ctx->strm.wait();
+  }
+
+ private:
+  convolution_forward conv_;
+  std::unique_ptr<ArgMemory> src_, dst_;
+  std::unique_ptr<WeightMemory> weights_;
+  memory bias_;
+};
+
 extern "C" void dnnl_conv2d(float* data, float* weights, float* out, int p_N_,
                             int p_C_, int p_H_, int p_W_, int p_O_, int p_G_,
                             int p_Ph_, int p_Pw_, int p_Kh_, int p_Kw_,
-                            int p_Sh_, int p_Sw_) {
-  using tag = memory::format_tag;
-  using dt = memory::data_type;
-  engine eng(engine::kind::cpu, 0);
-  stream s(eng);
-
-  memory::dims conv2d_src_tz = {p_N_, p_C_, p_H_, p_W_};
-  memory::dims conv2d_weights_tz = {p_O_, p_C_, p_Kh_, p_Kw_};
-  if (p_G_ > 1) conv2d_weights_tz = {p_G_, 1, p_C_ / p_G_, p_Kh_, p_Kw_};
-  memory::dims conv2d_bias_tz = {p_O_};
-  memory::dims conv2d_dst_tz = {p_N_, p_O_,
-                                (p_H_ - p_Kh_ + 2 * p_Ph_ + p_Sh_) / p_Sh_,
-                                (p_W_ - p_Kw_ + 2 * p_Pw_ + p_Sw_) / p_Sw_};
-  memory::dims conv2d_strides = {p_Sh_, p_Sw_};
-  memory::dims conv2d_padding = {p_Ph_, p_Pw_};
-
-  std::vector<float> conv2d_bias(p_O_, 0);
-
-  auto user_src_memory =
-      memory({{conv2d_src_tz}, dt::f32, tag::nchw}, eng, data);
-  auto user_weights_memory = memory(
-      {{conv2d_weights_tz}, dt::f32, (p_G_ > 1) ? tag::goihw : tag::oihw}, eng,
-      weights);
-  auto conv2d_user_bias_memory =
-      memory({{conv2d_bias_tz}, dt::f32, tag::x}, eng, conv2d_bias.data());
-
-  auto conv2d_src_md = memory::desc({conv2d_src_tz}, dt::f32, tag::any);
-  auto conv2d_bias_md = memory::desc({conv2d_bias_tz}, dt::f32, tag::any);
-  auto conv2d_weights_md = memory::desc({conv2d_weights_tz}, dt::f32, tag::any);
-  auto conv2d_dst_md = memory::desc({conv2d_dst_tz}, dt::f32, tag::nchw);
-
-  auto conv2d_desc = convolution_forward::desc(
-      prop_kind::forward_inference, algorithm::convolution_direct,
-      conv2d_src_md, conv2d_weights_md, conv2d_bias_md, conv2d_dst_md,
-      conv2d_strides, conv2d_padding, conv2d_padding);
-  auto conv2d_prim_desc = convolution_forward::primitive_desc(conv2d_desc, eng);
-
-  auto conv2d_src_memory = user_src_memory;
-  auto conv2d_weights_memory = user_weights_memory;
-  auto conv2d_dst_memory = memory(conv2d_prim_desc.dst_desc(), eng);
-
-  auto conv = convolution_forward(conv2d_prim_desc);
-  conv.execute(s, {{DNNL_ARG_SRC, conv2d_src_memory},
-                   {DNNL_ARG_WEIGHTS, conv2d_weights_memory},
-                   {DNNL_ARG_BIAS, conv2d_user_bias_memory},
-                   {DNNL_ARG_DST, conv2d_dst_memory}});
-  s.wait();
-  read_from_dnnl_memory(out, conv2d_dst_memory);
+                            int p_Sh_, int p_Sw_, int p_const_,
+                            DNNLKernelHandle* p_handle_) {
+  DNNLContext* ctx = DNNLContext::ThreadLocal();
+  std::lock_guard<std::mutex> lock(p_handle_->mutex);
+  Conv2dKernel* kernel = GetKernel<Conv2dKernel>(p_handle_, [&]() {
+        return new Conv2dKernel(weights, p_N_, p_C_, p_H_, p_W_, p_O_, p_G_,
+                                p_Ph_, p_Pw_, p_Kh_, p_Kw_, p_Sh_, p_Sw_, p_const_, ctx);
+      });
+  kernel->Run(data, weights, out, ctx);
 }
 
+class DenseKernel {
+ public:
+  DenseKernel(float* weight, int p_B_, int p_I_, int p_O_, int p_const_,
+              DNNLContext* ctx) {
+    memory::dims data_tz = {p_B_, p_I_};
+    memory::dims weight_tz = {p_O_, p_I_};
+    memory::dims bias_tz = {p_O_};
+    memory::dims dst_tz = {p_B_, p_O_};
+
+    auto user_data_md = memory::desc({data_tz}, dt::f32, tag::nc);
+    auto user_weight_md = memory::desc({weight_tz}, dt::f32, tag::nc);
+    auto dst_md = memory::desc({dst_tz}, dt::f32, tag::nc);
+
+    auto data_md = memory::desc({data_tz}, dt::f32, tag::any);
+    auto weight_md = memory::desc({weight_tz}, dt::f32, tag::any);
+    auto bias_md = memory::desc({bias_tz}, dt::f32, tag::x);
+
+    auto dense_desc = inner_product_forward::desc(
+        prop_kind::forward_inference, data_md, weight_md, bias_md, dst_md);
+    auto dense_prim_desc = inner_product_forward::primitive_desc(dense_desc, ctx->eng);
+
+    dense_ = inner_product_forward(dense_prim_desc);
+    data_.reset(new ArgMemory(user_data_md, dense_prim_desc.src_desc(), ctx->eng, true));
+    dst_.reset(new ArgMemory(dst_md, dense_prim_desc.dst_desc(), ctx->eng, false));
+    weight_.reset(new WeightMemory(user_weight_md, dense_prim_desc.weights_desc(),
+                                   weight, p_const_ != 0, ctx));
+    bias_ = ZeroBias(dense_prim_desc.bias_desc(), ctx->eng);
+  }
+
+  void Run(float* data, float* weight, float* out, DNNLContext* ctx) {
+    dense_.execute(ctx->strm, {{DNNL_ARG_SRC, data_->In(data, ctx->strm)},
+                               {DNNL_ARG_WEIGHTS, weight_->Get(weight, ctx)},
+                               {DNNL_ARG_BIAS, bias_},
+                               {DNNL_ARG_DST, dst_->Bind(out)}});
+    dst_->Out(ctx->strm);
+    ctx->strm.wait();
+  }
+
+ private:
+  inner_product_forward dense_;
+  std::unique_ptr<ArgMemory> data_, dst_;
+  std::unique_ptr<WeightMemory> weight_;
+  memory bias_;
+};
+
 extern "C" void dnnl_dense(float* data, float* weight, float* out, int p_B_,
-                           int p_I_, int p_O_) {
-  using tag = memory::format_tag;
-  using dt = memory::data_type;
-
-  engine eng(engine::kind::cpu, 0);
-  stream s(eng);
-
-  memory::dims data_tz = {p_B_, p_I_};
-  memory::dims weight_tz = {p_O_, p_I_};
-  memory::dims bias_tz = {p_O_};
-  memory::dims dst_tz = {p_B_, p_O_};
-
-  auto data_md = memory::desc{{data_tz}, dt::f32, tag::nc};
-  auto weight_md = memory::desc({{weight_tz}, dt::f32, tag::nc});
-  auto bias_md = memory::desc({{bias_tz}, dt::f32, tag::x});
-  auto dst_md = memory::desc({{dst_tz}, dt::f32, tag::nc});
-
-  std::vector<float> bias(p_O_, 0);
-  auto data_memory = memory(data_md, eng, data);
-  auto weight_memory = memory(weight_md, eng, weight);
-  auto bias_memory = memory(bias_md, eng, bias.data());
-  auto dst_memory = memory(dst_md, eng);
-
-  auto dense_desc = inner_product_forward::desc(
-      prop_kind::forward_inference, data_md, weight_md, bias_md, dst_md);
-  auto dense_prim_desc = inner_product_forward::primitive_desc(dense_desc, eng);
-  assert(dst_md == dense_prim_desc.dst_desc());
-
-  auto dense = inner_product_forward(dense_prim_desc);
-  dense.execute(s, {{DNNL_ARG_SRC, data_memory},
-                    {DNNL_ARG_WEIGHTS, weight_memory},
-                    {DNNL_ARG_BIAS, bias_memory},
-                    {DNNL_ARG_DST, dst_memory}});
-  s.wait();
-  read_from_dnnl_memory(out, dst_memory);
+                           int p_I_, int p_O_, int p_const_,
+                           DNNLKernelHandle* p_handle_) {
+  DNNLContext* ctx = DNNLContext::ThreadLocal();
+  std::lock_guard<std::mutex> lock(p_handle_->mutex);
+  DenseKernel* kernel = GetKernel<DenseKernel>(
+      p_handle_, [&]() { return new DenseKernel(weight, p_B_, p_I_, p_O_, p_const_, ctx); });
+  kernel->Run(data, weight, out, ctx);
 }
 
-extern "C" void dnnl_relu(float* data, float* out, int p_N_, int p_C_, int p_H_,
-                          int p_W_) {
-  using tag = memory::format_tag;
-  using dt = memory::data_type;
-
-  engine eng(engine::kind::cpu, 0);
-  stream s(eng);
-
-  memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
+class ReluKernel {
+ public:
+  ReluKernel(int p_N_, int p_C_, int p_H_, int p_W_, DNNLContext* ctx) {
+    memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
+    auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
+
+    auto relu_desc = eltwise_forward::desc(prop_kind::forward_inference,
+                                           algorithm::eltwise_relu, data_md, 0);
+    auto relu_prim_desc = eltwise_forward::primitive_desc(relu_desc, ctx->eng);
+    assert(data_md == relu_prim_desc.dst_desc());
+
+    relu_ = eltwise_forward(relu_prim_desc);
+    data_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+    dst_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+  }
+
+  void Run(float* data, float* out, DNNLContext* ctx) {
+    data_.set_data_handle(data);
+    dst_.set_data_handle(out);
+    relu_.execute(ctx->strm, {{DNNL_ARG_SRC, data_}, {DNNL_ARG_DST, dst_}});
+    ctx->strm.wait();
+  }
+
+ private:
+  eltwise_forward relu_;
+  memory data_, dst_;
+};
 
-  auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
-
-  auto data_memory = memory(data_md, eng, data);
-  auto dst_memory = memory(data_md, eng);
-
-  auto relu_desc = eltwise_forward::desc(prop_kind::forward_inference,
-                                         algorithm::eltwise_relu, data_md, 0);
-  auto relu_prim_desc = eltwise_forward::primitive_desc(relu_desc, eng);
-  assert(data_md == relu_prim_desc.dst_desc());
-
-  auto relu = eltwise_forward(relu_prim_desc);
-  relu.execute(s, {{DNNL_ARG_SRC, data_memory}, {DNNL_ARG_DST, dst_memory}});
-  s.wait();
-  read_from_dnnl_memory(out, dst_memory);
+extern "C" void dnnl_relu(float* data, float* out, int p_N_, int p_C_, int p_H_,
+                          int p_W_, DNNLKernelHandle* p_handle_) {
+  DNNLContext* ctx = DNNLContext::ThreadLocal();
+  std::lock_guard<std::mutex> lock(p_handle_->mutex);
+  ReluKernel* kernel = GetKernel<ReluKernel>(
+      p_handle_, [&]() { return new ReluKernel(p_N_, p_C_, p_H_, p_W_, ctx); });
+  kernel->Run(data, out, ctx);
 }
 
+class BatchNormKernel {
+ public:
+  BatchNormKernel(float* gamma, float* beta, int p_N_, int p_C_, int p_H_, int p_W_,
+                  int p_E_, int p_const_, DNNLContext* ctx)
+      : channels_(p_C_), is_const_(p_const_ != 0) {
+    memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
+    auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
+
+    auto bn_desc = batch_normalization_forward::desc(
+        prop_kind::forward_inference, data_md, p_E_,
+        normalization_flags::use_global_stats |
+            normalization_flags::use_scale_shift);
+    auto bn_prim_desc = batch_normalization_forward::primitive_desc(bn_desc, ctx->eng);
+    assert(data_md == bn_prim_desc.dst_desc());
+
+    bn_ = batch_normalization_forward(bn_prim_desc);
+    data_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+    dst_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+    mean_ = memory(bn_prim_desc.mean_desc(), ctx->eng, DNNL_MEMORY_NONE);
+    variance_ = memory(bn_prim_desc.variance_desc(), ctx->eng, DNNL_MEMORY_NONE);
+    weight_ = memory(bn_prim_desc.weights_desc(), ctx->eng);
+    if (is_const_) PackScaleShift(gamma, beta);
+  }
+
+  void Run(float* data, float* gamma, float* beta, float* mean, float* variance,
+           float* out, DNNLContext* ctx) {
+    if (!is_const_) PackScaleShift(gamma, beta);
+    data_.set_data_handle(data);
+    dst_.set_data_handle(out);
+    mean_.set_data_handle(mean);
+    variance_.set_data_handle(variance);
+    bn_.execute(ctx->strm, {{DNNL_ARG_SRC, data_},
+                            {DNNL_ARG_DST, dst_},
+                            {DNNL_ARG_SCALE_SHIFT, weight_},
+                            {DNNL_ARG_MEAN, mean_},
+                            {DNNL_ARG_VARIANCE, variance_}});
+    ctx->strm.wait();
+  }
+
+ private:
+  // scale and shift are packed into one buffer.
+  void PackScaleShift(float* gamma, float* beta) {
+    float* weight = static_cast<float*>(weight_.get_data_handle());
+    memcpy(weight, gamma, sizeof(float) * channels_);
+    memcpy(weight + channels_, beta, sizeof(float) * channels_);
+  }
+
+  batch_normalization_forward bn_;
+  memory data_, dst_, mean_, variance_, weight_;
+  int channels_;
+  bool is_const_;
+};
+
 extern "C" void dnnl_bn(float* data, float* gamma, float* beta, float* mean,
                         float* variance, float* out, int p_N_, int p_C_,
-                        int p_H_, int p_W_, int p_E_) {
-  using tag = memory::format_tag;
-  using dt = memory::data_type;
-
-  engine eng(engine::kind::cpu, 0);
-  stream s(eng);
-
-  memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
-
-  auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
-
-  auto data_memory = memory(data_md, eng, data);
-  auto dst_memory = memory(data_md, eng);
-
-  auto bn_desc = batch_normalization_forward::desc(
-      prop_kind::forward_inference, data_md, p_E_,
-      normalization_flags::use_global_stats |
-          normalization_flags::use_scale_shift);
-  auto bn_prim_desc = batch_normalization_forward::primitive_desc(bn_desc, eng);
-  assert(data_md == bn_prim_desc.dst_desc());
-
-  float* weight = reinterpret_cast<float*>(malloc(sizeof(float) * 2 * p_C_));
-  memcpy(weight, gamma, sizeof(float) * p_C_);
-  memcpy(weight + p_C_, beta, sizeof(float) * p_C_);
-
-  auto weight_memory = memory(bn_prim_desc.weights_desc(), eng, weight);
-  auto mean_memory = memory(bn_prim_desc.mean_desc(), eng, mean);
-  auto variance_memory = memory(bn_prim_desc.variance_desc(), eng, variance);
-
-  auto bn = batch_normalization_forward(bn_prim_desc);
-  bn.execute(s, {{DNNL_ARG_SRC, data_memory},
-                 {DNNL_ARG_DST, dst_memory},
-                 {DNNL_ARG_SCALE_SHIFT, weight_memory},
-                 {DNNL_ARG_MEAN, mean_memory},
-                 {DNNL_ARG_VARIANCE, variance_memory}});
-  s.wait();
-  read_from_dnnl_memory(out, dst_memory);
-  free(weight);
+                        int p_H_, int p_W_, int p_E_, int p_const_,
+                        DNNLKernelHandle* p_handle_) {
+  DNNLContext* ctx = DNNLContext::ThreadLocal();
+  std::lock_guard<std::mutex> lock(p_handle_->mutex);
+  BatchNormKernel* kernel = GetKernel<BatchNormKernel>(p_handle_, [&]() {
+        return new BatchNormKernel(gamma, beta, p_N_, p_C_, p_H_, p_W_, p_E_, p_const_, ctx);
+      });
+  kernel->Run(data, gamma, beta, mean, variance, out, ctx);
 }
 
+class AddKernel {
+ public:
+  AddKernel(int p_N_, int p_C_, int p_H_, int p_W_, DNNLContext* ctx) {
+    memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
+    auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
+
+    auto add_desc = binary::desc(algorithm::binary_add, data_md, data_md, data_md);
+    auto add_prim_desc = binary::primitive_desc(add_desc, ctx->eng);
+    assert(data_md == add_prim_desc.dst_desc());
+
+    add_ = binary(add_prim_desc);
+    data_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+    weight_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+    dst_ = memory(data_md, ctx->eng, DNNL_MEMORY_NONE);
+  }
+
+  void Run(float* data, float* weight, float* out, DNNLContext* ctx) {
+    data_.set_data_handle(data);
+    weight_.set_data_handle(weight);
+    dst_.set_data_handle(out);
+    add_.execute(ctx->strm, {{DNNL_ARG_SRC_0, data_},
+                             {DNNL_ARG_SRC_1, weight_},
+                             {DNNL_ARG_DST, dst_}});
+    ctx->strm.wait();
+  }
+
+ private:
+  binary add_;
+  memory data_, weight_, dst_;
+};
+
 extern "C" void dnnl_add(float* data, float* weight, float* out, int p_N_,
-                         int p_C_, int p_H_, int p_W_) {
-  using tag = memory::format_tag;
-  using dt = memory::data_type;
-
-  engine eng(engine::kind::cpu, 0);
-  stream s(eng);
-
-  memory::dims data_tz = {p_N_, p_C_, p_H_, p_W_};
-
-  auto data_md = memory::desc{{data_tz}, dt::f32, tag::nchw};
-  auto weight_md = memory::desc({{data_tz}, dt::f32, tag::nchw});
-  auto dst_md = memory::desc({{data_tz}, dt::f32, tag::nchw});
-
-  auto data_memory = memory(data_md, eng, data);
-  auto weight_memory = memory(weight_md, eng, weight);
-  auto dst_memory = memory(dst_md, eng);
-
-  auto add_desc =
-      binary::desc(algorithm::binary_add, data_md, weight_md, dst_md);
-  auto add_prim_desc = binary::primitive_desc(add_desc, eng);
-  assert(dst_md == add_prim_desc.dst_desc());
-
-  auto add = binary(add_prim_desc);
-  add.execute(s, {{DNNL_ARG_SRC_0, data_memory},
-                  {DNNL_ARG_SRC_1, weight_memory},
-                  {DNNL_ARG_DST, dst_memory}});
-  s.wait();
-  read_from_dnnl_memory(out, dst_memory);
+                         int p_C_, int p_H_, int p_W_,
+                         DNNLKernelHandle* p_handle_) {
+  DNNLContext* ctx = DNNLContext::ThreadLocal();
+  std::lock_guard<std::mutex> lock(p_handle_->mutex);
+  AddKernel* kernel = GetKernel<AddKernel>(
+      p_handle_, [&]() { return new AddKernel(p_N_, p_C_, p_H_, p_W_, ctx); });
+  kernel->Run(data, weight, out, ctx);
 }
 
 }  // namespace contrib
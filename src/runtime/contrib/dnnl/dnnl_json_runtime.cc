@@ -0,0 +1,690 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/dnnl/dnnl_json_runtime.cc
+ * \brief Execute the partitioned subgraphs serialized as JSON with DNNL.
+ *
+ *  One module holds all the DNNL subgraphs of a relay module and dispatches
+ *  by symbol. The network of primitives of a subgraph is built once at its
+ *  first call:
+ *  - Tensors between the ops stay in the blocked layouts picked by DNNL,
+ *    only the inputs and the output are in plain layout.
+ *  - bias_add, add and relu that follow a conv2d or dense are fused into
+ *    it as bias, sum and eltwise post-ops.
+ *  - Constant weights are reordered once. Intermediate buffers are allocated
+ *    once and shared by tensors whose lifetimes do not overlap.
+ *  Later calls only bind the argument buffers and execute the network.
+ */
+#include <dmlc/json.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dnnl.hpp"
+
+namespace tvm {
+namespace runtime {
+namespace contrib {
+
+using namespace dnnl;
+
+/*! \brief A node of the serialized subgraph. */
+struct DNNLJSONNode {
+  /*! \brief The op name, or "input" and "const" for the leaves. */
+  std::string op;
+  /*! \brief The name of the node. */
+  std::string name;
+  /*! \brief The node ids of the inputs. */
+  std::vector<int> inputs;
+  /*! \brief The shape of the (first) output. */
+  std::vector<int64_t> shape;
+  /*! \brief The attributes of the op. */
+  std::map<std::string, std::vector<double> > attrs;
+
+  void Load(dmlc::JSONReader* reader) {
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareField("op", &op);
+    helper.DeclareOptionalField("name", &name);
+    helper.DeclareOptionalField("inputs", &inputs);
+    helper.DeclareField("shape", &shape);
+    helper.DeclareOptionalField("attrs", &attrs);
+    helper.ReadAllFields(reader);
+  }
+
+  std::vector<int64_t> IntAttr(const std::string& key) const {
+    auto it = attrs.find(key);
+    CHECK(it != attrs.end()) << "Missing attribute " << key << " of " << op;
+    return std::vector<int64_t>(it->second.begin(), it->second.end());
+  }
+
+  double FloatAttr(const std::string& key) const {
+    auto it = attrs.find(key);
+    CHECK(it != attrs.end() && it->second.size() == 1)
+        << "Missing attribute " << key << " of " << op;
+    return it->second[0];
+  }
+};
+
+/*! \brief The serialized subgraph. */
+struct DNNLJSONGraph {
+  /*! \brief The nodes in topological order. */
+  std::vector<DNNLJSONNode> nodes;
+  /*! \brief The input nodes in the order of the function arguments. */
+  std::vector<int> arg_nodes;
+  /*! \brief The output node. */
+  std::vector<int> heads;
+
+  void Load(dmlc::JSONReader* reader) {
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareField("nodes", &nodes);
+    helper.DeclareField("arg_nodes", &arg_nodes);
+    helper.DeclareField("heads", &heads);
+    helper.ReadAllFields(reader);
+  }
+};
+
+/*! \brief A subgraph executed as a network of DNNL primitives. */
+class DNNLJSONSubgraph {
+ public:
+  DNNLJSONSubgraph(std::string symbol_name, std::string graph_json,
+                   std::vector<NDArray> consts)
+      : symbol_name_(symbol_name), graph_json_(graph_json), consts_(consts) {
+    std::istringstream is(graph_json_);
+    dmlc::JSONReader reader(&is);
+    graph_.Load(&reader);
+    CHECK_EQ(graph_.heads.size(), 1U) << "Only support a single output";
+  }
+
+  /*!
+   * \brief Run the subgraph on the arguments, the output is the last one.
+   *  The network and its intermediate buffers are shared, so concurrent
+   *  calls are serialized.
+   */
+  void Run(TVMArgs args) {
+    CHECK_EQ(static_cast<size_t>(args.size()), graph_.arg_nodes.size() + 1)
+        << symbol_name_ << " expects " << graph_.arg_nodes.size() + 1 << " arguments";
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (net_.empty()) this->Build();
+    for (size_t i = 0; i < graph_.arg_nodes.size(); ++i) {
+      DLTensor* arg = args[i];
+      entries_[graph_.arg_nodes[i]].set_data_handle(DataHandle(arg));
+    }
+    DLTensor* out = args[args.size() - 1];
+    output_.set_data_handle(DataHandle(out));
+    for (const auto& step : net_) {
+      step();
+    }
+    stream_.wait();
+  }
+
+  void Save(dmlc::Stream* stream) const {
+    stream->Write(symbol_name_);
+    stream->Write(graph_json_);
+    uint64_t num_consts = consts_.size();
+    stream->Write(num_consts);
+    for (const auto& c : consts_) {
+      c.Save(stream);
+    }
+  }
+
+  static std::unique_ptr<DNNLJSONSubgraph> Load(dmlc::Stream* stream) {
+    std::string symbol_name, graph_json;
+    uint64_t num_consts;
+    CHECK(stream->Read(&symbol_name)) << "Invalid dnnl_json binary";
+    CHECK(stream->Read(&graph_json)) << "Invalid dnnl_json binary";
+    CHECK(stream->Read(&num_consts)) << "Invalid dnnl_json binary";
+    std::vector<NDArray> consts(num_consts);
+    for (uint64_t i = 0; i < num_consts; ++i) {
+      CHECK(consts[i].Load(stream)) << "Invalid dnnl_json binary";
+    }
+    return std::unique_ptr<DNNLJSONSubgraph>(
+        new DNNLJSONSubgraph(symbol_name, graph_json, consts));
+  }
+
+  const std::string& symbol_name() const { return symbol_name_; }
+
+ private:
+  /*! \brief The ops fused into a conv2d or dense. */
+  struct PostOps {
+    /*! \brief The fused nodes, the last one holds the result. */
+    std::vector<int> chain;
+    int bias{-1};
+    int sum{-1};
+    bool relu{false};
+  };
+
+  static memory::format_tag PlainTag(size_t ndim) {
+    switch (ndim) {
+      case 1: return memory::format_tag::a;
+      case 2: return memory::format_tag::ab;
+      case 3: return memory::format_tag::abc;
+      case 4: return memory::format_tag::abcd;
+      case 5: return memory::format_tag::abcde;
+      default: LOG(FATAL) << "Unsupported rank " << ndim;
+    }
+    return memory::format_tag::undef;
+  }
+
+  static void* DataHandle(const DLTensor* tensor) {
+    CHECK(tensor->strides == nullptr) << "DNNL arguments must be compact";
+    return static_cast<char*>(tensor->data) + tensor->byte_offset;
+  }
+
+  static memory::desc PlainDesc(const memory::dims& dims) {
+    return memory::desc(dims, memory::data_type::f32, PlainTag(dims.size()));
+  }
+
+  void Build() {
+    engine_ = engine(engine::kind::cpu, 0);
+    stream_ = stream(engine_);
+    const auto& nodes = graph_.nodes;
+    head_ = graph_.heads[0];
+    entries_.assign(nodes.size(), memory());
+    entry_buf_.assign(nodes.size(), -1);
+    is_input_.assign(nodes.size(), false);
+    uses_.assign(nodes.size(), 0);
+    consumer_.assign(nodes.size(), -1);
+    for (size_t nid = 0; nid < nodes.size(); ++nid) {
+      for (int in : nodes[nid].inputs) {
+        ++uses_[in];
+        consumer_[in] = static_cast<int>(nid);
+      }
+    }
+    ++uses_[head_];
+    output_ = memory(PlainDesc(nodes[head_].shape), engine_, DNNL_MEMORY_NONE);
+
+    std::vector<bool> fused(nodes.size(), false);
+    size_t const_idx = 0;
+    for (size_t nid = 0; nid < nodes.size(); ++nid) {
+      if (fused[nid]) continue;
+      const auto& node = nodes[nid];
+      int id = static_cast<int>(nid);
+      if (node.op == "input") {
+        entries_[id] = memory(PlainDesc(node.shape), engine_, DNNL_MEMORY_NONE);
+        is_input_[id] = true;
+        continue;
+      }
+      if (node.op == "const") {
+        CHECK_LT(const_idx, consts_.size());
+        entries_[id] = memory(PlainDesc(node.shape), engine_, consts_[const_idx++]->data);
+        continue;
+      }
+      std::vector<int> consumed = node.inputs;
+      if (node.op == "nn.conv2d" || node.op == "nn.dense") {
+        PostOps post = MatchPostOps(id);
+        for (size_t i = 1; i < post.chain.size(); ++i) {
+          fused[post.chain[i]] = true;
+        }
+        if (post.bias >= 0) consumed.push_back(post.bias);
+        if (post.sum >= 0) consumed.push_back(post.sum);
+        if (node.op == "nn.conv2d") {
+          Conv2d(id, post);
+        } else {
+          Dense(id, post);
+        }
+      } else if (node.op == "nn.relu") {
+        Relu(id);
+      } else if (node.op == "add" || node.op == "nn.bias_add") {
+        Add(id);
+      } else if (node.op == "nn.batch_norm") {
+        BatchNorm(id);
+      } else {
+        LOG(FATAL) << "Unsupported op: " << node.op;
+      }
+      // buffers of the tensors and temporaries that are no longer used.
+      for (int in : consumed) {
+        if (--uses_[in] == 0) Release(entry_buf_[in]);
+      }
+      for (int buf : temps_) Release(buf);
+      temps_.clear();
+    }
+    if (entries_[head_] != output_) {
+      AddReorder(entries_[head_], output_);
+    }
+  }
+
+  /*! \brief Collect the single-use chain of ops that can be fused into id. */
+  PostOps MatchPostOps(int id) {
+    const auto& nodes = graph_.nodes;
+    PostOps post;
+    post.chain.push_back(id);
+    int cur = id;
+    while (uses_[cur] == 1 && consumer_[cur] >= 0) {
+      int next = consumer_[cur];
+      const auto& node = nodes[next];
+      // the extra operands must be computed before the anchor op.
+      if (node.op == "nn.bias_add" && post.bias < 0 && post.sum < 0 && !post.relu &&
+          node.inputs[0] == cur && node.inputs[1] < id) {
+        int64_t axis = node.IntAttr("axis")[0];
+        if (axis != 1 && axis != 1 - static_cast<int64_t>(node.shape.size())) break;
+        post.bias = node.inputs[1];
+      } else if (node.op == "add" && post.sum < 0 && !post.relu) {
+        int other = node.inputs[0] == cur ? node.inputs[1] : node.inputs[0];
+        if (other == cur || other > id || nodes[other].shape != nodes[cur].shape) break;
+        post.sum = other;
+      } else if (node.op == "nn.relu" && !post.relu) {
+        post.relu = true;
+      } else {
+        break;
+      }
+      post.chain.push_back(next);
+      cur = next;
+    }
+    return post;
+  }
+
+  primitive_attr MakeAttr(const PostOps& post) {
+    post_ops ops;
+    if (post.sum >= 0) ops.append_sum(1.f);
+    if (post.relu) ops.append_eltwise(1.f, algorithm::eltwise_relu, 0.f, 0.f);
+    primitive_attr attr;
+    attr.set_post_ops(ops);
+    return attr;
+  }
+
+  void Conv2d(int id, const PostOps& post) {
+    const auto& node = graph_.nodes[id];
+    int data = node.inputs[0], weight = node.inputs[1];
+    memory::dims src_dims = graph_.nodes[data].shape;
+    memory::dims w_dims = graph_.nodes[weight].shape;
+    memory::dims dst_dims = node.shape;
+    std::vector<int64_t> strides = node.IntAttr("strides");
+    std::vector<int64_t> padding = node.IntAttr("padding");
+    std::vector<int64_t> dilation = node.IntAttr("dilation");
+    int64_t groups = node.IntAttr("groups")[0];
+    CHECK_EQ(padding.size(), 4U);
+
+    memory::format_tag w_tag = memory::format_tag::oihw;
+    if (groups > 1) {
+      w_dims = {groups, w_dims[0] / groups, w_dims[1], w_dims[2], w_dims[3]};
+      w_tag = memory::format_tag::goihw;
+    }
+    memory::dims dilates = {dilation[0] - 1, dilation[1] - 1};
+    memory::dims pad_l = {padding[0], padding[1]};
+    memory::dims pad_r = {padding[2], padding[3]};
+    auto any = memory::format_tag::any;
+    auto f32 = memory::data_type::f32;
+    auto src_md = memory::desc(src_dims, f32, any);
+    auto w_md = memory::desc(w_dims, f32, any);
+    auto dst_md = memory::desc(dst_dims, f32, any);
+
+    convolution_forward::primitive_desc pd;
+    if (post.bias >= 0) {
+      auto bias_md = memory::desc({dst_dims[1]}, f32, any);
+      pd = convolution_forward::primitive_desc(
+          convolution_forward::desc(prop_kind::forward_inference,
+                                    algorithm::convolution_direct, src_md, w_md, bias_md,
+                                    dst_md, strides, dilates, pad_l, pad_r),
+          MakeAttr(post), engine_);
+    } else {
+      pd = convolution_forward::primitive_desc(
+          convolution_forward::desc(prop_kind::forward_inference,
+                                    algorithm::convolution_direct, src_md, w_md,
+                                    dst_md, strides, dilates, pad_l, pad_r),
+          MakeAttr(post), engine_);
+    }
+    memory w_user = View(weight, memory::desc(w_dims, f32, w_tag));
+    std::unordered_map<int, memory> args = {
+      {DNNL_ARG_SRC, Prepare(entries_[data], pd.src_desc())},
+      {DNNL_ARG_WEIGHTS, PrepareWeights(weight, w_user, pd.weights_desc())}};
+    if (post.bias >= 0) {
+      memory bias_user = View(post.bias, PlainDesc({dst_dims[1]}));
+      args[DNNL_ARG_BIAS] = PrepareWeights(post.bias, bias_user, pd.bias_desc());
+    }
+    Execute(convolution_forward(pd), args, post, pd.dst_desc());
+  }
+
+  void Dense(int id, const PostOps& post) {
+    const auto& node = graph_.nodes[id];
+    int data = node.inputs[0], weight = node.inputs[1];
+    memory::dims src_dims = graph_.nodes[data].shape;
+    memory::dims w_dims = graph_.nodes[weight].shape;
+    memory::dims dst_dims = node.shape;
+    auto any = memory::format_tag::any;
+    auto f32 = memory::data_type::f32;
+    auto src_md = memory::desc(src_dims, f32, any);
+    auto w_md = memory::desc(w_dims, f32, any);
+    auto dst_md = memory::desc(dst_dims, f32, any);
+
+    inner_product_forward::primitive_desc pd;
+    if (post.bias >= 0) {
+      auto bias_md = memory::desc({dst_dims[1]}, f32, any);
+      pd = inner_product_forward::primitive_desc(
+          inner_product_forward::desc(prop_kind::forward_inference, src_md, w_md,
+                                      bias_md, dst_md),
+          MakeAttr(post), engine_);
+    } else {
+      pd = inner_product_forward::primitive_desc(
+          inner_product_forward::desc(prop_kind::forward_inference, src_md, w_md, dst_md),
+          MakeAttr(post), engine_);
+    }
+    std::unordered_map<int, memory> args = {
+      {DNNL_ARG_SRC, Prepare(entries_[data], pd.src_desc())},
+      {DNNL_ARG_WEIGHTS, PrepareWeights(weight, entries_[weight], pd.weights_desc())}};
+    if (post.bias >= 0) {
+      memory bias_user = View(post.bias, PlainDesc({dst_dims[1]}));
+      args[DNNL_ARG_BIAS] = PrepareWeights(post.bias, bias_user, pd.bias_desc());
+    }
+    Execute(inner_product_forward(pd), args, post, pd.dst_desc());
+  }
+
+  /*! \brief Run a conv2d or dense with its fused sum, and record the result. */
+  void Execute(const primitive& prim, std::unordered_map<int, memory> args,
+               const PostOps& post, const memory::desc& dst_md) {
+    int out = post.chain.back();
+    memory dst = Alloc(dst_md, out);
+    if (post.sum >= 0) {
+      // the sum post-op accumulates into the destination.
+      AddReorder(entries_[post.sum], dst);
+    }
+    args[DNNL_ARG_DST] = dst;
+    AddPrimitive(prim, args);
+    entries_[out] = dst;
+  }
+
+  void Relu(int id) {
+    memory src = entries_[graph_.nodes[id].inputs[0]];
+    auto pd = eltwise_forward::primitive_desc(
+        eltwise_forward::desc(prop_kind::forward_inference, algorithm::eltwise_relu,
+                              src.get_desc(), 0.f),
+        engine_);
+    memory dst = Alloc(pd.dst_desc(), id);
+    AddPrimitive(eltwise_forward(pd), {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}});
+    entries_[id] = dst;
+  }
+
+  void Add(int id) {
+    const auto& node = graph_.nodes[id];
+    int lhs = node.inputs[0], rhs = node.inputs[1];
+    if (node.op == "add" && graph_.nodes[lhs].shape != node.shape) std::swap(lhs, rhs);
+    CHECK(graph_.nodes[lhs].shape == node.shape) << "Unsupported broadcast in " << node.op;
+    memory src0 = entries_[lhs];
+    memory src1 = entries_[rhs];
+    if (graph_.nodes[rhs].shape != node.shape) {
+      // broadcast the operand along the missing dimensions.
+      memory::dims dims(node.shape.size(), 1);
+      const auto& shape = graph_.nodes[rhs].shape;
+      if (node.op == "nn.bias_add") {
+        dims[1] = shape[0];
+      } else {
+        CHECK_LE(shape.size(), dims.size());
+        std::copy(shape.begin(), shape.end(), dims.end() - shape.size());
+      }
+      src1 = View(rhs, PlainDesc(dims));
+    }
+    auto pd = binary::primitive_desc(
+        binary::desc(algorithm::binary_add, src0.get_desc(), src1.get_desc(),
+                     src0.get_desc()),
+        engine_);
+    memory dst = Alloc(pd.dst_desc(), id);
+    AddPrimitive(binary(pd), {{DNNL_ARG_SRC_0, src0},
+                              {DNNL_ARG_SRC_1, src1},
+                              {DNNL_ARG_DST, dst}});
+    entries_[id] = dst;
+  }
+
+  void BatchNorm(int id) {
+    const auto& node = graph_.nodes[id];
+    int data = node.inputs[0], gamma = node.inputs[1], beta = node.inputs[2];
+    memory src = entries_[data];
+    auto pd = batch_normalization_forward::primitive_desc(
+        batch_normalization_forward::desc(
+            prop_kind::forward_inference, src.get_desc(),
+            static_cast<float>(node.FloatAttr("epsilon")),
+            normalization_flags::use_global_stats | normalization_flags::use_scale_shift),
+        engine_);
+    // scale and shift are packed into one buffer.
+    memory scale_shift(pd.weights_desc(), engine_);
+    int64_t channels = node.shape[1];
+    memory gamma_mem = entries_[gamma], beta_mem = entries_[beta];
+    auto pack = [scale_shift, gamma_mem, beta_mem, channels]() {
+      float* dst = static_cast<float*>(scale_shift.get_data_handle());
+      const float* g = static_cast<const float*>(gamma_mem.get_data_handle());
+      const float* b = static_cast<const float*>(beta_mem.get_data_handle());
+      std::copy(g, g + channels, dst);
+      std::copy(b, b + channels, dst + channels);
+    };
+    if (is_input_[gamma] || is_input_[beta]) {
+      net_.push_back(pack);
+    } else {
+      pack();
+    }
+    memory dst = Alloc(pd.dst_desc(), id);
+    AddPrimitive(batch_normalization_forward(pd),
+                 {{DNNL_ARG_SRC, src},
+                  {DNNL_ARG_MEAN, Prepare(entries_[node.inputs[3]], pd.mean_desc())},
+                  {DNNL_ARG_VARIANCE, Prepare(entries_[node.inputs[4]], pd.variance_desc())},
+                  {DNNL_ARG_SCALE_SHIFT, scale_shift},
+                  {DNNL_ARG_DST, dst}});
+    entries_[id] = dst;
+  }
+
+  /*!
+   * \brief Reinterpret the plain data of an entry with another shape, the view
+   *  follows the argument buffer when the entry is a function input.
+   */
+  memory View(int eid, const memory::desc& md) {
+    memory src = entries_[eid];
+    if (src.get_desc() == md) return src;
+    CHECK(src.get_desc() == PlainDesc(graph_.nodes[eid].shape))
+        << "Cannot reinterpret a tensor in blocked layout";
+    memory view(md, engine_, is_input_[eid] ? DNNL_MEMORY_NONE : src.get_data_handle());
+    if (is_input_[eid]) {
+      net_.push_back([src, view]() mutable {
+        view.set_data_handle(src.get_data_handle());
+      });
+    }
+    return view;
+  }
+
+  /*! \brief Get the tensor in the layout wanted by a primitive. */
+  memory Prepare(const memory& src, const memory::desc& md) {
+    if (src.get_desc() == md) return src;
+    memory dst = AllocTemp(md);
+    AddReorder(src, dst);
+    return dst;
+  }
+
+  /*! \brief Like Prepare, but reorder constant weights once at build time. */
+  memory PrepareWeights(int eid, const memory& src, const memory::desc& md) {
+    if (is_input_[eid] || src.get_desc() == md) return Prepare(src, md);
+    memory user = src, dst(md, engine_);
+    reorder(user, dst).execute(stream_, user, dst);
+    stream_.wait();
+    return dst;
+  }
+
+  void AddPrimitive(const primitive& prim, const std::unordered_map<int, memory>& args) {
+    net_.push_back([this, prim, args]() {
+      prim.execute(stream_, args);
+    });
+  }
+
+  void AddReorder(const memory& src, const memory& dst) {
+    AddPrimitive(reorder(src, dst), {{DNNL_ARG_FROM, src}, {DNNL_ARG_TO, dst}});
+  }
+
+  /*!
+   * \brief Allocate the memory of an entry, the output of the subgraph is
+   *  written directly to the output argument when it is in plain layout.
+   */
+  memory Alloc(const memory::desc& md, int eid) {
+    if (eid == head_ && md == output_.get_desc()) {
+      return output_;
+    }
+    int buf = AllocBuffer(md.get_size());
+    entry_buf_[eid] = buf;
+    return memory(md, engine_, buffers_[buf]->data);
+  }
+
+  memory AllocTemp(const memory::desc& md) {
+    int buf = AllocBuffer(md.get_size());
+    temps_.push_back(buf);
+    return memory(md, engine_, buffers_[buf]->data);
+  }
+
+  /*! \brief Get the smallest free buffer that fits, or a new one. */
+  int AllocBuffer(size_t bytes) {
+    int best = -1;
+    for (size_t i = 0; i < free_.size(); ++i) {
+      size_t size = buffers_[free_[i]]->shape[0];
+      if (size >= bytes &&
+          (best < 0 || size < static_cast<size_t>(buffers_[free_[best]]->shape[0]))) {
+        best = static_cast<int>(i);
+      }
+    }
+    if (best >= 0) {
+      int buf = free_[best];
+      free_.erase(free_.begin() + best);
+      return buf;
+    }
+    DLContext ctx{kDLCPU, 0};
+    buffers_.push_back(NDArray::Empty({static_cast<int64_t>(bytes)},
+                                      DLDataType{kDLUInt, 8, 1}, ctx));
+    return static_cast<int>(buffers_.size()) - 1;
+  }
+
+  void Release(int buf) {
+    if (buf >= 0) free_.push_back(buf);
+  }
+
+  /*! \brief The symbol name of the subgraph function. */
+  std::string symbol_name_;
+  /*! \brief The serialized subgraph. */
+  std::string graph_json_;
+  /*! \brief The constants in the order of the const nodes. */
+  std::vector<NDArray> consts_;
+  /*! \brief The parsed subgraph. */
+  DNNLJSONGraph graph_;
+  /*! \brief Guards the network and the memory bound to it across calls. */
+  std::mutex mutex_;
+  /*! \brief The engine and stream of the subgraph. */
+  engine engine_;
+  stream stream_;
+  /*! \brief The steps of the network in execution order. */
+  std::vector<std::function<void()> > net_;
+  /*! \brief The memory of each node. */
+  std::vector<memory> entries_;
+  /*! \brief The memory bound to the output argument. */
+  memory output_;
+  /*! \brief The output node. */
+  int head_{-1};
+  /*! \brief Whether the node is a function input. */
+  std::vector<bool> is_input_;
+  /*! \brief The remaining uses and the last consumer of each node. */
+  std::vector<int> uses_, consumer_;
+  /*! \brief The buffer of each node, -1 if it does not own one. */
+  std::vector<int> entry_buf_;
+  /*! \brief The intermediate buffers, the free ones and the temporaries of an op. */
+  std::vector<NDArray> buffers_;
+  std::vector<int> free_, temps_;
+};
+
+/*! \brief The module of the DNNL subgraphs, dispatched by symbol. */
+class DNNLJSONRuntime : public ModuleNode {
+ public:
+  explicit DNNLJSONRuntime(std::vector<std::unique_ptr<DNNLJSONSubgraph> > subgraphs)
+      : subgraphs_(std::move(subgraphs)) {
+    for (size_t i = 0; i < subgraphs_.size(); ++i) {
+      CHECK(symbol_index_.emplace(subgraphs_[i]->symbol_name(), i).second)
+          << "Duplicate DNNL subgraph " << subgraphs_[i]->symbol_name();
+    }
+  }
+
+  const char* type_key() const final { return "dnnl_json"; }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const ObjectPtr<Object>& sptr_to_self) final {
+    auto it = symbol_index_.find(name);
+    if (it == symbol_index_.end()) return PackedFunc(nullptr);
+    DNNLJSONSubgraph* subgraph = subgraphs_[it->second].get();
+    return PackedFunc([sptr_to_self, subgraph](TVMArgs args, TVMRetValue* rv) {
+      subgraph->Run(args);
+    });
+  }
+
+  void SaveToBinary(dmlc::Stream* stream) final {
+    uint64_t num_subgraphs = subgraphs_.size();
+    stream->Write(num_subgraphs);
+    for (const auto& subgraph : subgraphs_) {
+      subgraph->Save(stream);
+    }
+  }
+
+  static Module LoadFromBinary(void* strm) {
+    dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+    uint64_t num_subgraphs;
+    CHECK(stream->Read(&num_subgraphs)) << "Invalid dnnl_json binary";
+    std::vector<std::unique_ptr<DNNLJSONSubgraph> > subgraphs;
+    for (uint64_t i = 0; i < num_subgraphs; ++i) {
+      subgraphs.push_back(DNNLJSONSubgraph::Load(stream));
+    }
+    auto n = make_object<DNNLJSONRuntime>(std::move(subgraphs));
+    return Module(n);
+  }
+
+ private:
+  /*! \brief The subgraphs in the order they are serialized. */
+  std::vector<std::unique_ptr<DNNLJSONSubgraph> > subgraphs_;
+  /*! \brief The index of each subgraph by symbol. */
+  std::unordered_map<std::string, size_t> symbol_index_;
+};
+
+// The arguments are the symbol, the JSON graph, the number of constants
+// and the constants of each subgraph in turn.
+TVM_REGISTER_GLOBAL("module.dnnl_json_module_create")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    std::vector<std::unique_ptr<DNNLJSONSubgraph> > subgraphs;
+    int i = 0;
+    while (i < args.size()) {
+      CHECK_LE(i + 3, args.size()) << "Invalid arguments of dnnl_json_module_create";
+      std::string symbol_name = args[i];
+      std::string graph_json = args[i + 1];
+      int num_consts = args[i + 2];
+      CHECK_LE(i + 3 + num_consts, args.size())
+          << "Invalid arguments of dnnl_json_module_create";
+      std::vector<NDArray> consts;
+      for (int j = 0; j < num_consts; ++j) {
+        consts.push_back(args[i + 3 + j]);
+      }
+      subgraphs.emplace_back(new DNNLJSONSubgraph(symbol_name, graph_json, consts));
+      i += 3 + num_consts;
+    }
+    auto n = make_object<DNNLJSONRuntime>(std::move(subgraphs));
+    *rv = Module(n);
+  });
+
+TVM_REGISTER_GLOBAL("module.loadbinary_dnnl_json")
+.set_body_typed(DNNLJSONRuntime::LoadFromBinary);
+
+}  // namespace contrib
+}  // namespace runtime
+}  // namespace tvm
@@ -26,6 +26,9 @@
 #define TVM_RUNTIME_CONTRIB_DNNL_DNNL_KERNEL_H_
 
 #include <tvm/runtime/c_runtime_api.h>
+
+#include <mutex>
+
 #include "dnnl.hpp"
 
 namespace tvm {
@@ -34,21 +37,44 @@ namespace contrib {
 
 using namespace dnnl;
 
+/*!
+ * \brief The kernel of one call site, owned by the generated code.
+ *
+ *  The kernel is created on the first call and keeps the primitive and the
+ *  constant weights reordered into its layout. It is freed together with the
+ *  handle, so a reloaded library never sees the kernel of a previous one.
+ */
+struct DNNLKernelHandle {
+  void* kernel{nullptr};
+  void (*deleter)(void*){nullptr};
+  std::mutex mutex;
+
+  ~DNNLKernelHandle() {
+    if (deleter != nullptr) deleter(kernel);
+  }
+};
+
+/*
+ * p_const_ tells that the weights are constant, so they are reordered into
+ * the layout of the primitive only once.
+ */
 extern "C" TVM_DLL void dnnl_conv2d(float* data, float* weights, float* out, int p_N_, int p_C_,
                                     int p_H_, int p_W_, int p_O_, int p_G_, int p_Ph_, int p_Pw_,
-                                    int p_Kh_, int p_Kw_, int p_Sh_, int p_Sw_);
+                                    int p_Kh_, int p_Kw_, int p_Sh_, int p_Sw_, int p_const_,
+                                    DNNLKernelHandle* p_handle_);
 
 extern "C" TVM_DLL void dnnl_dense(float* data, float* weight, float* out, int p_B_, int p_I_,
-                                   int p_O_);
+                                   int p_O_, int p_const_, DNNLKernelHandle* p_handle_);
 
-extern "C" TVM_DLL void dnnl_relu(float* data, float* out, int p_N_, int p_C_, int p_H_, int p_W_);
+extern "C" TVM_DLL void dnnl_relu(float* data, float* out, int p_N_, int p_C_, int p_H_, int p_W_,
+                                  DNNLKernelHandle* p_handle_);
 
 extern "C" TVM_DLL void dnnl_bn(float* data, float* gamma, float* beta, float* mean,
                                 float* variance, float* out, int p_n_, int p_c_, int p_h_, int p_w_,
-                                int p_e_);
+                                int p_e_, int p_const_, DNNLKernelHandle* p_handle_);
 
 extern "C" TVM_DLL void dnnl_add(float* data, float* weight, float* out, int p_n_, int p_c_,
-                                 int p_h_, int p_w_);
+                                 int p_h_, int p_w_, DNNLKernelHandle* p_handle_);
 
 }  // namespace contrib
 }  // namespace runtime
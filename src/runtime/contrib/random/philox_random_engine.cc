@@ -0,0 +1,253 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox_random_engine.cc
+ * \brief Counter-based Philox4x32-10 random engine
+ */
+#include <dmlc/logging.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief Philox4x32-10 from "Parallel Random Numbers: As Easy as 1, 2, 3"
+ *  (Salmon et al., SC'11). Each counter is mapped to a block of 4 numbers,
+ *  the i-th number of a stream only depends on the key and i.
+ */
+struct Philox4x32 {
+  /*!
+   * \brief Generate the block of numbers of a counter.
+   * \param key The key of the stream.
+   * \param counter The counter of the block.
+   * \param out The 4 generated numbers.
+   */
+  static void Generate(uint64_t key, uint64_t counter, uint32_t out[4]) {
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = 0, c3 = 0;
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+    for (int round = 0; round < 10; ++round) {
+      uint64_t p0 = static_cast<uint64_t>(0xD2511F53U) * c0;
+      uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57U) * c2;
+      uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t>(p1);
+      c3 = static_cast<uint32_t>(p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += 0x9E3779B9U;
+      k1 += 0xBB67AE85U;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+  /*! \return the index-th number of the stream of key. */
+  static uint32_t Get(uint64_t key, uint64_t index) {
+    uint32_t block[4];
+    Generate(key, index / 4, block);
+    return block[index % 4];
+  }
+};
+
+/*!
+ * \brief An interface for generating [tensors of] random numbers.
+ *
+ *  Tensors are filled block by block on the thread pool. The numbers of a
+ *  tensor only depend on the seed and on the number of values drawn before
+ *  since seeding, not on the number of threads.
+ */
+class RandomEngine {
+ public:
+   /*!
+    * \brief Creates a RandomEngine using a default seed.
+    */
+  RandomEngine() {
+    this->Seed(time(0));
+  }
+
+   /*!
+    * \brief Creates a RandomEngine, suggesting the use of a provided seed.
+    */
+  explicit RandomEngine(unsigned seed) {
+    this->Seed(seed);
+  }
+
+   /*!
+    * \brief Seeds the underlying RNG, if possible.
+    */
+  inline void Seed(unsigned seed) {
+    this->rseed_ = static_cast<unsigned>(seed);
+    this->counter_ = 0;
+  }
+
+   /*!
+    * \return the seed associated with the underlying RNG.
+    */
+  inline unsigned GetSeed() const {
+    return rseed_;
+  }
+
+   /*!
+    * \return a random integer sampled from the RNG.
+    */
+  inline unsigned GetRandInt() {
+    uint32_t block[4];
+    Philox4x32::Generate(rseed_, counter_++, block);
+    return block[0];
+  }
+
+   /*!
+    * \brief Fills size elements with integers drawn from [low, high)
+    */
+  template<typename DType>
+  void SampleRandInt(DType* data, int64_t size, int64_t low, int64_t high) {
+    uint64_t range = static_cast<uint64_t>(high - low);
+    FillBlocks(data, size, [low, range](const uint32_t bits[4], DType out[4]) {
+      for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<DType>(low + static_cast<int64_t>(bits[i] % range));
+      }
+    });
+  }
+
+   /*!
+    * \brief Fills a tensor with values drawn from Unif(low, high)
+    */
+  void SampleUniform(DLTensor* data, float low, float high) {
+    CHECK_GT(high, low) << "high must be bigger than low";
+    CHECK(data->strides == nullptr);
+
+    DLDataType dtype = data->dtype;
+    int64_t size = 1;
+    for (int i = 0; i < data->ndim; ++i) {
+      size *= data->shape[i];
+    }
+
+    CHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
+
+    if (data->ctx.device_type == kDLCPU) {
+      float scale = high - low;
+      FillBlocks(static_cast<float*>(data->data), size,
+                 [low, scale](const uint32_t bits[4], float out[4]) {
+        for (int i = 0; i < 4; ++i) {
+          out[i] = low + scale * ToUnit(bits[i]);
+        }
+      });
+    } else {
+      LOG(FATAL) << "Do not support random.uniform on this device yet";
+    }
+  }
+
+   /*!
+    * \brief Fills a tensor with values drawn from Normal(loc, scale**2)
+    */
+  void SampleNormal(DLTensor* data, float loc, float scale) {
+    CHECK_GT(scale, 0) << "standard deviation must be positive";
+    CHECK(data->strides == nullptr);
+
+    DLDataType dtype = data->dtype;
+    int64_t size = 1;
+    for (int i = 0; i < data->ndim; ++i) {
+      size *= data->shape[i];
+    }
+
+    CHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
+
+    if (data->ctx.device_type == kDLCPU) {
+      // Box-Muller transform, each pair of numbers gives two samples.
+      FillBlocks(static_cast<float*>(data->data), size,
+                 [loc, scale](const uint32_t bits[4], float out[4]) {
+        for (int i = 0; i < 4; i += 2) {
+          float radius = scale * std::sqrt(-2.0f * std::log(1.0f - ToUnit(bits[i])));
+          float theta = 6.28318530717958647692f * ToUnit(bits[i + 1]);
+          out[i] = loc + radius * std::cos(theta);
+          out[i + 1] = loc + radius * std::sin(theta);
+        }
+      });
+    } else {
+      LOG(FATAL) << "Do not support random.normal on this device yet";
+    }
+  }
+
+ private:
+  /*! \return a float in [0, 1) from the high 24 bits. */
+  static inline float ToUnit(uint32_t bits) {
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+  }
+
+  /*!
+   * \brief Fill size elements of out from the next blocks of the stream.
+   * \param fblock Transforms the 4 numbers of a block into 4 elements.
+   */
+  template<typename DType, typename FBlock>
+  void FillBlocks(DType* out, int64_t size, const FBlock& fblock) {
+    struct Closure {
+      DType* out;
+      int64_t size;
+      uint64_t key;
+      uint64_t counter;
+      const FBlock* fblock;
+    };
+    int64_t num_blocks = (size + 3) / 4;
+    Closure closure{out, size, rseed_, counter_, &fblock};
+    counter_ += num_blocks;
+    auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+      const Closure* c = static_cast<const Closure*>(cdata);
+      int64_t num_blocks = (c->size + 3) / 4;
+      int64_t step = (num_blocks + penv->num_task - 1) / penv->num_task;
+      int64_t end = std::min(num_blocks, (task_id + 1) * step);
+      uint32_t bits[4];
+      DType values[4];
+      for (int64_t block = task_id * step; block < end; ++block) {
+        Philox4x32::Generate(c->key, c->counter + block, bits);
+        (*c->fblock)(bits, values);
+        int64_t begin = block * 4;
+        int64_t len = std::min<int64_t>(4, c->size - begin);
+        std::copy(values, values + len, c->out + begin);
+      }
+      return 0;
+    };
+    if (size >= kParallelMinElems) {
+      TVMBackendParallelLaunch(flambda, &closure, 0);
+    } else {
+      TVMParallelGroupEnv env;
+      env.sync_handle = nullptr;
+      env.num_task = 1;
+      flambda(0, &env, &closure);
+    }
+  }
+
+  /*! \brief Below this number of elements the tensor is filled in the calling thread. */
+  static constexpr int64_t kParallelMinElems = 1 << 14;
+  /*! \brief The key of the stream. */
+  unsigned rseed_;
+  /*! \brief The counter of the next block. */
+  uint64_t counter_;
+};
+
+}  // namespace contrib
+}  // namespace tvm
@@ -26,7 +26,7 @@
 #include <dmlc/thread_local.h>
 #include <algorithm>
 #ifndef _LIBCPP_SGX_CONFIG
-#include "mt_random_engine.cc"
+#include "philox_random_engine.cc"
 #else
 #include "sgx_random_engine.cc"
 #endif
@@ -71,6 +71,14 @@ RandomThreadLocalEntry* RandomThreadLocalEntry::ThreadLocal() {
 }
 
 
+TVM_REGISTER_GLOBAL("tvm.contrib.random.seed")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+    RandomThreadLocalEntry *entry = RandomThreadLocalEntry::ThreadLocal();
+    int64_t seed = args[0];
+    entry->random_engine.Seed(static_cast<unsigned>(seed));
+  });
+
+
 TVM_REGISTER_GLOBAL("tvm.contrib.random.randint")
 .set_body([](TVMArgs args, TVMRetValue *ret) {
     RandomThreadLocalEntry *entry = RandomThreadLocalEntry::ThreadLocal();
@@ -94,11 +102,7 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.randint")
       high = std::min(high, numeric_high);
 
       if (out->ctx.device_type == kDLCPU) {
-          // file the data with random byte
-          std::generate_n(static_cast<DType*>(out->data), size, [&] () {
-            unsigned rint = entry->random_engine.GetRandInt();
-            return low + rint % (high - low);
-          });
+          entry->random_engine.SampleRandInt(static_cast<DType*>(out->data), size, low, high);
       } else {
         LOG(FATAL) << "Do not support random.randint on this device yet";
       }
@@ -128,3 +132,14 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.normal")
 
 }  // namespace contrib
 }  // namespace tvm
+
+#ifndef _LIBCPP_SGX_CONFIG
+/*!
+ * \brief Get the index-th number of the Philox stream of seed, which is the
+ *  number written at index by randint after seeding. The function is pure, so
+ *  generated code can call it as an extern intrinsic.
+ */
+extern "C" TVM_DLL uint32_t TVMContribRandomPhilox(uint64_t seed, uint64_t index) {
+  return tvm::contrib::Philox4x32::Get(seed, index);
+}
+#endif
@@ -67,6 +67,17 @@ class RandomEngine {
     return rand_int;
   }
 
+   /*!
+    * \brief Fills size elements with integers drawn from [low, high)
+    */
+  template<typename DType>
+  void SampleRandInt(DType* data, int64_t size, int64_t low, int64_t high) {
+    std::generate_n(data, size, [&] () {
+      unsigned rint = GetRandInt();
+      return low + rint % (high - low);
+    });
+  }
+
    /*!
     * \return a random integer sampled from Unif(low, high).
     */
@@ -21,10 +21,13 @@
  * \file Use standard C library call.
  */
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/util.h>
 #include <dlpack/dlpack.h>
 #include <algorithm>
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -32,18 +35,183 @@ namespace contrib {
 
 using namespace runtime;
 
+// Whether a < b, where NaN is larger than every number and equal to NaN.
+// Plain < on NaN is not a strict weak ordering, which std::sort and
+// std::nth_element require.
+template<typename DType>
+inline bool LessWithNaN(DType a, DType b) {
+  if (b != b) return a == a;
+  return a < b;
+}
+
+// Ties are broken by the original index, so the result is the same as a
+// stable sort while std::sort and std::nth_element can be used.
 template<typename DType>
 bool CompareAscend(const std::pair<int64_t, DType>& lhs,
                    const std::pair<int64_t, DType>& rhs) {
-  return lhs.second < rhs.second;
+  return LessWithNaN(lhs.second, rhs.second) ||
+      (!LessWithNaN(rhs.second, lhs.second) && lhs.first < rhs.first);
 }
 
 template<typename DType>
 bool CompareDescend(const std::pair<int64_t, DType>& lhs,
                     const std::pair<int64_t, DType>& rhs) {
-  return lhs.second > rhs.second;
+  return LessWithNaN(rhs.second, lhs.second) ||
+      (!LessWithNaN(lhs.second, rhs.second) && lhs.first < rhs.first);
 }
 
+#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
+typedef __fp16 Half;
+#else
+/*! \brief Storage of a float16 element, sorted without conversion to float. */
+struct Half {
+  uint16_t bits;
+};
+#endif
+
+// The key that elements are compared with.
+template<typename DataType>
+struct SortKey {
+  typedef DataType Type;
+  static Type Get(DataType value) { return value; }
+};
+
+#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC != 1)
+// Map the sign-magnitude bits of a half to an integer of the same order,
+// every NaN is mapped above infinity as in LessWithNaN.
+template<>
+struct SortKey<Half> {
+  typedef int32_t Type;
+  static Type Get(Half value) {
+    int32_t magnitude = value.bits & 0x7fff;
+    if (magnitude > 0x7c00) return 0x8000;
+    return (value.bits & 0x8000) ? -magnitude : magnitude;
+  }
+};
+#endif
+
+// The scratch of the sort, reused across calls by each thread.
+template<typename KeyType>
+std::vector<std::pair<int64_t, KeyType> >* GetSorter() {
+  static thread_local std::vector<std::pair<int64_t, KeyType> > sorter;
+  return &sorter;
+}
+
+// Whether rows are fully sorted one after another in the calling thread, as
+// before the partial and parallel sort. Read once per process, it is only
+// meant for apps/benchmark/sort_bench.py to measure the difference.
+static bool UseBaselineSort() {
+  static const bool baseline = [] {
+    const char* val = getenv("TVM_SORT_BASELINE");
+    return val != nullptr && atoi(val) != 0;
+  }();
+  return baseline;
+}
+
+// Order the first k elements of [begin, end), the rest is left unordered.
+template<typename Iter, typename Compare>
+void SortFirstK(Iter begin, Iter end, int64_t k, Compare cmp) {
+  if (k <= 0) return;
+  if (UseBaselineSort()) {
+    std::stable_sort(begin, end, cmp);
+    return;
+  }
+  if (k < end - begin) {
+    std::nth_element(begin, begin + (k - 1), end, cmp);
+    end = begin + (k - 1);
+  }
+  std::sort(begin, end, cmp);
+}
+
+template<typename KeyType>
+void SortFirstK(std::vector<std::pair<int64_t, KeyType> >* sorter, int64_t k, bool is_ascend) {
+  typedef std::pair<int64_t, KeyType> Entry;
+  if (is_ascend) {
+    SortFirstK(sorter->begin(), sorter->end(), k, [](const Entry& lhs, const Entry& rhs) {
+      return CompareAscend<KeyType>(lhs, rhs);
+    });
+  } else {
+    SortFirstK(sorter->begin(), sorter->end(), k, [](const Entry& lhs, const Entry& rhs) {
+      return CompareDescend<KeyType>(lhs, rhs);
+    });
+  }
+}
+
+// Below this number of elements the rows are sorted in the calling thread.
+constexpr int64_t kParallelSortMinElems = 4096;
+
+// Call frow(i, j) for every row of the sort axis, rows are split evenly
+// among the threads of the pool.
+template<typename FRow>
+void ParallelForRows(int64_t axis_mul_before, int64_t axis_mul_after,
+                     int64_t axis_len, const FRow& frow) {
+  struct Closure {
+    const FRow* frow;
+    int64_t axis_mul_after;
+    int64_t num_rows;
+  };
+  int64_t num_rows = axis_mul_before * axis_mul_after;
+  Closure closure{&frow, axis_mul_after, num_rows};
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    const Closure* c = static_cast<const Closure*>(cdata);
+    int64_t step = (c->num_rows + penv->num_task - 1) / penv->num_task;
+    int64_t end = std::min(c->num_rows, (task_id + 1) * step);
+    for (int64_t row = task_id * step; row < end; ++row) {
+      (*c->frow)(row / c->axis_mul_after, row % c->axis_mul_after);
+    }
+    return 0;
+  };
+  if (num_rows > 1 && num_rows * axis_len >= kParallelSortMinElems && !UseBaselineSort()) {
+    TVMBackendParallelLaunch(flambda, &closure, 0);
+  } else {
+    TVMParallelGroupEnv env;
+    env.sync_handle = nullptr;
+    env.num_task = 1;
+    flambda(0, &env, &closure);
+  }
+}
+
+// Get the number of elements before and after the axis.
+inline void GetAxisMul(const DLTensor* input, int axis,
+                       int64_t* axis_mul_before, int64_t* axis_mul_after) {
+  *axis_mul_before = 1;
+  *axis_mul_after = 1;
+  for (int i = 0; i < input->ndim; ++i) {
+    if (i < axis) {
+      *axis_mul_before *= input->shape[i];
+    } else if (i > axis) {
+      *axis_mul_after *= input->shape[i];
+    }
+  }
+}
+
+template<typename DataType>
+void argsort_nms(DLTensor* input, DLTensor* sort_num, DLTensor* output,
+                 int32_t axis, bool is_ascend) {
+  typedef typename SortKey<DataType>::Type KeyType;
+  const DataType* data_ptr = static_cast<const DataType *>(input->data);
+  const int32_t* sort_num_ptr = static_cast<const int32_t *>(sort_num->data);
+  int32_t* out_ptr = static_cast<int32_t *>(output->data);
+  int64_t axis_len = input->shape[axis];
+  int64_t axis_mul_before, axis_mul_after;
+  GetAxisMul(input, axis, &axis_mul_before, &axis_mul_after);
+
+  ParallelForRows(axis_mul_before, axis_mul_after, axis_len, [&](int64_t i, int64_t j) {
+    auto* sorter = GetSorter<KeyType>();
+    sorter->clear();
+    int64_t current_sort_num = std::min<int64_t>(sort_num_ptr[i * axis_mul_after + j], axis_len);
+    int64_t base_idx = i * axis_len * axis_mul_after + j;
+    for (int64_t k = 0; k < current_sort_num; ++k) {
+      int64_t full_idx = base_idx + k * axis_mul_after;
+      sorter->emplace_back(k, SortKey<DataType>::Get(data_ptr[full_idx]));
+    }
+    SortFirstK(sorter, current_sort_num, is_ascend);
+    for (int64_t k = 0; k < axis_len; ++k) {
+      out_ptr[base_idx + k * axis_mul_after] =
+          static_cast<int32_t>(k < current_sort_num ? (*sorter)[k].first : k);
+    }
+  });
+}
 
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
@@ -60,107 +228,44 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms")
   int32_t axis = args[3];
   bool is_ascend = args[4];
 
-  auto dtype = input->dtype;
-  auto data_ptr = static_cast<float *>(input->data);
-  auto sort_num_ptr = static_cast<int32_t *>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
-  int64_t axis_mul_before = 1;
-  int64_t axis_mul_after = 1;
-
   if (axis < 0) {
     axis = input->ndim + axis;
   }
-
-  // Currently only supports input dtype to be float32.
-  CHECK_EQ(dtype.code, 2) << "Currently only supports input dtype "
-      "to be float.";
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC != 1)
-  CHECK_EQ(dtype.bits, 32) << "Currently only supports input dtype "
-      "to be float32.";
-#endif
   CHECK_LT(axis, input->ndim) << "Axis out of boundary for "
       "input ndim " << input->ndim;
 
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
-
-  for (int64_t i = 0 ; i < axis_mul_before; ++i) {
-    for (int64_t j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < current_sort_num; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
-      }
-      if (is_ascend) {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
-        } else {
-#endif
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-        } else {
-#endif
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      }
-      for (int32_t k = 0; k < input->shape[axis]; ++k) {
-        *(static_cast<int32_t *>(output->data) + base_idx + k * axis_mul_after)
-            = k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
-      }
-    }
+  auto data_dtype = TVMType2String(input->dtype);
+  if (data_dtype == "float32") {
+    argsort_nms<float>(input, sort_num, output, axis, is_ascend);
+  } else if (data_dtype == "float16") {
+    argsort_nms<Half>(input, sort_num, output, axis, is_ascend);
+  } else {
+    LOG(FATAL) << "Currently only supports input dtype to be float, got " << data_dtype;
   }
 });
 
 template<typename DataType, typename OutType>
 void argsort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  auto data_ptr = static_cast<DataType *>(input->data);
-  auto out_ptr = static_cast<OutType *>(output->data);
-  std::vector<std::pair<int64_t, DataType> > sorter;
+  typedef typename SortKey<DataType>::Type KeyType;
+  const DataType* data_ptr = static_cast<const DataType *>(input->data);
+  OutType* out_ptr = static_cast<OutType *>(output->data);
+  int64_t axis_len = input->shape[axis];
+  int64_t axis_mul_before, axis_mul_after;
+  GetAxisMul(input, axis, &axis_mul_before, &axis_mul_after);
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
+  ParallelForRows(axis_mul_before, axis_mul_after, axis_len, [&](int64_t i, int64_t j) {
+    auto* sorter = GetSorter<KeyType>();
+    sorter->clear();
+    int64_t base_idx = i * axis_len * axis_mul_after + j;
+    for (int64_t k = 0; k < axis_len; ++k) {
+      int64_t full_idx = base_idx + k * axis_mul_after;
+      sorter->emplace_back(k, SortKey<DataType>::Get(data_ptr[full_idx]));
     }
-  }
-
-  for (int i = 0 ; i < axis_mul_before; ++i) {
-    for (int j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        out_ptr[base_idx + k * axis_mul_after] = static_cast<OutType>(sorter[k].first);
-      }
+    SortFirstK(sorter, axis_len, is_ascend);
+    for (int64_t k = 0; k < axis_len; ++k) {
+      out_ptr[base_idx + k * axis_mul_after] = static_cast<OutType>((*sorter)[k].first);
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
@@ -209,14 +314,20 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort")
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
   } else if (data_dtype == "float16") {
-    if (out_dtype == "float16") {
+    if (out_dtype == "int32") {
+      argsort<Half, int32_t>(input, output, axis, is_ascend);
+    } else if (out_dtype == "int64") {
+      argsort<Half, int64_t>(input, output, axis, is_ascend);
+    } else if (out_dtype == "float32") {
+      argsort<Half, float>(input, output, axis, is_ascend);
+#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
+    } else if (out_dtype == "float16") {
       argsort<__fp16, __fp16>(input, output, axis, is_ascend);
+#endif
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
-#endif
   } else if (data_dtype == "int32") {
     if (out_dtype == "int32") {
       argsort<int32_t, int32_t>(input, output, axis, is_ascend);
@@ -253,53 +364,43 @@ void topk(DLTensor* input,
           int k,
           int axis,
           bool is_ascend) {
-  DataType* data_ptr = static_cast<DataType *>(input->data);
+  typedef typename SortKey<DataType>::Type KeyType;
+  const DataType* data_ptr = static_cast<const DataType *>(input->data);
   DataType* values_ptr = (out_values == nullptr) ? nullptr :
           static_cast<DataType *>(out_values->data);
   IndicesType* indices_ptr = (out_indices == nullptr) ? nullptr :
           static_cast<IndicesType *>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType> > sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
+  int64_t axis_len = input->shape[axis];
+  int64_t axis_mul_before, axis_mul_after;
+  GetAxisMul(input, axis, &axis_mul_before, &axis_mul_after);
   if (k < 1) {
-    k = input->shape[axis];
+    k = axis_len;
   }
+  int64_t cnt = std::min<int64_t>(k, axis_len);
 
-  for (int i = 0 ; i < axis_mul_before; ++i) {
-    for (int j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-      for (int64_t kk = 0; kk < input->shape[axis]; ++kk) {
-        int64_t full_idx = src_base_idx + kk * axis_mul_after;
-        sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
+  ParallelForRows(axis_mul_before, axis_mul_after, axis_len, [&](int64_t i, int64_t j) {
+    auto* sorter = GetSorter<KeyType>();
+    sorter->clear();
+    int64_t src_base_idx = i * axis_len * axis_mul_after + j;
+    int64_t dst_base_idx = i * k * axis_mul_after + j;
+    for (int64_t kk = 0; kk < axis_len; ++kk) {
+      int64_t full_idx = src_base_idx + kk * axis_mul_after;
+      sorter->emplace_back(kk, SortKey<DataType>::Get(data_ptr[full_idx]));
+    }
+    // only the first k elements are selected and ordered.
+    SortFirstK(sorter, cnt, is_ascend);
+    for (int64_t kk = 0; kk < cnt; ++kk) {
+      int64_t index = (*sorter)[kk].first;
+      if (indices_ptr != nullptr) {
+        indices_ptr[dst_base_idx + kk * axis_mul_after] =
+                static_cast<IndicesType>(index);
       }
-      int64_t cnt = k > 0 ? k : input->shape[axis];
-      for (int64_t kk = 0; kk < cnt; ++kk) {
-        if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-                  static_cast<IndicesType>(sorter[kk].first);
-        }
-        if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] =
-                  static_cast<DataType>(sorter[kk].second);
-        }
+      if (values_ptr != nullptr) {
+        values_ptr[dst_base_idx + kk * axis_mul_after] =
+                data_ptr[src_base_idx + index * axis_mul_after];
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
@@ -360,6 +461,16 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.topk")
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
+  } else if (data_dtype == "float16") {
+    if (out_dtype == "int32") {
+      topk<Half, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
+    } else if (out_dtype == "int64") {
+      topk<Half, int64_t>(input, values_out, indices_out, k, axis, is_ascend);
+    } else if (out_dtype == "float32") {
+      topk<Half, float>(input, values_out, indices_out, k, axis, is_ascend);
+    } else {
+      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
+    }
   } else if (data_dtype == "int32") {
     if (out_dtype == "int32") {
       topk<int32_t, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
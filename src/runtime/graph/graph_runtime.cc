@@ -287,6 +287,8 @@ void GraphRuntime::SetupStorage() {
     pool_entry[sid].device_type = device_type;
   }
 
+  if (SetupArenaStorage(pool_entry, vtype)) return;
+
   // Allocate the space.
   for (const auto& pit : pool_entry) {
     std::vector<int64_t> shape;
@@ -317,6 +319,67 @@ void GraphRuntime::SetupStorage() {
   }
 }
 
+bool GraphRuntime::SetupArenaStorage(const std::vector<PoolEntry>& pool_entry,
+                                     const std::vector<TVMType>& vtype) {
+  if (attrs_.storage_offset.size() != attrs_.shape.size()) return false;
+  // Arena size and storage pool size of each device type.
+  std::unordered_map<int, size_t> arena_size, pool_size;
+  std::vector<size_t> entry_bytes(attrs_.shape.size());
+  for (const auto& pit : pool_entry) {
+    pool_size[pit.device_type] += pit.size;
+  }
+  for (size_t i = 0; i < attrs_.shape.size(); ++i) {
+    int device_type = static_cast<int>(ctxs_[0].device_type);
+    if (!attrs_.device_index.empty()) {
+      device_type = attrs_.device_index[i];
+    }
+    // Sub-buffers are addressed by pointer arithmetic,
+    // which is only valid for these devices.
+    if (device_type != kDLCPU && device_type != kDLCPUPinned &&
+        device_type != kDLGPU && device_type != kDLROCM) {
+      return false;
+    }
+    size_t size = 1;
+    for (int64_t sz : attrs_.shape[i]) {
+      size *= static_cast<size_t>(sz);
+    }
+    size_t bits = vtype[i].bits * vtype[i].lanes;
+    entry_bytes[i] = ((bits + 7U) / 8U) * size;
+    CHECK_GE(attrs_.storage_offset[i], 0);
+    CHECK_EQ(attrs_.storage_offset[i] % kAllocAlignment, 0);
+    size_t end = static_cast<size_t>(attrs_.storage_offset[i]) + entry_bytes[i];
+    arena_size[device_type] = std::max(arena_size[device_type], end);
+  }
+  // Only use the arena when it does not take more memory.
+  for (const auto& kv : arena_size) {
+    if (kv.second > pool_size[kv.first]) return false;
+  }
+  std::unordered_map<int, size_t> arena_index;
+  for (const auto& kv : arena_size) {
+    const auto& cit =
+        std::find_if(ctxs_.begin(), ctxs_.end(), [&kv](const TVMContext& c) {
+          return kv.first == static_cast<int>(c.device_type);
+        });
+    TVMContext ctx = cit == ctxs_.end() ? ctxs_[0] : *cit;
+    std::vector<int64_t> shape{static_cast<int64_t>(kv.second + 3) / 4};
+    arena_index[kv.first] = storage_pool_.size();
+    storage_pool_.push_back(
+        NDArray::Empty(shape, DLDataType{kDLFloat, 32, 1}, ctx));
+  }
+  data_entry_.resize(num_node_entries());
+  data_alignment_.resize(num_node_entries());
+  for (size_t i = 0; i < data_entry_.size(); ++i) {
+    int device_type = static_cast<int>(ctxs_[0].device_type);
+    if (!attrs_.device_index.empty()) {
+      device_type = attrs_.device_index[i];
+    }
+    data_entry_[i] = storage_pool_[arena_index.at(device_type)].CreateView(
+        attrs_.shape[i], vtype[i], static_cast<uint64_t>(attrs_.storage_offset[i]));
+    data_alignment_[i] = details::GetDataAlignment(*data_entry_[i].operator->());
+  }
+  return true;
+}
+
 void GraphRuntime::SetupOpExecs() {
   op_execs_.resize(this->GetNumOfNodes());
   input_dltensors_.resize(num_node_entries());
@@ -326,18 +389,25 @@ void GraphRuntime::SetupOpExecs() {
     input_node_eids.insert(entry_id(nid, 0));
   }
 
+  // Kernels take compact buffers without byte offset, so the offset
+  // of an arena view is folded into the data pointer of the argument.
+  auto kernel_arg = [this](uint32_t eid) {
+    DLTensor arg = *(data_entry_[eid].operator->());
+    arg.data = static_cast<char*>(arg.data) + arg.byte_offset;
+    arg.byte_offset = 0;
+    return arg;
+  };
+
   // setup the array and requirements.
   for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
     const auto& inode = nodes_[nid];
     if (inode.op_type == "null") continue;
     std::vector<DLTensor> args;
     for (const auto& e : inode.inputs) {
-      uint32_t eid = this->entry_id(e);
-      args.push_back(*(data_entry_[eid].operator->()));
+      args.push_back(kernel_arg(this->entry_id(e)));
     }
     for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
-      uint32_t eid = this->entry_id(nid, index);
-      args.push_back(*(data_entry_[eid].operator->()));
+      args.push_back(kernel_arg(this->entry_id(nid, index)));
     }
     CHECK(inode.op_type == "tvm_op") << "Can only take tvm_op as op";
 
@@ -272,6 +272,7 @@ class GraphRuntime : public ModuleNode {
   struct GraphAttr {
     size_t storage_num_not_alloctaed{0};
     std::vector<int> storage_id;
+    std::vector<int64_t> storage_offset;
     std::vector<int> device_index;
     std::vector<std::string> dltype;
     std::vector<std::vector<int64_t> > shape;
@@ -308,6 +309,14 @@ class GraphRuntime : public ModuleNode {
           reader->Read(&shape);
           CHECK(!reader->NextArrayItem());
           bitmask |= 4;
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          CHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          CHECK_EQ(type, "list_int");
+          CHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          CHECK(!reader->NextArrayItem());
         } else if (key == "device_index") {
           reader->BeginArray();
           CHECK(reader->NextArrayItem());
@@ -368,6 +377,15 @@ class GraphRuntime : public ModuleNode {
   }
   /*! \brief Setup the temporal storage */
   void SetupStorage();
+  /*!
+   * \brief Setup the temporal storage as one arena per device,
+   *  using the byte offsets planned at compile time.
+   * \param pool_entry The storage pool of the storage id based plan.
+   * \param vtype The data type of each entry.
+   * \return Whether the arena plan is used.
+   */
+  bool SetupArenaStorage(const std::vector<PoolEntry>& pool_entry,
+                         const std::vector<TVMType>& vtype);
   /*! \brief Setup the executors. */
   void SetupOpExecs();
   /*!
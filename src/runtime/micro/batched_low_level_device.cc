@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file batched_low_level_device.cc
+ * \brief low-level device wrapper that batches memory transactions
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "batched_low_level_device.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief number of unchanged bytes after which a changed run of a mirrored
+ *        write is split into separate uploads
+ */
+constexpr size_t kMaxUnchangedGap = 16;
+
+void BatchedLowLevelDevice::Read(DevPtr addr, void* buffer, size_t num_bytes) {
+  if (!enabled_) {
+    device_->Read(addr, buffer, num_bytes);
+    ++num_device_reads_;
+    return;
+  }
+  uint64_t start = addr.value().val64;
+  uint8_t* bytes = static_cast<uint8_t*>(buffer);
+  MirroredRegion* mirror = FindMirror(start, num_bytes);
+  if (mirror != nullptr) {
+    size_t offset = start - mirror->start;
+    auto valid_begin = mirror->valid.begin() + offset;
+    if (std::all_of(valid_begin, valid_begin + num_bytes, [](bool valid) { return valid; })) {
+      std::copy_n(mirror->data.begin() + offset, num_bytes, bytes);
+      return;
+    }
+  }
+
+  // The device must see the queued writes before it is read.
+  Flush();
+  device_->Read(addr, buffer, num_bytes);
+  ++num_device_reads_;
+  if (mirror != nullptr) {
+    size_t offset = start - mirror->start;
+    std::copy_n(bytes, num_bytes, mirror->data.begin() + offset);
+    std::fill_n(mirror->valid.begin() + offset, num_bytes, true);
+  }
+}
+
+void BatchedLowLevelDevice::Write(DevPtr addr, const void* buffer, size_t num_bytes) {
+  uint64_t start = addr.value().val64;
+  const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+  if (!enabled_) {
+    device_->Write(addr, buffer, num_bytes);
+    ++num_device_writes_;
+    InvalidateMirrors(start, num_bytes);
+    return;
+  }
+  MirroredRegion* mirror = FindMirror(start, num_bytes);
+  if (mirror == nullptr) {
+    // The write may still cover part of a mirrored region.
+    QueueWrite(start, bytes, num_bytes);
+    InvalidateMirrors(start, num_bytes);
+    return;
+  }
+
+  // Only upload the runs of bytes that differ from what the device holds.
+  size_t offset = start - mirror->start;
+  auto unchanged = [&](size_t i) {
+    return mirror->valid[offset + i] && mirror->data[offset + i] == bytes[i];
+  };
+  size_t i = 0;
+  while (i < num_bytes) {
+    if (unchanged(i)) {
+      ++i;
+      continue;
+    }
+    size_t run_start = i;
+    size_t last_changed = i;
+    for (; i < num_bytes && i - last_changed <= kMaxUnchangedGap; ++i) {
+      if (!unchanged(i)) last_changed = i;
+    }
+    QueueWrite(start + run_start, bytes + run_start, last_changed + 1 - run_start);
+    i = last_changed + 1;
+  }
+  std::copy_n(bytes, num_bytes, mirror->data.begin() + offset);
+  std::fill_n(mirror->valid.begin() + offset, num_bytes, true);
+}
+
+void BatchedLowLevelDevice::Execute(DevPtr func_addr, DevPtr breakpoint_addr) {
+  Flush();
+  device_->Execute(func_addr, breakpoint_addr);
+}
+
+void BatchedLowLevelDevice::AddMirroredRegion(DevMemRegion region) {
+  uint64_t start = region.start.value().val64;
+  for (const auto& mirror : mirrors_) {
+    CHECK(start + region.size <= mirror.start || mirror.start + mirror.data.size() <= start)
+        << "mirrored regions must not overlap";
+  }
+  Flush();
+  MirroredRegion mirror;
+  mirror.start = start;
+  mirror.data.resize(region.size);
+  mirror.valid.resize(region.size, false);
+  mirrors_.push_back(std::move(mirror));
+}
+
+void BatchedLowLevelDevice::Flush() {
+  for (const auto& write : pending_writes_) {
+    device_->Write(DevPtr(write.first), write.second.data(), write.second.size());
+    ++num_device_writes_;
+  }
+  pending_writes_.clear();
+}
+
+void BatchedLowLevelDevice::set_enabled(bool enabled) {
+  Flush();
+  enabled_ = enabled;
+}
+
+void BatchedLowLevelDevice::InvalidateMirrors(uint64_t addr, size_t num_bytes) {
+  for (auto& mirror : mirrors_) {
+    uint64_t begin = std::max(addr, mirror.start);
+    uint64_t end = std::min(addr + num_bytes, mirror.start + mirror.data.size());
+    if (begin < end) {
+      std::fill(mirror.valid.begin() + (begin - mirror.start),
+                mirror.valid.begin() + (end - mirror.start), false);
+    }
+  }
+}
+
+BatchedLowLevelDevice::MirroredRegion* BatchedLowLevelDevice::FindMirror(
+    uint64_t addr, size_t num_bytes) {
+  for (auto& mirror : mirrors_) {
+    if (addr >= mirror.start && addr + num_bytes <= mirror.start + mirror.data.size()) {
+      return &mirror;
+    }
+  }
+  return nullptr;
+}
+
+void BatchedLowLevelDevice::QueueWrite(uint64_t addr, const uint8_t* buffer, size_t num_bytes) {
+  if (num_bytes == 0) return;
+  uint64_t merged_start = addr;
+  uint64_t merged_end = addr + num_bytes;
+
+  // Find the queued writes that overlap or are adjacent to the new one.
+  auto first = pending_writes_.upper_bound(addr);
+  if (first != pending_writes_.begin()) {
+    auto prev = std::prev(first);
+    if (prev->first + prev->second.size() >= addr) {
+      first = prev;
+    }
+  }
+  auto last = first;
+  for (; last != pending_writes_.end() && last->first <= merged_end; ++last) {
+    merged_start = std::min(merged_start, last->first);
+    merged_end = std::max(merged_end, last->first + last->second.size());
+  }
+
+  // Merge them, the new bytes take precedence over older queued ones.
+  std::vector<uint8_t> merged(merged_end - merged_start);
+  for (auto it = first; it != last; ++it) {
+    std::copy(it->second.begin(), it->second.end(), merged.begin() + (it->first - merged_start));
+  }
+  std::copy_n(buffer, num_bytes, merged.begin() + (addr - merged_start));
+  pending_writes_.erase(first, last);
+  pending_writes_.emplace(merged_start, std::move(merged));
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file batched_low_level_device.h
+ * \brief low-level device wrapper that batches memory transactions
+ */
+#ifndef TVM_RUNTIME_MICRO_BATCHED_LOW_LEVEL_DEVICE_H_
+#define TVM_RUNTIME_MICRO_BATCHED_LOW_LEVEL_DEVICE_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "micro_common.h"
+#include "low_level_device.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief low-level device that reduces the number of transactions issued to
+ *        another low-level device
+ *
+ * Every transaction with a physical device is a round trip over the debug link
+ * (e.g., OpenOCD), so this wrapper
+ *   1) queues writes and coalesces overlapping or adjacent ones, until a read
+ *      or an execution needs them on the device,
+ *   2) mirrors regions the device never writes to (e.g., code and args) on the
+ *      host, so that reads from them are served locally and writes only upload
+ *      the bytes that changed.
+ */
+class BatchedLowLevelDevice final : public LowLevelDevice {
+ public:
+  /*!
+   * \brief constructor
+   * \param device low-level device all transactions are eventually issued to
+   */
+  explicit BatchedLowLevelDevice(std::shared_ptr<LowLevelDevice> device)
+    : device_(std::move(device)) {}
+
+  void Read(DevPtr addr, void* buffer, size_t num_bytes) final;
+
+  void Write(DevPtr addr, const void* buffer, size_t num_bytes) final;
+
+  void Execute(DevPtr func_addr, DevPtr breakpoint_addr) final;
+
+  const char* device_type() const final {
+    return device_->device_type();
+  }
+
+  /*!
+   * \brief mirror a memory region on the host
+   * \param region device memory region that is only ever written by the host
+   */
+  void AddMirroredRegion(DevMemRegion region);
+
+  /*!
+   * \brief issue all queued writes to the device
+   */
+  void Flush();
+
+  /*!
+   * \brief enable or disable batching, when disabled every transaction is
+   *        issued to the device as is, which serves as a baseline
+   * \param enabled whether to batch transactions
+   */
+  void set_enabled(bool enabled);
+
+  /*!
+   * \brief number of reads issued to the underlying device
+   */
+  size_t num_device_reads() const { return num_device_reads_; }
+
+  /*!
+   * \brief number of writes issued to the underlying device
+   */
+  size_t num_device_writes() const { return num_device_writes_; }
+
+ private:
+  /*! \brief host copy of a device memory region */
+  struct MirroredRegion {
+    /*! \brief device address of the region */
+    uint64_t start;
+    /*! \brief last contents written to or read from the device */
+    std::vector<uint8_t> data;
+    /*! \brief whether each byte of `data` is known */
+    std::vector<bool> valid;
+  };
+
+  /*!
+   * \brief find the mirrored region containing [addr, addr + num_bytes)
+   * \return the region, or nullptr if the range is not mirrored
+   */
+  MirroredRegion* FindMirror(uint64_t addr, size_t num_bytes);
+
+  /*!
+   * \brief forget the mirrored bytes in [addr, addr + num_bytes)
+   */
+  void InvalidateMirrors(uint64_t addr, size_t num_bytes);
+
+  /*!
+   * \brief queue a write, merging it with the queued writes it touches
+   */
+  void QueueWrite(uint64_t addr, const uint8_t* buffer, size_t num_bytes);
+
+  /*! \brief underlying low-level device */
+  std::shared_ptr<LowLevelDevice> device_;
+  /*! \brief queued writes, keyed by device address, never overlapping or adjacent */
+  std::map<uint64_t, std::vector<uint8_t>> pending_writes_;
+  /*! \brief mirrored regions */
+  std::vector<MirroredRegion> mirrors_;
+  /*! \brief whether transactions are batched */
+  bool enabled_{true};
+  /*! \brief number of reads issued to the underlying device */
+  size_t num_device_reads_{0};
+  /*! \brief number of writes issued to the underlying device */
+  size_t num_device_writes_{0};
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_MICRO_BATCHED_LOW_LEVEL_DEVICE_H_
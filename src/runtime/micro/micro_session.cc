@@ -183,6 +183,18 @@ MicroSession::MicroSession(
     LOG(FATAL) << "unsupported micro low-level device";
   }
 
+  // Route all transactions through a batching layer. The device never writes to
+  // the text, rodata, and args sections, so they can be mirrored on the host.
+  batched_low_level_device_ = std::make_shared<BatchedLowLevelDevice>(low_level_device_);
+  low_level_device_ = batched_low_level_device_;
+  for (SectionKind kind : {SectionKind::kText, SectionKind::kRodata, SectionKind::kArgs}) {
+    std::shared_ptr<MicroSectionAllocator> allocator = GetAllocator(kind);
+    batched_low_level_device_->AddMirroredRegion(DevMemRegion {
+      .start = allocator->start_addr(),
+      .size = allocator->capacity(),
+    });
+  }
+
   runtime_symbol_map_ = LoadBinary(binary_path, false).symbol_map;
 
   // Patch pointers to define the bounds of the workspace section and the word
@@ -206,6 +218,7 @@ MicroSession::~MicroSession() {
   for (size_t i = 0; i < static_cast<size_t>(SectionKind::kNumKinds); i++) {
     section_allocators_[i] = nullptr;
   }
+  batched_low_level_device_ = nullptr;
   low_level_device_ = nullptr;
 }
 
@@ -489,6 +502,18 @@ PackedFunc MicroSession::GetFunction(
     return PackedFunc([sptr_to_self](TVMArgs args, TVMRetValue* rv) {
       MicroSession::ExitWithScope();
     });
+  } else if (name == "num_device_reads") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<int64_t>(batched_low_level_device_->num_device_reads());
+    });
+  } else if (name == "num_device_writes") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<int64_t>(batched_low_level_device_->num_device_writes());
+    });
+  } else if (name == "set_transaction_batching") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      batched_low_level_device_->set_enabled(args[0]);
+    });
   } else {
     return PackedFunc();
   }
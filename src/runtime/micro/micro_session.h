@@ -47,6 +47,7 @@
 #include <tuple>
 
 #include "low_level_device.h"
+#include "batched_low_level_device.h"
 #include "target_data_layout_encoder.h"
 
 namespace tvm {
@@ -199,6 +200,8 @@ class MicroSession : public ModuleNode {
  private:
   /*! \brief low-level device pointer */
   std::shared_ptr<LowLevelDevice> low_level_device_;
+  /*! \brief batching layer wrapping the low-level device, owned by `low_level_device_` */
+  std::shared_ptr<BatchedLowLevelDevice> batched_low_level_device_;
   /*! \brief prefix for binary names in target compiler toolchain */
   std::string toolchain_prefix_;
   /*! \brief array of memory allocators for each on-device section */
@@ -68,6 +68,19 @@ void ParseAttrs(const picojson::object& jattr, GraphAttr* attr) {
       attr->storage_id[i] = static_cast<int>(jstorage_id[i].get<double>());
     }
   }
+  const auto& jstorage_offset = jattr.find("storage_offset");
+  if (jstorage_offset != jattr.end()) {
+    for (const auto& jstorage_offset_ : jstorage_offset->second.get<picojson::array>()) {
+      if (jstorage_offset_.is<std::string>()) {
+        continue;
+      }
+      const auto& joffsets = jstorage_offset_.get<picojson::array>();
+      attr->storage_offset.resize(joffsets.size());
+      for (size_t i = 0; i < joffsets.size(); ++i) {
+        attr->storage_offset[i] = static_cast<int64_t>(joffsets[i].get<double>());
+      }
+    }
+  }
   for (const auto& jshape_ : jattr.at("shape").get<picojson::array>()) {
     if (jshape_.is<std::string>()) {
       continue;
@@ -110,6 +123,22 @@ void ParseNodes(const picojson::array& jnodes, DynArray<Node>* nodes) {
   }
 }
 
+// Alignment of each storage entry in the arena.
+constexpr size_t kArenaAlignment = 64;
+
+// Lay the non external pool entries out back to back in the arena, and return
+// the bytes they take.
+size_t PoolArenaBytes(const std::vector<PoolEntry>& pool_entry, std::vector<size_t>* offsets) {
+  size_t total_bytes = 0;
+  offsets->assign(pool_entry.size(), 0);
+  for (size_t i = 0; i < pool_entry.size(); ++i) {
+    if (pool_entry[i].external) continue;
+    (*offsets)[i] = total_bytes;
+    total_bytes += (pool_entry[i].size + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+  }
+  return total_bytes;
+}
+
 void ParseArgNodes(const picojson::array& jinput_nodes, DynArray<uint32_t>* input_nodes) {
   input_nodes->resize(jinput_nodes.size());
   for (size_t i = 0; i < jinput_nodes.size(); ++i) {
@@ -141,6 +170,16 @@ NDArray NDArray::Empty(const DynArray<int64_t>& shape, DLDataType dtype, DLConte
   return r;
 }
 
+NDArray NDArray::Wrap(void* data, const DynArray<int64_t>& shape, DLDataType dtype,
+                      DLContext ctx) {
+  NDArray r;
+  r.storage_ = std::shared_ptr<void>(data, [](void* ptr) {});
+  r.shape_ = shape;
+  r.dtype_ = dtype;
+  r.ctx_ = ctx;
+  return r;
+}
+
 NDArray NDArray::CreateView(const DynArray<int64_t>& shape, DLDataType dtype) {
   NDArray r;
   r.storage_ = storage_;
@@ -152,8 +191,8 @@ NDArray NDArray::CreateView(const DynArray<int64_t>& shape, DLDataType dtype) {
 
 DLTensor NDArray::ToDLTensor() {
   DLTensor r;
+  // Null for graph inputs that are not bound yet.
   r.data = storage_.get();
-  assert(r.data != nullptr);
   r.ctx = ctx_;
   r.ndim = shape_.size();
   r.dtype = dtype_;
@@ -224,9 +263,27 @@ void* DSOModule::GetSymbol(const char* name) const {
   return f;
 }
 
-MicroGraphRuntime::MicroGraphRuntime(const std::string& graph_json, DSOModule* module) {
+MicroGraphRuntime::MicroGraphRuntime(const std::string& graph_json, DSOModule* module)
+    : MicroGraphRuntime(graph_json, module, nullptr, 0) {}
+
+MicroGraphRuntime::MicroGraphRuntime(const std::string& graph_json, DSOModule* module,
+                                     void* arena, size_t arena_size) {
   assert(module);
   module_ = module;
+  Load(graph_json);
+  SetupStorage(arena, arena_size);
+  SetupOpExecs();
+}
+
+MicroGraphRuntime::~MicroGraphRuntime() {}
+
+size_t MicroGraphRuntime::ArenaSize(const std::string& graph_json) {
+  MicroGraphRuntime graph;
+  graph.Load(graph_json);
+  return graph.PlanArena(true, nullptr);
+}
+
+void MicroGraphRuntime::Load(const std::string& graph_json) {
   picojson::value v;
   picojson::parse(v, graph_json);
   ParseNodes(v.get<picojson::object>()["nodes"].get<picojson::array>(), &nodes_);
@@ -234,13 +291,15 @@ MicroGraphRuntime::MicroGraphRuntime(const std::string& graph_json, DSOModule* m
   ParseArgNodes(v.get<picojson::object>()["node_row_ptr"].get<picojson::array>(), &node_row_ptr_);
   ParseOutputs(v.get<picojson::object>()["heads"].get<picojson::array>(), &outputs_);
   ParseAttrs(v.get<picojson::object>()["attrs"].get<picojson::object>(), &attrs_);
-  SetupStorage();
-  SetupOpExecs();
 }
 
-MicroGraphRuntime::~MicroGraphRuntime() {}
-
 void MicroGraphRuntime::Run() {
+  for (const auto& args : input_args_) {
+    for (const DLTensor* arg : args) {
+      assert(arg->data != nullptr);
+      (void)arg;
+    }
+  }
   for (size_t i = 0; i < op_execs_.size(); ++i) {
     if (op_execs_[i]) op_execs_[i]();
   }
@@ -249,28 +308,34 @@ void MicroGraphRuntime::Run() {
 void MicroGraphRuntime::SetInput(int index, DLTensor* data_in) {
   assert(static_cast<size_t>(index) < input_nodes_.size());
   uint32_t eid = this->entry_id(input_nodes_[index], 0);
+  DLTensor storage = data_entry_[eid].ToDLTensor();
+  assert(storage.data != nullptr);
   data_entry_[eid].CopyFrom(data_in);
+  // Undo a previous SetInputZeroCopy.
+  BindInput(index, storage.data);
+}
+
+void MicroGraphRuntime::SetInputZeroCopy(int index, DLTensor* data_in) {
+  assert(static_cast<size_t>(index) < input_nodes_.size());
+  BindInput(index, static_cast<uint8_t*>(data_in->data) + data_in->byte_offset);
+}
+
+void MicroGraphRuntime::BindInput(int index, void* data) {
+  for (DLTensor* arg : input_args_[index]) {
+    arg->data = data;
+  }
 }
 
 void MicroGraphRuntime::CopyOutputTo(int index, DLTensor* data_out) {
   assert(static_cast<size_t>(index) < outputs_.size());
   uint32_t eid = this->entry_id(outputs_[index]);
-  const NDArray& data = data_entry_[eid];
+  NDArray& data = data_entry_[eid];
+  // Graph inputs bound in place are not readable as outputs.
+  assert(data.ToDLTensor().data != nullptr);
   data.CopyTo(data_out);
 }
 
-void MicroGraphRuntime::SetupStorage() {
-  // Grab saved optimization plan from graph.
-  DynArray<DLDataType> vtype(attrs_.dltype.size());
-  for (size_t i = 0; i < attrs_.dltype.size(); ++i) {
-    assert(attrs_.dltype[i] == "float32");
-    DLDataType ty;
-    ty.bits = 32;
-    ty.lanes = 1;
-    ty.code = kDLFloat;
-    vtype[i] = ty;
-  }
-
+std::vector<PoolEntry> MicroGraphRuntime::PlanStorage(bool external_inputs) const {
   // Size and device type of each storage pool entry.
   std::vector<PoolEntry> pool_entry;
   // Find the maximum space size.
@@ -283,14 +348,12 @@ void MicroGraphRuntime::SetupStorage() {
       size *= static_cast<size_t>(sz);
     }
     assert(storage_id >= 0);
-    DLDataType t = vtype[i];
-    size_t bits = t.bits * t.lanes;
-    assert(bits % 8U == 0U || bits == 1U);
-    size_t bytes = ((bits + 7U) / 8U) * size;
+    // Only float32 is supported, see SetupStorage.
+    size_t bytes = sizeof(float) * size;
 
     uint32_t sid = static_cast<uint32_t>(storage_id);
     if (sid >= pool_entry.size()) {
-      pool_entry.resize(sid + 1, {0, -1});
+      pool_entry.resize(sid + 1, {0, -1, false});
     } else {
       assert(pool_entry[sid].device_type == -1 || pool_entry[sid].device_type == device_type);
     }
@@ -298,28 +361,103 @@ void MicroGraphRuntime::SetupStorage() {
     pool_entry[sid].device_type = device_type;
   }
 
-  // Allocate the space.
-  storage_pool_.resize(pool_entry.size());
-  for (size_t i = 0; i < pool_entry.size(); ++i) {
-    const auto& pit = pool_entry[i];
+  if (external_inputs) {
+    for (uint32_t nid : input_nodes_) {
+      pool_entry[attrs_.storage_id[this->entry_id(nid, 0)]].external = true;
+    }
+    // The memory planner never shares the storage of a graph input.
+    for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+      assert(!pool_entry[attrs_.storage_id[i]].external ||
+             std::any_of(input_nodes_.begin(), input_nodes_.end(),
+                         [&](uint32_t nid) { return this->entry_id(nid, 0) == i; }));
+    }
+  }
+  return pool_entry;
+}
+
+// Compute the byte offset of each node entry in the arena, and return the
+// bytes needed including the slack to align an arbitrary base pointer. The
+// offsets of the arena planner are used when the graph has them and they take
+// less memory than one slice per storage id.
+size_t MicroGraphRuntime::PlanArena(bool external_inputs,
+                                    std::vector<size_t>* entry_offsets) const {
+  std::vector<PoolEntry> pool_entry = PlanStorage(external_inputs);
+  std::vector<size_t> pool_offsets;
+  size_t total_bytes = PoolArenaBytes(pool_entry, &pool_offsets);
+  bool use_storage_offset = attrs_.storage_offset.size() == attrs_.shape.size();
+  size_t offset_bytes = 0;
+  for (size_t i = 0; use_storage_offset && i < attrs_.shape.size(); ++i) {
+    if (pool_entry[attrs_.storage_id[i]].external) continue;
+    int64_t offset = attrs_.storage_offset[i];
+    assert(offset >= 0 && offset % kArenaAlignment == 0);
+    size_t size = 1;
+    for (int64_t sz : attrs_.shape[i]) {
+      size *= static_cast<size_t>(sz);
+    }
+    offset_bytes = std::max(offset_bytes, static_cast<size_t>(offset) + sizeof(float) * size);
+  }
+  use_storage_offset = use_storage_offset && offset_bytes <= total_bytes;
+  if (use_storage_offset) {
+    total_bytes = offset_bytes;
+  }
+  if (entry_offsets) {
+    entry_offsets->resize(attrs_.storage_id.size());
+    for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+      (*entry_offsets)[i] = use_storage_offset ?
+          static_cast<size_t>(attrs_.storage_offset[i]) : pool_offsets[attrs_.storage_id[i]];
+    }
+  }
+  return total_bytes > 0 ? total_bytes + kArenaAlignment - 1 : 0;
+}
+
+void MicroGraphRuntime::SetupStorage(void* arena, size_t arena_size) {
+  // Grab saved optimization plan from graph.
+  DynArray<DLDataType> vtype(attrs_.dltype.size());
+  for (size_t i = 0; i < attrs_.dltype.size(); ++i) {
+    assert(attrs_.dltype[i] == "float32");
+    DLDataType ty;
+    ty.bits = 32;
+    ty.lanes = 1;
+    ty.code = kDLFloat;
+    vtype[i] = ty;
+  }
+
+  // The graph inputs live outside of a caller provided arena.
+  const bool external_inputs = arena != nullptr;
+  std::vector<PoolEntry> pool_entry = PlanStorage(external_inputs);
+  std::vector<size_t> offsets;
+  size_t total_bytes = PlanArena(external_inputs, &offsets);
+
+  // Allocate the space once, unless the caller provided it.
+  if (!external_inputs && total_bytes > 0) {
     DynArray<int64_t> shape(1);
-    shape[0] = static_cast<int64_t>(pit.size + 3) / 4;
-    storage_pool_[i] = NDArray::Empty(shape, DLDataType{kDLFloat, 32, 1}, ctx_);
+    shape[0] = static_cast<int64_t>(total_bytes + 3) / 4;
+    arena_ = NDArray::Empty(shape, DLDataType{kDLFloat, 32, 1}, ctx_);
+    arena = arena_.ToDLTensor().data;
+    arena_size = total_bytes;
   }
+  assert(arena_size >= total_bytes);
+  (void)arena_size;
+  uintptr_t base = reinterpret_cast<uintptr_t>(arena);
+  base = (base + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
 
-  // Assign the pooled entries. A unified memory pool is used to simplify
-  // memory assignment for each node entry. The allocated memory on each device
-  // is mapped to this pool.
+  // Assign the pooled entries. The allocated memory on each device is mapped
+  // to a slice of the arena, external entries are bound later.
   data_entry_.resize(num_node_entries());
   for (size_t i = 0; i < data_entry_.size(); ++i) {
     int storage_id = attrs_.storage_id[i];
-    assert(static_cast<size_t>(storage_id) < storage_pool_.size());
-    data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    assert(static_cast<size_t>(storage_id) < pool_entry.size());
+    void* data = pool_entry[storage_id].external ?
+        nullptr : reinterpret_cast<void*>(base + offsets[i]);
+    data_entry_[i] = NDArray::Wrap(data, attrs_.shape[i], vtype[i], ctx_);
   }
 }
 
+// Create the closure of an operator call. `packed_args` is set to the DLTensor
+// arguments the closure calls with, which stay valid as long as the closure.
 std::function<void()> CreateTVMOp(const DSOModule& module, const TVMOpParam& param,
-                                  const DynArray<DLTensor>& args, size_t num_inputs) {
+                                  const DynArray<DLTensor>& args, size_t num_inputs,
+                                  DLTensor** packed_args) {
   typedef union {
     void* v_handle;
   } TVMValue;
@@ -354,8 +492,10 @@ std::function<void()> CreateTVMOp(const DSOModule& module, const TVMOpParam& par
     }
   }
 
+  *packed_args = arg_ptr->args.data();
+
   if (param.func_name == "__nop") {
-    return []() {};
+    return [arg_ptr]() {};
   } else if (param.func_name == "__copy") {
     assert(false);
   }
@@ -373,6 +513,7 @@ std::function<void()> CreateTVMOp(const DSOModule& module, const TVMOpParam& par
 
 void MicroGraphRuntime::SetupOpExecs() {
   op_execs_.resize(nodes_.size());
+  input_args_.resize(input_nodes_.size());
   // setup the array and requirements.
   for (uint32_t nid = 0; nid < nodes_.size(); ++nid) {
     const auto& inode = nodes_[nid];
@@ -387,7 +528,17 @@ void MicroGraphRuntime::SetupOpExecs() {
       args[index + inode.inputs.size()] = data_entry_[eid].ToDLTensor();
     }
     assert(inode.op_type == "tvm_op");
-    op_execs_[nid] = CreateTVMOp(*module_, inode.param, args, inode.inputs.size());
+    DLTensor* packed_args = nullptr;
+    op_execs_[nid] = CreateTVMOp(*module_, inode.param, args, inode.inputs.size(), &packed_args);
+    // Remember which arguments read graph inputs, to rebind them in place.
+    for (size_t i = 0; i < inode.inputs.size(); ++i) {
+      const auto& e = inode.inputs[i];
+      for (size_t index = 0; index < input_nodes_.size(); ++index) {
+        if (e.index == 0 && e.node_id == input_nodes_[index]) {
+          input_args_[index].push_back(&packed_args[i]);
+        }
+      }
+    }
   }
 }
 
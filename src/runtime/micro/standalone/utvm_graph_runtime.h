@@ -55,12 +55,16 @@ struct GraphAttr {
   DynArray<int> storage_id;
   DynArray<std::string> dltype;
   DynArray<DynArray<int64_t>> shape;
+  // Byte offset of each entry in the arena, empty when the graph has none.
+  DynArray<int64_t> storage_offset;
 };
 
 // Memory pool entry.
 struct PoolEntry {
   size_t size;
   int device_type;
+  // Whether the entry backs a graph input that is bound in place.
+  bool external;
 };
 
 // Node entry
@@ -95,6 +99,9 @@ class NDArray {
  public:
   // initialize NDArray with shape/dtype/ctx
   static NDArray Empty(const DynArray<int64_t>& shape, DLDataType dtype, DLContext ctx);
+  // wrap memory owned by someone else, e.g. a slice of the arena
+  static NDArray Wrap(void* data, const DynArray<int64_t>& shape, DLDataType dtype,
+                      DLContext ctx);
   // create a view of the NDArray storage, with the given shape/dtype
   NDArray CreateView(const DynArray<int64_t>& shape, DLDataType dtype);
   // Copy into the internal storage.
@@ -117,27 +124,47 @@ class NDArray {
 };
 
 // Minimal GraphRuntime implementation
+//
+// All storage of the memory plan lives in a single arena. By default the
+// runtime allocates it once at construction and the graph inputs are copied
+// into it. With a caller provided arena (e.g. a static buffer of ArenaSize()
+// bytes) the graph inputs are not part of it and must be bound in place with
+// SetInputZeroCopy, so parameters can be used directly from read-only memory
+// and the runtime allocates nothing after construction. Operator workspaces
+// still come from TVMBackendAllocWorkspace.
 class MicroGraphRuntime {
  public:
   // Construct a GraphRuntime with the given graph and DSOModule.
   MicroGraphRuntime(const std::string& graph_json, DSOModule* module);
+  // Construct a GraphRuntime whose storage is carved out of `arena`.
+  MicroGraphRuntime(const std::string& graph_json, DSOModule* module, void* arena,
+                    size_t arena_size);
   ~MicroGraphRuntime();
+  // The arena size in bytes needed by the graph when its inputs are bound in place.
+  static size_t ArenaSize(const std::string& graph_json);
   // Run the graph
   void Run();
   // Set the input at `index` to a copy of the tensor `data_in`
   void SetInput(int index, DLTensor* data_in);
+  // Bind the input at `index` to the memory of `data_in`, which must outlive the runs
+  void SetInputZeroCopy(int index, DLTensor* data_in);
   // Copy the output at `index` into `data_out`
   void CopyOutputTo(int index, DLTensor* data_out);
 
  private:
-  void SetupStorage();
+  MicroGraphRuntime() = default;
+  void Load(const std::string& graph_json);
+  std::vector<PoolEntry> PlanStorage(bool external_inputs) const;
+  size_t PlanArena(bool external_inputs, std::vector<size_t>* entry_offsets) const;
+  void SetupStorage(void* arena, size_t arena_size);
   void SetupOpExecs();
+  void BindInput(int index, void* data);
 
   uint32_t num_node_entries() const { return node_row_ptr_.back(); }
   uint32_t entry_id(uint32_t nid, uint32_t index) const { return node_row_ptr_[nid] + index; }
   uint32_t entry_id(const NodeEntry& e) const { return entry_id(e.node_id, e.index); }
 
-  DSOModule* module_;
+  DSOModule* module_{nullptr};
 
   // TODO(tulloch): these are essentially unused after construction.
   // The graph nodes
@@ -153,12 +180,14 @@ class MicroGraphRuntime {
   // Execution context
   DLContext ctx_{kDLCPU, 0};
 
-  // Common storage pool
-  DynArray<NDArray> storage_pool_;
-  // Data entry for each node
+  // The arena when it is owned by the runtime
+  NDArray arena_;
+  // Data entry for each node, views into the arena
   DynArray<NDArray> data_entry_;
   // Operator for each node
   DynArray<std::function<void()>> op_execs_;
+  // The operator arguments reading each graph input, patched when it is rebound
+  std::vector<std::vector<DLTensor*>> input_args_;
 };
 
 }  // namespace micro
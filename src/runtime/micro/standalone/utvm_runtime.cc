@@ -27,6 +27,17 @@ void* UTVMRuntimeCreate(const char* json, size_t json_len, void* module) {
       reinterpret_cast<tvm::micro::DSOModule*>(module));
 }
 
+size_t UTVMRuntimeArenaSize(const char* json, size_t json_len) {
+  return tvm::micro::MicroGraphRuntime::ArenaSize(std::string(json, json + json_len));
+}
+
+void* UTVMRuntimeCreateWithArena(const char* json, size_t json_len, void* module, void* arena,
+                                 size_t arena_size) {
+  return new tvm::micro::MicroGraphRuntime(
+      std::string(json, json + json_len),
+      reinterpret_cast<tvm::micro::DSOModule*>(module), arena, arena_size);
+}
+
 void UTVMRuntimeDestroy(void* handle) {
   delete reinterpret_cast<tvm::micro::MicroGraphRuntime*>(handle);
 }
@@ -36,6 +47,11 @@ void UTVMRuntimeSetInput(void* handle, int index, void* tensor) {
       index, reinterpret_cast<DLTensor*>(tensor));
 }
 
+void UTVMRuntimeSetInputZeroCopy(void* handle, int index, void* tensor) {
+  reinterpret_cast<tvm::micro::MicroGraphRuntime*>(handle)->SetInputZeroCopy(
+      index, reinterpret_cast<DLTensor*>(tensor));
+}
+
 void UTVMRuntimeRun(void* handle) {
   reinterpret_cast<tvm::micro::MicroGraphRuntime*>(handle)->Run();
 }
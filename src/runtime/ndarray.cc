@@ -135,16 +135,17 @@ struct NDArray::Internal {
   }
 };
 
-NDArray NDArray::CreateView(std::vector<int64_t> shape, DLDataType dtype) {
+NDArray NDArray::CreateView(std::vector<int64_t> shape, DLDataType dtype,
+                            uint64_t relative_byte_offset) {
   CHECK(data_ != nullptr);
   CHECK(get_mutable()->dl_tensor.strides == nullptr)
       << "Can only create view for compact tensor";
   NDArray ret = Internal::Create(shape, dtype, get_mutable()->dl_tensor.ctx);
   ret.get_mutable()->dl_tensor.byte_offset =
-      this->get_mutable()->dl_tensor.byte_offset;
+      this->get_mutable()->dl_tensor.byte_offset + relative_byte_offset;
   size_t curr_size = GetDataSize(this->get_mutable()->dl_tensor);
   size_t view_size = GetDataSize(ret.get_mutable()->dl_tensor);
-  CHECK_LE(view_size, curr_size)
+  CHECK_LE(view_size + relative_byte_offset, curr_size)
       << "Tries to create a view that has bigger memory than current one";
   // increase ref count
   get_mutable()->IncRef();
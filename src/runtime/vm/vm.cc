@@ -680,6 +680,22 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       inputs_.erase(func_name);
       inputs_.emplace(func_name, func_args);
     });
+  } else if (name == "set_max_kernel_specializations") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int limit = args[0];
+      CHECK_GE(limit, 0);
+      max_kernel_specializations_ = static_cast<size_t>(limit);
+      specialized_funcs_.clear();
+      unspecializable_funcs_.clear();
+    });
+  } else if (name == "get_num_kernel_specializations") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int64_t count = 0;
+      for (const auto& it : specialized_funcs_) {
+        count += it.second.size();
+      }
+      *rv = count;
+    });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc([sptr_to_self, name](TVMArgs args, TVMRetValue* rv) {});
@@ -764,25 +780,53 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func,
 
   std::vector<TVMValue> values(arity);
   std::vector<int> codes(arity);
+  std::vector<int64_t> shape_key;
   runtime::TVMArgsSetter setter(values.data(), codes.data());
   int idx = 0;
+  auto set_arg = [&](const TensorObj* tensor) {
+    CHECK(tensor != nullptr);
+    setter(idx++, tensor->data);
+    if (max_kernel_specializations_ != 0) {
+      const DLTensor* dl_tensor = tensor->data.operator->();
+      shape_key.push_back(dl_tensor->ndim);
+      shape_key.insert(shape_key.end(), dl_tensor->shape, dl_tensor->shape + dl_tensor->ndim);
+    }
+  };
   for (Index i = 0; i < arg_count; i++) {
     if (const auto* dt_cell = args[i].as<ADTObj>()) {
       for (size_t fi = 0; fi < dt_cell->size; ++fi) {
         auto obj = (*dt_cell)[fi];
-        const auto* tensor = obj.as<TensorObj>();
-        CHECK(tensor != nullptr);
-        setter(idx++, tensor->data);
+        set_arg(obj.as<TensorObj>());
       }
     } else {
-      const auto* tensor = args[i].as<TensorObj>();
-      CHECK(tensor != nullptr);
-      setter(idx++, tensor->data);
+      set_arg(args[i].as<TensorObj>());
     }
   }
 
+  TVMArgs targs(values.data(), codes.data(), arity);
   TVMRetValue rv;
-  func.CallPacked(TVMArgs(values.data(), codes.data(), arity), &rv);
+  SelectKernel(packed_index, func, targs, shape_key).CallPacked(targs, &rv);
+}
+
+const PackedFunc& VirtualMachine::SelectKernel(Index packed_index, const PackedFunc& func,
+                                               const TVMArgs& args,
+                                               const std::vector<int64_t>& shape_key) {
+  if (max_kernel_specializations_ == 0) return func;
+  auto sit = exec_->kernel_specializers.find(packed_index);
+  if (sit == exec_->kernel_specializers.end()) return func;
+  if (unspecializable_funcs_.count(packed_index)) return func;
+  auto& table = specialized_funcs_[packed_index];
+  auto it = table.find(shape_key);
+  if (it != table.end()) return it->second;
+  // Keep using the generic kernel once the table is full.
+  if (table.size() >= max_kernel_specializations_) return func;
+  TVMRetValue rv;
+  sit->second.CallPacked(args, &rv);
+  if (rv.type_code() == kNull) {
+    unspecializable_funcs_.insert(packed_index);
+    return func;
+  }
+  return table.emplace(shape_key, rv.operator PackedFunc()).first->second;
 }
 
 void VirtualMachine::LoadExecutable(const Executable* exec) {
@@ -145,6 +145,28 @@ TEST(Pattern, Integer) {
   CHECK(!(v * c).Match((tx + 1) * 3));
 }
 
+TEST(Pattern, MatchShape) {
+  using namespace tvm;
+  using namespace tvm::arith;
+  Var x("x"), y("y");
+  PVar<Expr> px, py;
+  PVar<Integer> c;
+  // The shape check only looks at node types and constants.
+  CHECK((px + (py + px)).MatchShape_(x + (y + 1)));
+  CHECK(!(px + (py + px)).Match(x + (y + 1)));
+  CHECK(!(px + (py * px)).MatchShape_(x + (y + 1)));
+  CHECK(!(px * c).MatchShape_(x * y));
+  CHECK((px * c).MatchShape_(x * 3));
+  CHECK(!(px + 1).MatchShape_(x + 2));
+  CHECK(!(px >> py).MatchShape_(x << 1));
+  CHECK(!select(px > py, px, py).MatchShape_(
+      ir::Select::make(x < y, x, y)));
+  // A rejected shape must not bind any PVar.
+  CHECK((px + py).Match(x + y));
+  CHECK(!(px * (py + c)).Match(x * (y + y)));
+  CHECK(ir::Equal(px.Eval(), x));
+}
+
 int main(int argc, char ** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
@@ -50,6 +50,21 @@ TVM_REGISTER_GLOBAL("test.sch").set_body([](tvm::TVMArgs args, tvm::TVMRetValue*
   *rv = topi::generic::schedule_injective(args[0], args[1]);
 });
 
+static void RegisterAddSchedule() {
+  static bool registered = false;
+  if (registered) return;
+  auto reg = tvm::runtime::Registry::Get("relay.op._Register");
+  auto s_i = tvm::runtime::Registry::Get("test.sch");
+  if (!reg) {
+    LOG(FATAL) << "no _Register";
+  }
+  if (!s_i) {
+    LOG(FATAL) << "no test_sch";
+  }
+  (*reg)("add", "FTVMSchedule", *s_i, 10);
+  registered = true;
+}
+
 TEST(MicroStandaloneRuntime, BuildModule) {
   using namespace tvm;
   auto tensor_type = relay::TensorTypeNode::make({2, 3}, ::tvm::Float(32));
@@ -73,16 +88,7 @@ TEST(MicroStandaloneRuntime, BuildModule) {
     pB[i] = i + 1;
     pC[i] = i + 2;
   }
-  // get schedule
-  auto reg = tvm::runtime::Registry::Get("relay.op._Register");
-  auto s_i = tvm::runtime::Registry::Get("test.sch");
-  if (!reg) {
-    LOG(FATAL) << "no _Register";
-  }
-  if (!s_i) {
-    LOG(FATAL) << "no test_sch";
-  }
-  (*reg)("add", "FTVMSchedule", *s_i, 10);
+  RegisterAddSchedule();
   // build
   auto pfb = tvm::runtime::Registry::Get("relay.build_module._BuildModule");
   tvm::runtime::Module build_mod = (*pfb)();
@@ -124,6 +130,115 @@ TEST(MicroStandaloneRuntime, BuildModule) {
     CHECK_LT(fabs(pY[i] - (i + (i + 1) + (i + 2))), 1e-4);
   }
   UTVMRuntimeDestroy(handle);
+
+  // Run again from a caller owned arena, with the inputs bound in place.
+  size_t arena_size = UTVMRuntimeArenaSize(json.c_str(), json.size());
+  ASSERT_GT(arena_size, 0);
+  std::vector<uint8_t> arena(arena_size);
+  handle = UTVMRuntimeCreateWithArena(json.c_str(), json.size(), dsoModule, arena.data(),
+                                      arena.size());
+  ASSERT_NE(handle, nullptr);
+  UTVMRuntimeSetInputZeroCopy(handle, 0, &A.ToDLPack()->dl_tensor);
+  UTVMRuntimeSetInputZeroCopy(handle, 1, &B.ToDLPack()->dl_tensor);
+  UTVMRuntimeSetInputZeroCopy(handle, 2, &C.ToDLPack()->dl_tensor);
+  UTVMRuntimeRun(handle);
+  auto Z = tvm::runtime::NDArray::Empty({2, 3}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  UTVMRuntimeGetOutput(handle, 0, &Z.ToDLPack()->dl_tensor);
+  auto* pZ = (float*)Z.ToDLPack()->dl_tensor.data;
+  for (int i = 0; i < 6; ++i) {
+    CHECK_LT(fabs(pZ[i] - (i + (i + 1) + (i + 2))), 1e-4);
+  }
+  UTVMRuntimeDestroy(handle);
+
+  // Without storage_offset each storage id gets its own slice of the arena,
+  // which never takes less memory than the offsets of the arena planner.
+  std::string no_offset_json = json;
+  size_t pos = no_offset_json.find("\"storage_offset\"");
+  ASSERT_NE(pos, std::string::npos);
+  no_offset_json.replace(pos, 16, "\"unused_offset\"");
+  size_t no_offset_arena_size = UTVMRuntimeArenaSize(no_offset_json.c_str(),
+                                                     no_offset_json.size());
+  ASSERT_GE(no_offset_arena_size, arena_size);
+  std::vector<uint8_t> no_offset_arena(no_offset_arena_size);
+  handle = UTVMRuntimeCreateWithArena(no_offset_json.c_str(), no_offset_json.size(), dsoModule,
+                                      no_offset_arena.data(), no_offset_arena.size());
+  ASSERT_NE(handle, nullptr);
+  UTVMRuntimeSetInputZeroCopy(handle, 0, &A.ToDLPack()->dl_tensor);
+  UTVMRuntimeSetInputZeroCopy(handle, 1, &B.ToDLPack()->dl_tensor);
+  UTVMRuntimeSetInputZeroCopy(handle, 2, &C.ToDLPack()->dl_tensor);
+  UTVMRuntimeRun(handle);
+  UTVMRuntimeGetOutput(handle, 0, &Z.ToDLPack()->dl_tensor);
+  for (int i = 0; i < 6; ++i) {
+    CHECK_LT(fabs(pZ[i] - (i + (i + 1) + (i + 2))), 1e-4);
+  }
+  UTVMRuntimeDestroy(handle);
+  UTVMRuntimeDSOModuleDestroy(dsoModule);
+}
+
+TEST(MicroStandaloneRuntime, ParamUsedAfterIntermediateDies) {
+  using namespace tvm;
+  // Without fusion a + a dies before the bound weight w is first used, the
+  // arena planner must not place it on top of the weight.
+  auto tensor_type = relay::TensorTypeNode::make({2, 3}, ::tvm::Float(32));
+  auto a = relay::VarNode::make("a", tensor_type);
+  auto w = relay::VarNode::make("w", tensor_type);
+  auto add_op = relay::Op::Get("add");
+  auto x1 = relay::CallNode::make(add_op, {a, a}, tvm::Attrs(), {});
+  auto x2 = relay::CallNode::make(add_op, {x1, a}, tvm::Attrs(), {});
+  auto x3 = relay::CallNode::make(add_op, {x2, a}, tvm::Attrs(), {});
+  auto y = relay::CallNode::make(add_op, {x3, w}, tvm::Attrs(), {});
+  auto func = relay::FunctionNode::make({a, w}, y, relay::Type(), {});
+  auto A = tvm::runtime::NDArray::Empty({2, 3}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  auto W = tvm::runtime::NDArray::Empty({2, 3}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  auto pA = (float*)A.ToDLPack()->dl_tensor.data;
+  auto pW = (float*)W.ToDLPack()->dl_tensor.data;
+  for (int i = 0; i < 6; ++i) {
+    pA[i] = i;
+    pW[i] = 10 * i + 1;
+  }
+  RegisterAddSchedule();
+  auto pfb = tvm::runtime::Registry::Get("relay.build_module._BuildModule");
+  tvm::runtime::Module build_mod = (*pfb)();
+  Map<std::string, relay::Constant> bind_params;
+  bind_params.Set("w", relay::ConstantNode::make(W));
+  build_mod.GetFunction("set_params", false)(bind_params);
+  Map<tvm::Integer, tvm::Target> targets;
+  Target llvm_tgt = Target::Create("llvm");
+  targets.Set(0, llvm_tgt);
+  auto pass_ctx = relay::transform::PassContext::Create();
+  pass_ctx->opt_level = 0;
+  {
+    tvm::With<relay::transform::PassContext> ctx_scope(pass_ctx);
+    build_mod.GetFunction("build", false)(func, targets, llvm_tgt);
+  }
+  std::string json = build_mod.GetFunction("get_graph_json", false)();
+  ASSERT_NE(json.find("\"storage_offset\""), std::string::npos);
+  Map<std::string, relay::Constant> params = build_mod.GetFunction("get_params", false)();
+  ASSERT_EQ(params.size(), 1U);
+  tvm::runtime::NDArray P = (*params.begin()).second->data;
+  tvm::runtime::Module mod = build_mod.GetFunction("get_module", false)();
+  std::string o_fname = std::tmpnam(nullptr);
+  std::string so_fname = std::tmpnam(nullptr);
+  mod->SaveToFile(o_fname, "o");
+  const std::string cmd = "gcc -shared -fPIC -o " + so_fname + " " + o_fname;
+  ASSERT_EQ(system(cmd.c_str()), 0);
+  auto* dsoModule = UTVMRuntimeDSOModuleCreate(so_fname.c_str(), so_fname.size());
+  ASSERT_NE(dsoModule, nullptr);
+
+  // The graph inputs are the function params followed by the bound weight,
+  // copied into the arena at their planned offsets.
+  auto* handle = UTVMRuntimeCreate(json.c_str(), json.size(), dsoModule);
+  ASSERT_NE(handle, nullptr);
+  UTVMRuntimeSetInput(handle, 0, &A.ToDLPack()->dl_tensor);
+  UTVMRuntimeSetInput(handle, 1, &P.ToDLPack()->dl_tensor);
+  UTVMRuntimeRun(handle);
+  auto Y = tvm::runtime::NDArray::Empty({2, 3}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  UTVMRuntimeGetOutput(handle, 0, &Y.ToDLPack()->dl_tensor);
+  auto* pY = (float*)Y.ToDLPack()->dl_tensor.data;
+  for (int i = 0; i < 6; ++i) {
+    CHECK_LT(fabs(pY[i] - (4 * i + 10 * i + 1)), 1e-4);
+  }
+  UTVMRuntimeDestroy(handle);
   UTVMRuntimeDSOModuleDestroy(dsoModule);
 }
 
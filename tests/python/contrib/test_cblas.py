@@ -64,12 +64,75 @@ def test_matmul_add():
     verify_matmul_add(1, 16, 3, False, False)
     verify_matmul_add(1, 16, 3, True, True)
 
+def verify_matmul_prepacked(m, l, n, transb=False):
+    ashape = (n, l)
+    bshape = (m, l) if transb else (l, m)
+    A = tvm.placeholder(ashape, name='A')
+
+    def verify(target="llvm"):
+        if not tvm.module.enabled(target):
+            print("skip because %s is not enabled..." % target)
+            return
+        if not tvm.get_global_func("tvm.contrib.cblas.matmul_prepacked", True):
+            print("skip because extern function is not available")
+            return
+        ctx = tvm.cpu(0)
+        b_np = np.random.uniform(size=bshape).astype(A.dtype)
+        packed = cblas.pack(tvm.nd.array(b_np, ctx), transb)
+        P = tvm.placeholder(packed.shape, name='P')
+        C = cblas.matmul_prepacked(A, P, m, False, transb)
+        s = tvm.create_schedule(C.op)
+        f = tvm.build(s, [A, P, C], target)
+        c = tvm.nd.array(np.zeros((n, m), dtype=C.dtype), ctx)
+        # the packed rhs is reused across calls with new lhs values.
+        for _ in range(2):
+            a_np = np.random.uniform(size=ashape).astype(A.dtype)
+            f(tvm.nd.array(a_np, ctx), packed, c)
+            tvm.testing.assert_allclose(
+                c.asnumpy(), np.dot(a_np, b_np.T if transb else b_np), rtol=1e-5)
+        # new rhs values take effect once they are packed again.
+        b_np = np.random.uniform(size=bshape).astype(A.dtype)
+        packed = cblas.pack(tvm.nd.array(b_np, ctx), transb)
+        f(tvm.nd.array(a_np, ctx), packed, c)
+        tvm.testing.assert_allclose(
+            c.asnumpy(), np.dot(a_np, b_np.T if transb else b_np), rtol=1e-5)
+    verify()
+
+def test_matmul_prepacked():
+    verify_matmul_prepacked(235, 128, 1024)
+    verify_matmul_prepacked(235, 128, 1024, True)
+    verify_matmul_prepacked(1, 16, 3, True)
+
+def test_matmul_u8s8s32():
+    n, l, m = 64, 128, 96
+    A = tvm.placeholder((n, l), name='A', dtype='uint8')
+    B = tvm.placeholder((m, l), name='B', dtype='int8')
+    C = cblas.matmul_u8s8s32(A, B, False, True)
+    s = tvm.create_schedule(C.op)
+
+    def verify(target="llvm"):
+        if not tvm.module.enabled(target):
+            print("skip because %s is not enabled..." % target)
+            return
+        if not tvm.get_global_func("tvm.contrib.cblas.matmul_u8s8s32", True):
+            print("skip because extern function is not available")
+            return
+        ctx = tvm.cpu(0)
+        f = tvm.build(s, [A, B, C], target)
+        a_np = np.random.randint(0, 255, size=(n, l)).astype(A.dtype)
+        b_np = np.random.randint(-128, 127, size=(m, l)).astype(B.dtype)
+        c = tvm.nd.array(np.zeros((n, m), dtype=C.dtype), ctx)
+        f(tvm.nd.array(a_np, ctx), tvm.nd.array(b_np, ctx), c)
+        np.testing.assert_equal(
+            c.asnumpy(), np.dot(a_np.astype("int32"), b_np.astype("int32").T))
+    verify()
+
 def verify_batch_matmul(batch, m, l, n, transa=False, transb=False, iterative=False, dtype=tvm.float32):
     ashape = (batch, l, n) if transa else (batch, n, l)
     bshape = (batch, m, l) if transb else (batch, l, m)
     A = tvm.placeholder(ashape, name='A', dtype=dtype)
     B = tvm.placeholder(bshape, name='B', dtype=dtype)
-    C = cblas.batch_matmul(A, B, transa, transb)
+    C = cblas.batch_matmul(A, B, transa, transb, iterative=iterative)
     D = tvm.compute(C.shape, lambda k, i, j: C[k, i,j], name="D")
     s = tvm.create_schedule(D.op)
 
@@ -107,7 +170,10 @@ def test_batch_matmul():
     verify_batch_matmul(1, 1, 16, 3, False, False)
     verify_batch_matmul(1, 1, 16, 3, True, True)
     verify_batch_matmul(1, 1, 16, 3, iterative=True)
+    verify_batch_matmul(64, 16, 16, 16, iterative=True)
 
 if __name__ == "__main__":
     test_matmul_add()
     test_batch_matmul()
+    test_matmul_prepacked()
+    test_matmul_u8s8s32()
@@ -89,7 +89,38 @@ def test_normal():
     verify()
 
 
+def test_seed_and_philox():
+    m = 1000
+    n = 300
+    A = random.randint(0, 1 << 20, size=(m, n), dtype='int32')
+    B = tvm.compute((m, n), lambda i, j: (
+        random.philox(7, i * n + j) % (1 << 20)).astype('int32'), name='B')
+    s = tvm.create_schedule([A.op, B.op])
+
+    def verify(target="llvm"):
+        if not tvm.module.enabled(target):
+            print("skip because %s is not enabled..." % target)
+            return
+        if not tvm.get_global_func("tvm.contrib.random.seed", True):
+            print("skip because extern function is not available")
+            return
+        ctx = tvm.cpu(0)
+        f = tvm.build(s, [A, B], target)
+        a = tvm.nd.array(np.zeros((m, n), dtype=A.dtype), ctx)
+        b = tvm.nd.array(np.zeros((m, n), dtype=B.dtype), ctx)
+        random.seed(7)
+        f(a, b)
+        # the tensor is filled in parallel, but element i is the i-th number
+        # of the stream of the seed.
+        np.testing.assert_equal(a.asnumpy(), b.asnumpy())
+        random.seed(7)
+        f(a, b)
+        np.testing.assert_equal(a.asnumpy(), b.asnumpy())
+    verify()
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
+    test_seed_and_philox()
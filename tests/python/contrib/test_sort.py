@@ -73,6 +73,36 @@ def test_sort_np():
     f(a, b, c)
     tvm.testing.assert_allclose(c.asnumpy(), np_out, rtol=1e-5)
 
+def test_topk_detection():
+    # typical shape of the scores of a detection model, large enough to
+    # sort the rows in parallel.
+    dshape = (4, 8, 2000)
+    k = 100
+    for dtype in ["float32", "float16"]:
+        data = tvm.placeholder(dshape, name='data', dtype=dtype)
+        out = tvm.extern([(4, 8, k), (4, 8, k)], [data],
+                         lambda ins, outs: tvm.call_packed(
+                             "tvm.contrib.sort.topk", ins[0], outs[0], outs[1],
+                             k, -1, "both", False),
+                         dtype=[dtype, "int32"], name="topk")
+        s = tvm.create_schedule(out[0].op)
+        f = tvm.build(s, [data] + out, "llvm")
+
+        ctx = tvm.cpu(0)
+        np_data = np.random.uniform(size=dshape).astype(dtype)
+        # NaN is ordered above every number.
+        np_data[0, 0, [3, 7, 11]] = np.nan
+        # the result equals a stable sort, ties keep the original order.
+        np_key = np.where(np.isnan(np_data), -np.inf, -np_data.astype("float32"))
+        np_indices = np.argsort(np_key, axis=-1, kind="stable")[..., :k]
+        a = tvm.nd.array(np_data, ctx)
+        b = tvm.nd.array(np.zeros((4, 8, k), dtype=dtype), ctx)
+        c = tvm.nd.array(np.zeros((4, 8, k), dtype="int32"), ctx)
+        f(a, b, c)
+        tvm.testing.assert_allclose(c.asnumpy(), np_indices)
+        tvm.testing.assert_allclose(b.asnumpy(), np.take_along_axis(np_data, np_indices, -1))
+
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_topk_detection()
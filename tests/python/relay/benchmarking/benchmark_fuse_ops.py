@@ -0,0 +1,67 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmarking greedy operator fusion against cost model guided fusion."""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+from tvm.contrib import graph_runtime
+
+
+def benchmark_fusion(mod, params, data_shape, model="unknown",
+                     target="llvm", dtype="float32"):
+    ctx = tvm.context(target, 0)
+    data = np.random.uniform(size=data_shape).astype(dtype)
+
+    def run(cost_model):
+        fusion_cost_model = relay.transform.DefaultFusionCostModel() if cost_model else None
+        with relay.build_config(opt_level=3, fusion_cost_model=fusion_cost_model):
+            graph, lib, params_ = relay.build(mod, target, params=params)
+        m = graph_runtime.create(graph, lib, ctx)
+        m.set_input("data", data)
+        m.set_input(**params_)
+        ftimer = m.module.time_evaluator("run", ctx, number=10, repeat=10)
+        prof_res = np.array(ftimer().results) * 1000
+        m.run()
+        return np.mean(prof_res), m.get_output(0).asnumpy()
+
+    greedy, greedy_out = run(False)
+    cost, cost_out = run(True)
+    tvm.testing.assert_allclose(cost_out, greedy_out, rtol=1e-5, atol=1e-5)
+    print("%s: greedy fusion %.2f ms, cost model fusion %.2f ms" % (model, greedy, cost))
+
+
+def test_resnet():
+    mod, params = testing.resnet.get_workload(batch_size=1, num_layers=18)
+    benchmark_fusion(mod, params, (1, 3, 224, 224), model="resnet18")
+
+
+def test_mobilenet():
+    mod, params = testing.mobilenet.get_workload(batch_size=1)
+    benchmark_fusion(mod, params, (1, 3, 224, 224), model="mobilenet")
+
+
+def test_squeezenet():
+    mod, params = testing.squeezenet.get_workload(version="1.1")
+    benchmark_fusion(mod, params, (1, 3, 224, 224), model="squeezenet1.1")
+
+
+if __name__ == "__main__":
+    test_resnet()
+    test_mobilenet()
+    test_squeezenet()
@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmarking Relay type inference and the optimization pipeline
+using models from relay.testing."""
+import time
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+
+def benchmark_type_infer(mod, params, model="unknown", repeat=5):
+    # ExprMutator rebuilds every node, dropping the populated types
+    main = mod["main"]
+    fresh = relay.Module.from_expr(
+        relay.Function(main.params, relay.ExprMutator().visit(main.body)))
+
+    def measure(func):
+        costs = []
+        for _ in range(repeat):
+            start = time.time()
+            func()
+            costs.append(time.time() - start)
+        return min(costs) * 1000
+
+    typed = relay.transform.InferType()(fresh)
+    full = measure(lambda: relay.transform.InferType()(fresh))
+    incremental = measure(lambda: relay.transform.InferType()(typed))
+    with relay.build_config(opt_level=3):
+        pipeline = measure(lambda: relay.optimize(typed, "llvm", params))
+    print("%s: InferType from scratch %.2f ms, on typed module %.2f ms, "
+          "optimize pipeline %.2f ms" % (model, full, incremental, pipeline))
+
+
+def test_resnet():
+    for n in [18, 50]:
+        mod, params = testing.resnet.get_workload(batch_size=1, num_layers=n)
+        benchmark_type_infer(mod, params, model="resnet" + str(n))
+
+
+def test_vgg():
+    mod, params = testing.vgg.get_workload(1, num_layers=16)
+    benchmark_type_infer(mod, params, model="vgg16")
+
+
+def test_inception_v3():
+    mod, params = testing.inception_v3.get_workload(image_shape=(3, 299, 299))
+    benchmark_type_infer(mod, params, model="inception_v3")
+
+
+def test_mobilenet():
+    mod, params = testing.mobilenet.get_workload(batch_size=1)
+    benchmark_type_infer(mod, params, model="mobilenet")
+
+
+if __name__ == "__main__":
+    test_resnet()
+    test_vgg()
+    test_inception_v3()
+    test_mobilenet()
@@ -497,6 +497,29 @@ def test_fused_ops():
         result = ex.evaluate()(data)
         tvm.testing.assert_allclose(result.asnumpy(), (data + 1) * 2)
 
+def test_kernel_specialization():
+    x = relay.var('x', shape=(relay.Any(), 4), dtype='float32')
+    y = relay.exp(x + relay.const(1.0, 'float32'))
+    mod = relay.module.Module()
+    mod["main"] = relay.Function([x], y)
+    exe = relay.vm.compile(mod, "llvm")
+    vm = relay.vm.VirtualMachine(exe)
+    vm.init(tvm.cpu())
+    def run(shapes):
+        for n in shapes:
+            data = np.random.uniform(size=(n, 4)).astype('float32')
+            result = vm.run(data)
+            tvm.testing.assert_allclose(result.asnumpy(), np.exp(data + 1), rtol=1e-5)
+
+    run([5, 8])
+    assert vm.get_num_kernel_specializations() == 0
+    vm.set_max_kernel_specializations(2)
+    run([5, 8, 5])
+    assert vm.get_num_kernel_specializations() == 2
+    # further shapes fall back to the generic kernel without growing the table
+    run([13, 21, 34])
+    assert vm.get_num_kernel_specializations() == 2
+
 def test_arange_with_dynamic_shape():
     m, n, k = relay.ShapeVar('m'), relay.ShapeVar('n'), relay.ShapeVar('k')
     x = relay.var('x', shape=(m.var, n.var, k.var), dtype='float32')
@@ -621,6 +644,7 @@ if __name__ == "__main__":
     test_any_pad()
     test_any_softmax()
     test_fused_ops()
+    test_kernel_specialization()
     test_arange_with_dynamic_shape()
     test_recursive_concat()
     test_recursive_concat_with_wrong_annotation()
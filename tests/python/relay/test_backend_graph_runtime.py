@@ -143,6 +143,80 @@ def test_plan_memory():
     assert len(device_types) == 1
 
 
+def test_plan_memory_offset():
+    x = relay.var("x", shape=(10,))
+    y = relay.var("x", shape=(1,))
+    y2 = relay.exp(y)
+    z = relay.add(x, y2)
+    z = relay.exp(z)
+    z = relay.exp(z)
+    z = relay.exp(z)
+    z = relay.exp(z)
+    z = relay.exp(z)
+    func = relay.Function([x, y], z)
+    mod = relay.Module.from_expr(func)
+    mod = relay.transform.FuseOps(0)(mod)
+    func = mod["main"]
+    omap = relay.backend._backend.GraphPlanMemoryOffset(func)
+    offsets = set()
+    for k, v in omap.items():
+        assert len(v) == 1
+        assert v[0].value % 64 == 0
+        offsets.add(v[0].value)
+    # the two params plus two alternating buffers for the chain,
+    # the small exp(y) fits into a free slot.
+    assert len(offsets) == 4
+
+
+def test_arena_runtime():
+    x = relay.var("x", shape=(1024,))
+    e = relay.exp(x)
+    a = relay.concatenate([e, e], axis=0)
+    s = relay.split(a, indices_or_sections=2, axis=0)
+    z = relay.add(s[0], s[1])
+    func = relay.Function([x], z)
+    x_data = np.random.rand(1024).astype("float32")
+    with relay.build_config(opt_level=0):
+        graph, lib, params = relay.build(relay.Module.from_expr(func), "llvm")
+    assert "storage_offset" in graph
+    mod = graph_runtime.create(graph, lib, ctx=tvm.cpu(0))
+    mod.set_input(x=x_data)
+    mod.run()
+    res = mod.get_output(0).asnumpy()
+    tvm.testing.assert_allclose(res, 2 * np.exp(x_data), rtol=1e-5)
+
+
+def test_arena_runtime_constant():
+    # The bound weight is first used after the intermediates a and b die,
+    # the arena must not place them on top of it.
+    x = relay.var("x", shape=(1024,))
+    w = relay.var("w", shape=(1024,))
+    a = relay.exp(x)
+    b = relay.exp(a)
+    c = relay.sqrt(b)
+    d = relay.sqrt(c)
+    z = relay.add(d, w)
+    func = relay.Function([x, w], z)
+    x_data = np.random.rand(1024).astype("float32")
+    w_data = np.random.rand(1024).astype("float32")
+    with relay.build_config(opt_level=0):
+        graph, lib, params = relay.build(
+            relay.Module.from_expr(func), "llvm", params={"w": w_data})
+    assert "storage_offset" in graph
+
+    def run(graph_json):
+        mod = graph_runtime.create(graph_json, lib, ctx=tvm.cpu(0))
+        mod.set_input(**params)
+        mod.set_input(x=x_data)
+        mod.run()
+        return mod.get_output(0).asnumpy()
+
+    # Renaming the attribute falls back to one buffer per storage id.
+    unplanned = run(graph.replace('"storage_offset"', '"storage_offset_unused"'))
+    tvm.testing.assert_allclose(run(graph), unplanned, rtol=1e-5)
+    tvm.testing.assert_allclose(unplanned, np.exp(np.exp(x_data)) ** 0.25 + w_data, rtol=1e-5)
+
+
 def test_gru_like():
     def unit(rnn_dim):
         X = relay.var("X", shape=(1, rnn_dim))
@@ -182,6 +256,9 @@ def test_gru_like():
 
 if __name__ == "__main__":
     test_plan_memory()
+    test_plan_memory_offset()
+    test_arena_runtime()
+    test_arena_runtime_constant()
     test_with_params()
     test_add_op_scalar()
     test_add_op_tensor()
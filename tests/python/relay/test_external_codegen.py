@@ -239,8 +239,144 @@ def test_extern_dnnl():
                  (1, 32, 14, 14), ref_res.asnumpy(), tol=1e-5)
 
 
+def test_extern_dnnl_const_weights():
+    if not tvm.get_global_func("relay.ext.dnnl", True):
+        print("skip because DNNL codegen is not available")
+        return
+
+    dtype = 'float32'
+    ishape = (1, 16, 14, 14)
+    wshape = (32, 16, 3, 3)
+    i_data = np.random.uniform(0, 1, ishape).astype(dtype)
+    w_data = np.random.uniform(0, 1, wshape).astype(dtype)
+
+    data = relay.var('data', shape=(ishape), dtype=dtype)
+    conv = relay.nn.conv2d(data, relay.const(w_data), kernel_size=(3, 3),
+                           padding=(1, 1))
+    f = relay.Function([data], relay.nn.relu(conv))
+    ref_mod = relay.Module()
+    ref_mod['main'] = f
+
+    data0 = relay.var('data0', shape=(ishape), dtype=dtype)
+    f = set_external_func_attr(f, "dnnl", "dnnl_0")
+    mod = relay.Module.from_expr(relay.Call(f, [data0]))
+
+    ref_ex = relay.create_executor("graph", mod=ref_mod, ctx=tvm.cpu())
+    ref_res = ref_ex.evaluate()(i_data)
+    check_result(mod, {"data0": i_data},
+                 (1, 32, 14, 14), ref_res.asnumpy(), tol=1e-5)
+
+
+def test_extern_dnnl_fused():
+    if not tvm.get_global_func("relay.ext.dnnl", True):
+        print("skip because DNNL codegen is not available")
+        return
+
+    dtype = 'float32'
+    ishape = (1, 16, 14, 14)
+    wshape = (16, 16, 3, 3)
+    i_data = np.random.uniform(0, 1, ishape).astype(dtype)
+    w_data = np.random.uniform(-1, 1, wshape).astype(dtype)
+    b_data = np.random.uniform(-1, 1, (16,)).astype(dtype)
+    bn_data = [np.random.uniform(0.5, 1, (16,)).astype(dtype) for _ in range(4)]
+
+    # conv + bias_add + add + relu are fused into one primitive, the
+    # batch_norm output is kept in the blocked layout picked by DNNL.
+    data = relay.var('data', shape=(ishape), dtype=dtype)
+    bn = relay.nn.batch_norm(data, *[relay.const(x) for x in bn_data])[0]
+    conv = relay.nn.conv2d(bn, relay.const(w_data), kernel_size=(3, 3),
+                           padding=(1, 1))
+    out = relay.nn.bias_add(conv, relay.const(b_data))
+    out = relay.nn.relu(relay.add(out, bn))
+    f = relay.Function([data], out)
+    ref_mod = relay.Module()
+    ref_mod['main'] = f
+
+    data0 = relay.var('data0', shape=(ishape), dtype=dtype)
+    f = set_external_func_attr(f, "dnnl", "dnnl_0")
+    mod = relay.Module.from_expr(relay.Call(f, [data0]))
+
+    ref_ex = relay.create_executor("graph", mod=ref_mod, ctx=tvm.cpu())
+    ref_res = ref_ex.evaluate()(i_data)
+    check_result(mod, {"data0": i_data},
+                 (1, 16, 14, 14), ref_res.asnumpy(), tol=1e-4)
+
+
+def test_extern_dnnl_multi_region():
+    if not tvm.get_global_func("relay.ext.dnnl", True):
+        print("skip because DNNL codegen is not available")
+        return
+
+    dtype = 'float32'
+    ishape = (1, 16, 14, 14)
+    wshape = (16, 16, 3, 3)
+    i_data = np.random.uniform(0, 1, ishape).astype(dtype)
+    w_data = [np.random.uniform(-1, 1, wshape).astype(dtype) for _ in range(2)]
+
+    def conv_relu(x, w):
+        return relay.nn.relu(relay.nn.conv2d(x, relay.const(w), kernel_size=(3, 3),
+                                             padding=(1, 1)))
+
+    # two DNNL regions with a TVM op in between, both are served by one
+    # DNNL runtime module that dispatches by symbol.
+    data = relay.var('data', shape=(ishape), dtype=dtype)
+    mid = relay.sigmoid(conv_relu(data, w_data[0]))
+    ref_mod = relay.Module()
+    ref_mod['main'] = relay.Function([data], conv_relu(mid, w_data[1]))
+
+    data0 = relay.var('data0', shape=(ishape), dtype=dtype)
+    regions = []
+    for i, w in enumerate(w_data):
+        x = relay.var('x%d' % i, shape=(ishape), dtype=dtype)
+        f = relay.Function([x], conv_relu(x, w))
+        regions.append(set_external_func_attr(f, "dnnl", "dnnl_%d" % i))
+    out = relay.Call(regions[0], [data0])
+    out = relay.Call(regions[1], [relay.sigmoid(out)])
+    mod = relay.Module.from_expr(out)
+
+    ref_ex = relay.create_executor("graph", mod=ref_mod, ctx=tvm.cpu())
+    ref_res = ref_ex.evaluate()(i_data)
+    check_result(mod, {"data0": i_data},
+                 (1, 16, 14, 14), ref_res.asnumpy(), tol=1e-4)
+
+
+def test_extern_dnnl_csource():
+    if not tvm.get_global_func("relay.ext.dnnl_csource", True):
+        print("skip because DNNL codegen is not available")
+        return
+
+    dtype = 'float32'
+    ishape = (1, 16, 14, 14)
+    wshape = (32, 16, 3, 3)
+    oshape = (1, 32, 14, 14)
+    i_data = np.random.uniform(0, 1, ishape).astype(dtype)
+    w_data = np.random.uniform(-1, 1, wshape).astype(dtype)
+    # the constants are emitted bit-exact, non-finite values included.
+    c_data = np.random.uniform(-1, 1, oshape).astype(dtype)
+    c_data[0, 0, 0, :2] = [np.inf, -np.inf]
+
+    data = relay.var('data', shape=(ishape), dtype=dtype)
+    conv = relay.nn.conv2d(data, relay.const(w_data), kernel_size=(3, 3),
+                           padding=(1, 1))
+    f = relay.Function([data], relay.add(relay.nn.relu(conv), relay.const(c_data)))
+    ref_mod = relay.Module()
+    ref_mod['main'] = f
+
+    data0 = relay.var('data0', shape=(ishape), dtype=dtype)
+    f = set_external_func_attr(f, "dnnl_csource", "dnnl_0")
+    mod = relay.Module.from_expr(relay.Call(f, [data0]))
+
+    ref_ex = relay.create_executor("graph", mod=ref_mod, ctx=tvm.cpu())
+    ref_res = ref_ex.evaluate()(i_data)
+    check_result(mod, {"data0": i_data}, oshape, ref_res.asnumpy(), tol=1e-5)
+
+
 if __name__ == "__main__":
     test_multi_node_subgraph()
     test_extern_gcc_single_op()
     test_extern_gcc()
     test_extern_dnnl()
+    test_extern_dnnl_const_weights()
+    test_extern_dnnl_fused()
+    test_extern_dnnl_multi_region()
+    test_extern_dnnl_csource()
@@ -34,7 +34,7 @@ def verify(mod, goldens):
         np.testing.assert_equal(res, golden_output)
 
 def get_mod(data_shape, data_dtype, out_dtype, input_scale, output_scale,
-        input_zero_point=0, output_zero_point=0, rounding="TONEAREST"):
+        input_zero_point=0, output_zero_point=0, rounding="TONEAREST", axis=-1):
     quantized_data = relay.var("quantized_data", shape=data_shape,
             dtype=data_dtype)
     mod = relay.qnn.op.requantize(
@@ -44,7 +44,8 @@ def get_mod(data_shape, data_dtype, out_dtype, input_scale, output_scale,
             output_scale=output_scale,
             output_zero_point=output_zero_point,
             rounding=rounding,
-            out_dtype=out_dtype)
+            out_dtype=out_dtype,
+            axis=axis)
 
     mod = relay.Function(relay.analysis.free_vars(mod), mod)
     mod = relay.Module.from_expr(mod)
@@ -240,9 +241,116 @@ def test_zero_point():
         golden_output = np.subtract(golden_output, 1)
         verify(mod, (golden_data, golden_output))
 
+def test_per_channel():
+    input_scales = [0.25, 0.5, 1.0, 2.0, 3.0]
+    golden_data = np.arange(-20, 20, 1).astype('int32').reshape(8, 5)
+    for rounding in roundings:
+        mod = get_mod(data_shape=(8, 5),
+                      data_dtype='int32',
+                      out_dtype='int8',
+                      input_scale=input_scales,
+                      output_scale=1.0,
+                      rounding=rounding,
+                      axis=1)
+        real = golden_data * np.array(input_scales)
+        if rounding == "UPWARD":
+            golden_output = np.floor(real + 0.5)
+        else:
+            golden_output = np.sign(real) * np.floor(np.abs(real) + 0.5)
+        verify(mod, (golden_data, golden_output.astype('int8')))
+
+def test_fused_fixed_point_multiply():
+    def lowered_text(mod):
+        mod = relay.qnn.transform.CanonicalizeOps()(mod)
+        return mod.astext()
+
+    # Downscaling with UPWARD rounding lowers to the fused int32 op.
+    for rounding in roundings:
+        mod = get_mod(data_shape=(32, ),
+                      data_dtype='int32',
+                      out_dtype='int8',
+                      input_scale=1,
+                      output_scale=16,
+                      rounding=rounding)
+        fused = 'fixed_point_multiply' in lowered_text(mod)
+        assert fused == (rounding == "UPWARD")
+
+    # Upscaling keeps the int64 lowering, the result may not fit in int32.
+    mod = get_mod(data_shape=(32, ),
+                  data_dtype='int32',
+                  out_dtype='int8',
+                  input_scale=2,
+                  output_scale=1,
+                  rounding="UPWARD")
+    assert 'fixed_point_multiply' not in lowered_text(mod)
+
+    # Large accumulators with per-channel scales, including a scale of one.
+    np.random.seed(0)
+    input_scales = [0.00390625, 0.0117, 0.5, 1.0]
+    golden_data = np.random.randint(-2**24, 2**24, size=(1, 4, 8, 8)).astype('int32')
+    golden_output = np.floor(golden_data * np.array(input_scales).reshape(1, 4, 1, 1) + 0.5)
+    mod = get_mod(data_shape=(1, 4, 8, 8),
+                  data_dtype='int32',
+                  out_dtype='int32',
+                  input_scale=input_scales,
+                  output_scale=1.0,
+                  rounding="UPWARD",
+                  axis=1)
+    assert 'fixed_point_multiply' in lowered_text(mod)
+    with relay.build_config(opt_level=3):
+        graph, lib, params = relay.build(mod, "llvm", params=None)
+    rt_mod = graph_runtime.create(graph, lib, ctx=tvm.cpu(0))
+    rt_mod.set_input("quantized_data", golden_data)
+    rt_mod.set_input(**params)
+    rt_mod.run()
+    res = rt_mod.get_output(0).asnumpy()
+    # The Q31 multipliers are exact for powers of two and within one unit
+    # in the last place otherwise.
+    np.testing.assert_allclose(res, golden_output, rtol=0, atol=1)
+    np.testing.assert_equal(res[:, [0, 2, 3]], golden_output[:, [0, 2, 3]])
+
+    # An int32 input zero point keeps the int64 lowering, the subtraction
+    # could wrap near the int32 limits. Narrow inputs still fuse.
+    mod = get_mod(data_shape=(4, ),
+                  data_dtype='int32',
+                  out_dtype='int8',
+                  input_scale=1,
+                  output_scale=2**24,
+                  input_zero_point=1000,
+                  rounding="UPWARD")
+    assert 'fixed_point_multiply' not in lowered_text(mod)
+    golden_data = np.array([-2**31, -2**31 + 999, 2**31 - 1, 0]).astype('int32')
+    golden_output = np.floor((golden_data.astype('int64') - 1000) / 2**24 + 0.5)
+    verify(mod, (golden_data, np.clip(golden_output, -128, 127).astype('int8')))
+
+    mod = get_mod(data_shape=(4, ),
+                  data_dtype='uint8',
+                  out_dtype='uint8',
+                  input_scale=1,
+                  output_scale=4,
+                  input_zero_point=128,
+                  output_zero_point=128,
+                  rounding="UPWARD")
+    assert 'fixed_point_multiply' in lowered_text(mod)
+
+    # The output zero point is added after clipping, so a product near the
+    # int32 limits saturates instead of wrapping.
+    mod = get_mod(data_shape=(2, ),
+                  data_dtype='int32',
+                  out_dtype='int8',
+                  input_scale=0.999,
+                  output_scale=1,
+                  output_zero_point=100,
+                  rounding="UPWARD")
+    assert 'fixed_point_multiply' in lowered_text(mod)
+    golden_data = np.array([2**31 - 1, -2**31]).astype('int32')
+    verify(mod, (golden_data, np.array([127, -128]).astype('int8')))
+
 if __name__ == "__main__":
     test_same_scale()
     test_downscale()
     test_upscale()
     test_saturation()
     test_zero_point()
+    test_per_channel()
+    test_fused_fixed_point_multiply()
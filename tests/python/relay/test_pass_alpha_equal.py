@@ -635,6 +635,26 @@ def test_hash_unequal():
     assert not analysis.structural_hash(func1) == analysis.structural_hash(func3)
 
 
+def test_hash_cached():
+    x = relay.var("x", shape=(10, 10), dtype="float32")
+    ret_type = relay.TensorType((10, 10), "float32")
+    func = relay.Function([x], relay.nn.relu(x), ret_type)
+    h = analysis.structural_hash(func)
+    assert analysis.structural_hash(func) == h
+
+    # the typed copy fills type_args of the call, which AlphaEqual ignores
+    mod = relay.Module.from_expr(func)
+    typed = relay.transform.InferType()(mod)["main"]
+    assert analysis.alpha_equal(func, typed)
+    assert analysis.structural_hash(typed) == h
+
+    # known unequal hashes reject without a deep comparison
+    y = relay.var("y", shape=(10, 10), dtype="float32")
+    other = relay.Function([y], relay.nn.softmax(y))
+    assert analysis.structural_hash(other) != h
+    assert not analysis.alpha_equal(func, other)
+
+
 def test_tuple_match():
     a = relay.Var("a")
     b = relay.Var("b")
@@ -672,3 +692,4 @@ if __name__ == "__main__":
     test_var_alpha_equal()
     test_graph_equal()
     test_hash_unequal()
+    test_hash_cached()
@@ -67,7 +67,163 @@ def test_calibrate_target(create_target=False):
             relay.quantize.quantize(mod, params, dataset)
 
 
+def test_per_channel():
+    from tvm.contrib import graph_runtime
+
+    # depthwise convolutions are the main users of per-channel scales
+    mod, params = testing.mobilenet.get_workload()
+    with relay.quantize.qconfig(per_channel=True, weight_scale="max",
+                                skip_conv_layers=[]):
+        qmod = relay.quantize.quantize(mod, params)
+    with relay.build_config(opt_level=3):
+        relay.build(qmod, "llvm", params=params)
+
+    # a conv2d whose output channels have very different ranges keeps the
+    # small channels with per-channel scales.
+    data = relay.var("data", shape=(1, 4, 8, 8))
+    weight = relay.var("weight", shape=(4, 4, 3, 3))
+    out = relay.nn.conv2d(data, weight, kernel_size=(3, 3), padding=(1, 1), channels=4)
+    func = relay.Function([data, weight], out)
+    np.random.seed(0)
+    wdata = np.random.uniform(-1, 1, size=(4, 4, 3, 3))
+    wdata *= np.array([1, 10, 100, 1000]).reshape(4, 1, 1, 1)
+    params = {"weight": wdata.astype("float32")}
+    xdata = np.random.uniform(-1, 1, size=(1, 4, 8, 8)).astype("float32")
+    mod = relay.Module.from_expr(func)
+
+    def _run(qmod):
+        with relay.build_config(opt_level=3):
+            graph, lib, qparams = relay.build(qmod, "llvm", params=params)
+        runtime = graph_runtime.create(graph, lib, tvm.cpu())
+        runtime.set_input("data", xdata)
+        runtime.set_input(**qparams)
+        runtime.run()
+        return runtime.get_output(0).asnumpy()
+
+    expected = _run(mod)
+    for per_channel in [False, True]:
+        with relay.quantize.qconfig(per_channel=per_channel, weight_scale="max",
+                                    skip_conv_layers=[]):
+            qmod = relay.quantize.quantize(mod, params)
+        result = _run(qmod)
+        # relative error of the smallest output channel
+        err = np.abs(result[0, 0] - expected[0, 0]).max() / np.abs(expected[0, 0]).max()
+        if per_channel:
+            assert err < 0.2
+        else:
+            assert err > 0.5
+
+
+def test_calibrate_percentile():
+    mod, params = testing.resnet.get_workload(num_layers=18)
+    dataset = get_calibration_dataset("data")
+    with relay.quantize.qconfig(calibrate_mode="percentile", calibrate_percentile=0.999):
+        relay.quantize.quantize(mod, params, dataset)
+
+
+def test_calibration_stats():
+    try:
+        from tvm.relay.quantize.kl_divergence import _find_scale_by_kl
+        import scipy  # pylint: disable=unused-import
+    except ImportError:
+        print("skip because scipy is not available")
+        return
+    from tvm.relay.quantize import _quantize
+    from tvm.contrib import graph_runtime
+
+    # a profile graph with a single output, as built by collect_stats.
+    x = relay.var("x", shape=(20000,))
+    func = relay.Function([x], relay.Tuple([relay.nn.relu(x) - relay.const(0.5)]))
+    graph, lib, _ = relay.build(func, "llvm")
+    runtime = graph_runtime.create(graph, lib, tvm.cpu())
+
+    np.random.seed(0)
+    data = np.random.normal(size=(20000,)).astype("float32")
+    stats = _quantize.CreateCalibrationStats(1, 8001)
+    runtime.set_input("x", data)
+    runtime.run()
+    _quantize.CalibrationStatsUpdate(stats, runtime.module)
+
+    arr = np.maximum(data, 0) - 0.5
+    kl_scale = _quantize.CalibrationStatsFindScales(stats, "kl_divergence", 0.0).asnumpy()
+    tvm.testing.assert_allclose(kl_scale[0], _find_scale_by_kl(arr), rtol=1e-2)
+    pct_scale = _quantize.CalibrationStatsFindScales(stats, "percentile", 0.99).asnumpy()
+    tvm.testing.assert_allclose(pct_scale[0], np.percentile(np.abs(arr), 99), rtol=1e-2)
+
+
+def test_calibration_stats_multi_batch():
+    from tvm.relay.quantize import _quantize
+    from tvm.contrib import graph_runtime
+
+    x = relay.var("x", shape=(20000,))
+    func = relay.Function([x], relay.Tuple([relay.negative(x)]))
+    graph, lib, _ = relay.build(func, "llvm")
+    runtime = graph_runtime.create(graph, lib, tvm.cpu())
+
+    # the range grows over the batches, non-finite values are ignored.
+    np.random.seed(0)
+    num_bins = 8001
+    stats = _quantize.CreateCalibrationStats(1, num_bins)
+    batches = []
+    for scale in [1.0, 2.5, 0.5, 7.0]:
+        data = (np.random.normal(size=(20000,)) * scale).astype("float32")
+        if scale == 0.5:
+            data[:3] = [np.nan, np.inf, -np.inf]
+        runtime.set_input("x", data)
+        runtime.run()
+        _quantize.CalibrationStatsUpdate(stats, runtime.module)
+        batches.append(-data[np.isfinite(data)])
+    arr = np.concatenate(batches)
+
+    counts = _quantize.CalibrationStatsHistogram(stats, 0).asnumpy()
+    hist_range = _quantize.CalibrationStatsRange(stats, 0)
+    assert hist_range >= np.abs(arr).max()
+    expected, _ = np.histogram(arr, bins=num_bins, range=(-hist_range, hist_range))
+    assert counts.sum() == arr.size
+    # bins may only differ by values within rounding of a bin edge.
+    assert np.abs(counts - expected).sum() <= 1e-4 * arr.size
+    pct_scale = _quantize.CalibrationStatsFindScales(stats, "percentile", 0.99).asnumpy()
+    tvm.testing.assert_allclose(pct_scale[0], np.percentile(np.abs(arr), 99), rtol=1e-2)
+
+
+def test_calibration_stats_arena_offset():
+    import json
+    from tvm.relay.quantize import _quantize
+    from tvm.contrib import graph_runtime
+
+    # Both outputs are views into one arena, at least one at a nonzero offset.
+    x = relay.var("x", shape=(1024,))
+    func = relay.Function([x], relay.Tuple([relay.negative(x), relay.add(x, x)]))
+    with relay.build_config(opt_level=0):
+        graph, lib, _ = relay.build(func, "llvm")
+    graph_json = json.loads(graph)
+    offsets = graph_json["attrs"]["storage_offset"][1]
+    node_row_ptr = graph_json["node_row_ptr"]
+    heads = [node_row_ptr[nid] + index for nid, index, _ in graph_json["heads"]]
+    assert any(offsets[eid] != 0 for eid in heads)
+    runtime = graph_runtime.create(graph, lib, tvm.cpu())
+
+    np.random.seed(0)
+    data = np.random.normal(size=(1024,)).astype("float32")
+    runtime.set_input("x", data)
+    runtime.run()
+    num_bins = 101
+    stats = _quantize.CreateCalibrationStats(2, num_bins)
+    _quantize.CalibrationStatsUpdate(stats, runtime.module)
+    for layer, arr in enumerate([-data, data + data]):
+        counts = _quantize.CalibrationStatsHistogram(stats, layer).asnumpy()
+        hist_range = _quantize.CalibrationStatsRange(stats, layer)
+        assert hist_range >= np.abs(arr).max()
+        expected, _ = np.histogram(arr, bins=num_bins, range=(-hist_range, hist_range))
+        assert np.abs(counts - expected).sum() <= 2
+
+
 if __name__ == "__main__":
     test_mul_rewrite()
     test_calibrate_target(False)
     test_calibrate_target(True)
+    test_per_channel()
+    test_calibrate_percentile()
+    test_calibration_stats()
+    test_calibration_stats_multi_batch()
+    test_calibration_stats_arena_offset()
@@ -161,6 +161,33 @@ def test_fold_full():
     assert relay.analysis.graph_equal(zz, zexpected)
 
 
+def test_fold_batched():
+    c_data = np.arange(6).astype("float32").reshape((2, 3))
+    t = relay.TensorType([3, 2], "float32")
+    def before():
+        c = relay.const(c_data)
+        x = relay.var("x", t)
+        # shared constant subexpression feeding two folded regions
+        ct = relay.transpose(c)
+        y = relay.add(x, relay.multiply(ct, relay.const(2, "float32")))
+        z = relay.add(y, relay.add(ct, relay.const(1, "float32")))
+        s = relay.split(c, 2, axis=0)
+        w = relay.add(z, relay.transpose(relay.concatenate([s[1], s[0]], axis=0)))
+        return relay.Function([x], w)
+
+    def expected():
+        x = relay.var("x", t)
+        ct = c_data.T
+        y = relay.add(x, relay.const(ct * 2))
+        z = relay.add(y, relay.const(ct + 1))
+        w = relay.add(z, relay.const(np.concatenate([c_data[1:], c_data[:1]]).T))
+        return relay.Function([x], w)
+
+    zz = run_opt_pass(before(), transform.FoldConstant())
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    assert relay.analysis.graph_equal(zz, zexpected)
+
+
 if __name__ == "__main__":
     test_fold_const()
     test_fold_let()
@@ -168,3 +195,4 @@ if __name__ == "__main__":
     test_fold_concat()
     test_fold_shape_of()
     test_fold_full()
+    test_fold_batched()
@@ -586,6 +586,50 @@ def test_fuse_max():
     after = run_opt_pass(expected(), transform.InferType())
     assert relay.analysis.alpha_equal(zz, after)
 
+
+def count_fused_functions(expr):
+    count = [0]
+    def fvisit(e):
+        if isinstance(e, relay.Call) and isinstance(e.op, relay.Function):
+            count[0] += 1
+    relay.analysis.post_order_visit(expr, fvisit)
+    return count[0]
+
+
+def test_fuse_cost_model():
+    """Test that the fusion cost model can refuse and extend fusion."""
+    def before():
+        x = relay.var("x", shape=(256, 1024))
+        y = relay.transpose(relay.exp(x))
+        return relay.Function([x], relay.sum(y, axis=1))
+
+    # greedy fusion does not fuse the transpose into the reduction
+    zz = run_opt_pass(before(), transform.FuseOps())
+    assert count_fused_functions(zz) == 2
+
+    features = []
+    def refuse_all(f):
+        features.append({k: f[k].value for k in f})
+        return False
+    with relay.build_config(fusion_cost_model=refuse_all):
+        zz = run_opt_pass(before(), transform.FuseOps())
+    assert count_fused_functions(zz) == 3
+    # the relaxed candidate removes a 1MB intermediate
+    relaxed = [f for f in features if f["relaxed"]]
+    assert len(relaxed) == 1
+    assert relaxed[0]["bytes_saved"] == 2 * 256 * 1024 * 4
+    # exp is one operation per element, transpose only moves data
+    assert relaxed[0]["flops"] == 256 * 1024
+
+    # the default cost model fuses the large memory-bound chain on CPU
+    with relay.build_config(fusion_cost_model=transform.DefaultFusionCostModel()):
+        zz = run_opt_pass(before(), transform.FuseOps())
+    assert count_fused_functions(zz) == 1
+    # the cost model is no longer consulted outside the pass context
+    zz = run_opt_pass(before(), transform.FuseOps())
+    assert count_fused_functions(zz) == 2
+
+
 if __name__ == "__main__":
     test_fuse_simple()
     test_conv2d_fuse()
@@ -602,3 +646,4 @@ if __name__ == "__main__":
     test_immutable()
     test_split()
     test_fuse_max()
+    test_fuse_cost_model()
@@ -361,6 +361,19 @@ def test_let_polymorphism():
     assert_alpha_equal(body.checked_type, relay.TupleType([int32, relay.TupleType([])]))
 
 
+def test_incremental_reuse():
+    x = relay.var("x", shape=(10, 10))
+    y = relay.var("y", shape=(10, 10))
+    func = run_infer_type(relay.Function([x, y], relay.nn.relu(x + y)))
+    inner = func.body
+    # wrap the already typed body; only the new call needs inference
+    new_func = relay.Function(func.params, relay.cast(relay.exp(inner), "float16"))
+    new_func = run_infer_type(new_func)
+    tt = relay.TensorType((10, 10), "float16")
+    assert new_func.checked_type == relay.FuncType([relay.TensorType((10, 10))] * 2, tt)
+    assert new_func.body.args[0].args[0].same_as(inner)
+
+
 if __name__ == "__main__":
     test_free_expr()
     test_dual_op()
@@ -379,3 +392,4 @@ if __name__ == "__main__":
     test_constructor_call()
     test_adt_match()
     test_let_polymorphism()
+    test_incremental_reuse()
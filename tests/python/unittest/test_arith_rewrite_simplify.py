@@ -833,6 +833,37 @@ def test_cast_simplify():
             for i in [0, 1, 2, 3]:
                 ck.verify(tvm.expr.Cast(dtype1, tvm.const(i, dtype2)), tvm.const(i, dtype1))
 
+def test_memo_context():
+    ck = RewriteChecker()
+    x, y = tvm.var("x"), tvm.var("y")
+    # structurally equal inputs share memo entries but must respect the context
+    ck.verify(tvm.min(x, 10), tvm.min(x, 10))
+    with ck.analyzer.constraint_scope(x < 5):
+        ck.verify(tvm.min(x, 10), x)
+        with ck.analyzer.constraint_scope(y < 0):
+            ck.verify(tvm.min(x, 10), x)
+    ck.verify(tvm.min(x, 10), tvm.min(x, 10))
+
+    # variable updates inside a scope outlive it
+    with ck.analyzer.constraint_scope(y > 0):
+        ck.analyzer.update(x, tvm.arith.ConstIntBound(0, 3))
+    ck.verify(tvm.min(x, 10), x)
+
+    # only entries using a rebound variable are invalidated
+    ck.verify(tvm.max(y, 10), tvm.max(y, 10))
+    ck.analyzer.update(x, tvm.arith.ConstIntBound(0, 20), override=True)
+    ck.verify(tvm.min(x, 10), tvm.min(x, 10))
+    ck.verify(tvm.max(y, 10), tvm.max(y, 10))
+    ck.analyzer.update(y, tvm.arith.ConstIntBound(12, 20))
+    ck.verify(tvm.max(y, 10), y)
+    ck.verify(tvm.min(x, 10), tvm.min(x, 10))
+
+    # the same expression in different dtypes is not shared
+    ck.verify(tvm.expr.Cast("int64", tvm.const(3, "int32")), tvm.const(3, "int64"))
+    ck.verify(tvm.expr.Cast("int64", tvm.const(3, "int64")), tvm.const(3, "int64"))
+    ck.verify(tvm.expr.Cast("int8", tvm.const(3, "int64")), tvm.const(3, "int8"))
+
+
 if __name__ == "__main__":
     test_floordiv_index_simplify()
     test_floormod_index_simplify()
@@ -849,3 +880,4 @@ if __name__ == "__main__":
     test_logical_simplify()
     test_let_simplify()
     test_cast_simplify()
+    test_memo_context()
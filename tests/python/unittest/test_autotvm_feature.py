@@ -78,6 +78,38 @@ def test_curve_feature_gemm():
     # sample_n * #buffers * #curves * 2 numbers per curve
     assert len(feas) == 30 * 3 * 4 * 2
 
+def test_cache_feature_gemm():
+    N = 128
+    k = tvm.reduce_axis((0, N), 'k')
+    A = tvm.placeholder((N, N), name='A')
+    B = tvm.placeholder((N, N), name='B')
+    C = tvm.compute(
+        A.shape,
+        lambda y, x: tvm.sum(A[y, k] * B[k, x], axis=k),
+        name='C')
+
+    s = tvm.create_schedule(C.op)
+
+    cache_sizes = (32 * 1024, 256 * 1024, 8 * 1024 * 1024)
+    feas = feature.get_cache_feature_flatten(s, [A, B, C], take_log=False,
+                                             cache_sizes=cache_sizes)
+    row_len = 2 + 2 * len(cache_sizes) + 6
+    assert len(feas) == 3 * row_len
+    rows = [feas[i * row_len: (i + 1) * row_len] for i in range(3)]
+
+    # axis y touches all of A, B and C: 3 * 64KB, which only fits in L2
+    y_row = rows[0]
+    assert y_row[0] == 3 * N * N * 4
+    assert y_row[2:5] == (0, 1, 1)
+    # axis k touches a row of A, a column of B and one element of C
+    k_row = rows[2]
+    assert k_row[0] == (2 * N + 1) * 4
+    assert k_row[1] == 3 * 4
+    assert k_row[2:5] == (1, 1, 1)
+    # A is contiguous along k, B is strided and C is invariant
+    assert k_row[9:12] == (1, 2, 1)
+
+
 def test_feature_shape():
     """test the dimensions of flatten feature are the same"""
 
@@ -127,8 +159,40 @@ def test_feature_shape():
                                                    " for different configurations"
 
 
+def test_feature_batch():
+    """test batched extraction agrees with per-schedule extraction"""
+    N = 128
+
+    def gemm(factor):
+        k = tvm.reduce_axis((0, N), 'k')
+        A = tvm.placeholder((N, N), name='A')
+        B = tvm.placeholder((N, N), name='B')
+        C = tvm.compute(A.shape, lambda y, x: tvm.sum(A[y, k] * B[k, x], axis=k),
+                        name='C')
+        s = tvm.create_schedule(C.op)
+        y, x = s[C].op.axis
+        s[C].tile(y, x, factor, factor)
+        return s, [A, B, C]
+
+    schs, args_list = zip(*[gemm(f) for f in [2, 4, 8, 16, 32]])
+
+    batch = feature.get_itervar_feature_flatten_batch(schs, args_list, take_log=True)
+    assert batch.shape[0] == len(schs)
+    for i, (s, args) in enumerate(zip(schs, args_list)):
+        fea = feature.get_itervar_feature_flatten(s, args, take_log=True)
+        np.testing.assert_allclose(batch[i, :len(fea)], fea, rtol=1e-5)
+        assert not batch[i, len(fea):].any()
+
+    batch = feature.get_buffer_curve_sample_flatten_batch(schs, args_list, sample_n=30)
+    for i, (s, args) in enumerate(zip(schs, args_list)):
+        fea = feature.get_buffer_curve_sample_flatten(s, args, sample_n=30)
+        np.testing.assert_allclose(batch[i, :len(fea)], fea, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_iter_feature_gemm()
     test_curve_feature_gemm()
+    test_cache_feature_gemm()
     test_feature_shape()
+    test_feature_batch()
 
@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+from tvm import autotvm
+from tvm.autotvm.tuner.native_cost_model import NativeCostModel, NativeSAOptimizer
+
+from test_autotvm_common import get_sample_task, get_sample_records
+
+
+def test_fit():
+    task, _ = get_sample_task()
+    # one record per config of the 64 configs in the sample space
+    records = get_sample_records(n=64)
+
+    model = NativeCostModel(task)
+    # the model has no features before it is fit
+    try:
+        model.predict([0])
+        assert False, "predict before fit must fail"
+    except tvm.TVMError:
+        pass
+    assert model.fit_log(records, plan_size=32)
+
+    xs = [inp.config.index for inp, _ in records]
+    ys = [inp.task.flop / np.mean(res.costs) for inp, res in records]
+    preds = model.predict(xs)
+    assert np.corrcoef(preds, ys)[0, 1] > 0.9
+    # raw features must have the width the model was fit on
+    num_features = model._features([0]).shape[1]
+    try:
+        model._mod["predict"](tvm.nd.array(np.zeros((2, num_features + 1), dtype="float32")))
+        assert False, "predict with a wrong feature width must fail"
+    except tvm.TVMError:
+        pass
+
+    upper_model = NativeCostModel(task)
+    upper_model.load_basemodel(model)
+    upper_model.fit(np.arange(10), np.arange(10), plan_size=32)
+    assert len(upper_model.predict(np.arange(20))) == 20
+
+
+def test_refit_history():
+    task, _ = get_sample_task()
+    xs = np.arange(len(task.config_space))
+    ys = np.random.uniform(size=len(xs)) * 1e9
+
+    # samples are kept, so fitting in two steps is the same as fitting once
+    full = NativeCostModel(task)
+    full.fit(xs, ys, plan_size=32)
+    base = NativeCostModel(task)
+    base.fit(xs[:32], ys[:32], plan_size=32)
+    upper = NativeCostModel(task)
+    upper.load_basemodel(base)
+    # the new samples have a larger maximum than the base samples
+    upper.fit(xs[32:], ys[32:], plan_size=32)
+    np.testing.assert_allclose(upper.predict(xs), full.predict(xs), rtol=1e-5, atol=1e-6)
+
+
+def test_compare_xgboost():
+    try:
+        import xgboost  # pylint: disable=unused-import
+    except ImportError:
+        return
+    from tvm.autotvm.tuner.xgboost_cost_model import XGBoostCostModel
+    task, _ = get_sample_task()
+    xs = np.arange(len(task.config_space))
+    rng = np.random.RandomState(0)
+    # a smooth function of the tile sizes with some measurement noise
+    feas = [np.log2(np.abs(task.config_space.get(x).get_flatten_feature()) + 1) for x in xs]
+    ys = np.array([1.0 / (1.0 + np.sum((fea - 3) ** 2)) for fea in feas])
+    ys = ys / np.max(ys) + rng.uniform(0, 0.05, size=len(xs))
+    train = rng.permutation(len(xs))[:48]
+    test = np.setdiff1d(xs, train)
+
+    native = NativeCostModel(task)
+    native.fit(train, ys[train], plan_size=32)
+    xgb_model = XGBoostCostModel(task, feature_type='knob', loss_type='reg')
+    xgb_model.fit(train, ys[train], plan_size=32)
+
+    # the native model fits the held out configs about as well as xgboost
+    def rank_corr(preds):
+        return np.corrcoef(np.argsort(np.argsort(preds)),
+                           np.argsort(np.argsort(ys[test])))[0, 1]
+    assert rank_corr(native.predict(test)) > rank_corr(xgb_model.predict(test)) - 0.1
+
+
+def test_find_maximums():
+    task, _ = get_sample_task()
+    model = NativeCostModel(task)
+    xs = np.arange(len(task.config_space))
+    ys = np.random.uniform(size=len(xs))
+    model.fit(xs, ys, plan_size=32)
+
+    exclusive = set(np.argsort(-ys)[:8].tolist())
+    opt = NativeSAOptimizer(task, n_iter=100)
+    maximums = opt.find_maximums(model, 16, exclusive)
+    assert len(maximums) == len(set(maximums)) == 16
+    assert not exclusive.intersection(maximums)
+    assert all(0 <= x < len(task.config_space) for x in maximums)
+
+    # the search returns the best points first
+    scores = model.predict(maximums)
+    assert np.all(np.diff(scores) <= 1e-6)
+
+
+def test_tuner():
+    task, _ = get_sample_task()
+    records = get_sample_records(n=100)
+
+    tuner = autotvm.tuner.NativeTuner(task)
+    tuner.load_history(records)
+    assert tuner.trials
+
+
+if __name__ == "__main__":
+    test_fit()
+    test_refit_history()
+    test_compare_xgboost()
+    test_find_maximums()
+    test_tuner()
@@ -220,6 +220,49 @@ def test_llvm_vadd_pipeline():
     check_llvm(512, 2)
 
 
+def test_llvm_masked_load_store():
+    if not tvm.module.enabled("llvm"):
+        return
+    try:
+        with open("/proc/cpuinfo") as f:
+            if "avx512f" not in f.read():
+                return
+    except IOError:
+        return
+    n = tvm.var('n')
+    A = tvm.placeholder((n,), name='A')
+    B = tvm.compute((n + 2,), lambda i: tvm.if_then_else(
+        tvm.all(i >= 1, i < n + 1), A[i - 1], 0.0), name='B')
+    s = tvm.create_schedule(B.op)
+    s[B].vectorize(B.op.axis[0])
+    # the target reaches the vectorizer without a target scope.
+    f = tvm.build(s, [A, B], "llvm -mcpu=skylake-avx512")
+    assert "llvm.masked" in f.get_source()
+    ctx = tvm.cpu(0)
+    for size in [1, 5, 16, 33]:
+        a = tvm.nd.array(np.random.uniform(size=size).astype(A.dtype), ctx)
+        b = tvm.nd.array(np.zeros(size + 2, dtype=B.dtype), ctx)
+        f(a, b)
+        tvm.testing.assert_allclose(b.asnumpy(), np.pad(a.asnumpy(), 1, "constant"))
+
+def test_llvm_vadd_symbolic_extent():
+    if not tvm.module.enabled("llvm"):
+        return
+    n = tvm.var('n')
+    A = tvm.placeholder((n,), name='A')
+    B = tvm.compute((n,), lambda i: A[i] * 2 + 1, name='B')
+    s = tvm.create_schedule(B.op)
+    s[B].vectorize(B.op.axis[0])
+    f = tvm.build(s, [A, B], "llvm")
+    assert "<4 x float>" in f.get_source()
+    ctx = tvm.cpu(0)
+    for size in [1, 7, 8, 29, 1024]:
+        a = tvm.nd.array(np.random.uniform(size=size).astype(A.dtype), ctx)
+        b = tvm.nd.array(np.zeros(size, dtype=B.dtype), ctx)
+        f(a, b)
+        tvm.testing.assert_allclose(b.asnumpy(), a.asnumpy() * 2 + 1)
+
+
 def test_llvm_madd_pipeline():
     def check_llvm(nn, base, stride):
         if not tvm.module.enabled("llvm"):
@@ -653,6 +696,8 @@ if __name__ == "__main__":
     test_llvm_persist_parallel()
     test_llvm_condition()
     test_llvm_vadd_pipeline()
+    test_llvm_vadd_symbolic_extent()
+    test_llvm_masked_load_store()
     test_llvm_add_pipeline()
     test_llvm_intrin()
     test_multiple_func()
@@ -0,0 +1,121 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import numpy as np
+
+
+def _collect_hints(f):
+    hints = {"prefetch": [], "nontemporal_store": []}
+    def _visit(x):
+        if isinstance(x, tvm.expr.Call) and x.name == "prefetch":
+            hints["prefetch"].append(x.args[0].args[0].index)
+        if isinstance(x, tvm.stmt.AttrStmt) and x.attr_key == "nontemporal_store":
+            hints["nontemporal_store"].append(x.node.name)
+    tvm.ir_pass.PostOrderVisit(f.body, _visit)
+    return hints
+
+
+def _lower_add(n, vectorize=True):
+    A = tvm.placeholder((n,), name="A")
+    B = tvm.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = tvm.create_schedule(B.op)
+    if vectorize:
+        _, xi = s[B].split(B.op.axis[0], factor=8)
+        s[B].vectorize(xi)
+    return s, A, B
+
+
+def test_stream_hint():
+    n = 1 << 22
+    s, A, B = _lower_add(n)
+    f = tvm.lower(s, [A, B], name="add")
+    hints = _collect_hints(tvm.ir_pass.InjectStreamHint(f))
+    assert len(hints["prefetch"]) == 1
+    assert hints["nontemporal_store"] == ["B"]
+    # the prefetch index is clamped to the last iteration.
+    index = hints["prefetch"][0]
+    assert isinstance(index, tvm.expr.Mul)
+    assert isinstance(index.a, tvm.expr.Min)
+    assert index.a.b.value == n // 8 - 1
+
+
+def test_stream_hint_scalar():
+    # scalar loops within a cache line are left to the hardware prefetcher.
+    s, A, B = _lower_add(1 << 22, vectorize=False)
+    f = tvm.lower(s, [A, B], name="add")
+    hints = _collect_hints(tvm.ir_pass.InjectStreamHint(f))
+    assert not hints["prefetch"]
+    assert hints["nontemporal_store"] == ["B"]
+
+
+def test_stream_hint_small():
+    s, A, B = _lower_add(1024)
+    f = tvm.lower(s, [A, B], name="add")
+    hints = _collect_hints(tvm.ir_pass.InjectStreamHint(f))
+    assert not hints["prefetch"]
+    assert not hints["nontemporal_store"]
+
+
+def test_stream_hint_unknown_extent():
+    n = tvm.var("n")
+    A = tvm.placeholder((n * 8,), name="A")
+    B = tvm.compute((n * 8,), lambda i: A[i] + 1.0, name="B")
+    s = tvm.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xi)
+    f = tvm.lower(s, [A, B], name="add")
+    hints = _collect_hints(tvm.ir_pass.InjectStreamHint(f))
+    assert not hints["prefetch"]
+    assert not hints["nontemporal_store"]
+
+
+def test_stream_hint_parallel():
+    n = 1 << 22
+    A = tvm.placeholder((n,), name="A")
+    B = tvm.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = tvm.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=1 << 16)
+    xi, xv = s[B].split(xi, factor=8)
+    s[B].parallel(xo)
+    s[B].vectorize(xv)
+    f = tvm.lower(s, [A, B], name="add")
+    hints = _collect_hints(tvm.ir_pass.InjectStreamHint(f))
+    assert len(hints["prefetch"]) == 1
+    assert hints["nontemporal_store"] == ["B"]
+    if not tvm.module.enabled("llvm"):
+        return
+    # the hints are opt-in.
+    fadd = tvm.build(s, [A, B], "llvm")
+    assert "!nontemporal" not in fadd.get_source()
+    with tvm.build_config(inject_stream_hint=True):
+        fadd = tvm.build(s, [A, B], "llvm")
+    source = fadd.get_source()
+    assert "!nontemporal" in source
+    assert source.count("call void @llvm.x86.sse.sfence()") == 1
+    ctx = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), ctx)
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype), ctx)
+    fadd(a, b)
+    tvm.testing.assert_allclose(b.asnumpy(), a.asnumpy() + 1)
+
+
+if __name__ == "__main__":
+    test_stream_hint()
+    test_stream_hint_scalar()
+    test_stream_hint_small()
+    test_stream_hint_unknown_extent()
+    test_stream_hint_parallel()
@@ -145,6 +145,37 @@ def test_alloc_different_dtypes():
     dtype_test(dtype_list, length)
 
 
+def test_alloc_arena():
+    ib = tvm.ir_builder.create()
+    n = 1024
+    A = ib.allocate("float32", n, name="A", scope="global")
+    B = ib.allocate("float32", 2 * n, name="B", scope="global")
+    C = ib.allocate("float32", n, name="C", scope="global")
+    D = ib.pointer("float32", name="D")
+    with ib.for_range(0, n, name="i") as i:
+        A[i] = 1.3
+    with ib.for_range(0, n, name="i") as i:
+        B[i] = A[i] + 1.0
+    with ib.for_range(0, n, name="i") as i:
+        C[i] = B[i] * 2.0
+    with ib.for_range(0, n, name="i") as i:
+        D[i] = C[i]
+    body = ib.get()
+    body = tvm.ir_pass.StorageRewrite(body)
+    # C reuses A, and the live A/C and B are packed into one arena.
+    num_alloc = [0]
+    buffer_vars = set()
+    def verify(n):
+        if isinstance(n, tvm.stmt.Allocate):
+            num_alloc[0] += 1
+            assert n.extents[0].value == 3 * 1024
+        if isinstance(n, tvm.stmt.Store) and n.buffer_var.name != "D":
+            buffer_vars.add(n.buffer_var.name)
+    tvm.ir_pass.PostOrderVisit(body, verify)
+    assert num_alloc[0] == 1
+    assert len(buffer_vars) == 1
+
+
 def test_inplace_rule():
     m = 10
     A = tvm.placeholder((m,), name='A')
@@ -520,6 +551,7 @@ def test_large_input():
 if __name__ == "__main__":
     test_alloc_seq()
     test_alloc_different_dtypes()
+    test_alloc_arena()
     test_inplace_rule()
     test_storage_share()
     test_parallel_alloc()
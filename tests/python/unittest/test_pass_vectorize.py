@@ -118,6 +118,56 @@ def test_vectorize_if_then_else():
     assert not isinstance(stmt.body, tvm.stmt.For)
     assert isinstance(stmt.body.value.args[2], tvm.expr.Broadcast)
 
+def test_vectorize_symbolic_extent():
+    n = tvm.var('n')
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, n, for_type="vectorize") as i:
+        A[i] = A[i] + 1
+    stmt = ib.get()
+    vstmt = tvm.ir_pass.VectorizeLoop(stmt)
+    assert isinstance(vstmt, tvm.stmt.Block)
+    main, tail = vstmt.first, vstmt.rest
+    assert main.for_type == tvm.stmt.For.Serial
+    assert isinstance(main.body.index, tvm.expr.Ramp)
+    assert main.body.index.lanes == 4
+    assert tail.for_type == tvm.stmt.For.Serial
+    assert main.body.value.dtype == "float32x4"
+    assert tail.body.value.dtype == "float32"
+    # the lanes follow the native vector width of the target.
+    for target, lanes in [("llvm -device=arm_cpu -target=aarch64-linux-gnu", 4),
+                          ("llvm -mcpu=core-avx2", 8),
+                          ("llvm -mattr=+avx2,+fma", 8),
+                          ("llvm -mcpu=core-avx2 -mattr=-avx", 4)]:
+        vstmt = tvm.ir_pass.VectorizeLoop(stmt, tvm.target.create(target))
+        assert vstmt.first.body.index.lanes == lanes
+
+def test_vectorize_predicated():
+    n = tvm.var('n')
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 16, for_type="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = tvm.if_then_else(i > 2, B[i - 3], 0.0)
+    stmt = ib.get()
+    for target in ["llvm -mcpu=skylake-avx512", "llvm -mattr=+avx512bw",
+                   "llvm -device=arm_cpu -target=aarch64-linux-gnu -mattr=+sve"]:
+        vstmt = tvm.ir_pass.VectorizeLoop(stmt, tvm.target.create(target))
+        assert isinstance(vstmt, tvm.stmt.Store)
+        assert vstmt.predicate.dtype == "uint1x16"
+        assert isinstance(vstmt.value, tvm.expr.Select)
+        assert vstmt.value.true_value.predicate.dtype == "uint1x16"
+    # without masked memory access the condition is scalarized.
+    for target in ["llvm", "llvm -mcpu=skylake-avx512 -mattr=-avx512f",
+                   "llvm -mattr=+avx512f,-avx2"]:
+        vstmt = tvm.ir_pass.VectorizeLoop(stmt, tvm.target.create(target))
+        assert isinstance(vstmt, tvm.stmt.For)
+    # the current target is used when none is given.
+    with tvm.target.create("llvm -mcpu=skylake-avx512"):
+        vstmt = tvm.ir_pass.VectorizeLoop(stmt)
+    assert isinstance(vstmt, tvm.stmt.Store)
+
 
 if __name__ == "__main__":
     test_vectorize_vector()
@@ -126,3 +176,5 @@ if __name__ == "__main__":
     test_vectorize_if_then_else()
     test_vectorize_with_le_cond()
     test_vectorize_with_ge_cond()
+    test_vectorize_symbolic_extent()
+    test_vectorize_predicated()
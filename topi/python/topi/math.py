@@ -20,6 +20,7 @@ from __future__ import absolute_import as _abs
 import tvm
 from . import tag
 from . import cpp
+from .util import equal_const_int
 
 
 @tvm.tag_scope(tag=tag.ELEMWISE)
@@ -410,6 +411,43 @@ def clip(x, a_min, a_max):
     return tvm.compute(x.shape, _compute)
 
 
+def fixed_point_multiply(x, multiplier, shift):
+    """Multiply an int32 tensor by a fixed point number and round the result.
+
+    The value computed is round(x * multiplier * 2^(-31 - shift)) with ties
+    rounded towards +inf, i.e. multiplier is a Q31 number and shift an extra
+    right shift. The product is kept in 64 bits and the whole computation is
+    a single elementwise stage that vectorizes on CPU targets.
+
+    Parameters
+    ----------
+    x : tvm.Tensor
+        The int32 input.
+
+    multiplier : tvm.Tensor
+        The int32 Q31 multiplier, broadcastable to x.
+
+    shift : tvm.Tensor
+        The int32 right shift, broadcastable to x. A negative shift is a
+        left shift.
+
+    Returns
+    -------
+    y : tvm.Tensor
+        The int32 result.
+    """
+    def _broadcast_indices(tensor, indices):
+        indices = indices[len(indices) - len(tensor.shape):]
+        return [0 if equal_const_int(dim, 1) else idx
+                for dim, idx in zip(tensor.shape, indices)]
+
+    def _compute(*indices):
+        value = x(*indices)
+        m = multiplier(*_broadcast_indices(multiplier, indices))
+        s = shift(*_broadcast_indices(shift, indices))
+        return tvm.q_multiply_shift(value, m, tvm.const(31, "int32"), -s)
+    return tvm.compute(x.shape, _compute, tag=tag.BROADCAST)
+
 def cast(x, dtype):
     """Cast input to specified data type.
 
@@ -185,7 +185,63 @@ def test_cast():
     verify("bool", "int32")
 
 
+def test_fixed_point_multiply():
+    def verify(shape, channels):
+        A = tvm.placeholder(shape, dtype="int32", name="A")
+        M = tvm.placeholder((channels, 1, 1), dtype="int32", name="M")
+        S = tvm.placeholder((channels, 1, 1), dtype="int32", name="S")
+        B = topi.fixed_point_multiply(A, M, S)
+
+        a_np = np.random.randint(-2**24, 2**24, size=shape).astype("int32")
+        m_np = np.random.randint(2**30, 2**31 - 1, size=(channels, 1, 1)).astype("int32")
+        s_np = np.random.randint(-1, 8, size=(channels, 1, 1)).astype("int32")
+        left = np.maximum(-s_np, 0).astype("int64")
+        right = (np.maximum(s_np, 0) + 31).astype("int64")
+        b_np = (a_np.astype("int64") << left) * m_np.astype("int64")
+        b_np = ((b_np + (np.int64(1) << (right - 1))) >> right).astype("int32")
+
+        for device in get_all_backend():
+            ctx = tvm.context(device, 0)
+            if not ctx.exist:
+                print("Skip because %s is not enabled" % device)
+                continue
+            print("Running on target: %s" % device)
+            with tvm.target.create(device):
+                s = topi.generic.schedule_injective(B)
+            foo = tvm.build(s, [A, M, S, B], device)
+            a = tvm.nd.array(a_np, ctx)
+            m = tvm.nd.array(m_np, ctx)
+            sh = tvm.nd.array(s_np, ctx)
+            b = tvm.nd.empty(shape=shape, dtype="int32", ctx=ctx)
+            foo(a, m, sh, b)
+            np.testing.assert_equal(b.asnumpy(), b_np)
+
+    verify((4, 8, 8), 4)
+    verify((2, 3, 5, 5), 3)
+
+
+def test_fixed_point_multiply_aarch64():
+    if not tvm.module.enabled("llvm"):
+        return
+    A = tvm.placeholder((4, 16), dtype="int32", name="A")
+    M = tvm.placeholder((4, 1), dtype="int32", name="M")
+    S = tvm.placeholder((4, 1), dtype="int32", name="S")
+    B = topi.fixed_point_multiply(A, M, S)
+    s = tvm.create_schedule(B.op)
+    s[B].vectorize(B.op.axis[1])
+    f = tvm.build(s, [A, M, S, B], "llvm -target=aarch64-linux-gnu -mattr=+neon")
+    ll = f.get_source("ll")
+    # int32x16 is split into four NEON multiplies without any int64 product.
+    assert ll.count("call <4 x i32> @llvm.aarch64.neon.sqdmulh.v4i32") == 4
+    assert "<16 x i64>" not in ll
+    # other targets keep the default int64 rule.
+    f = tvm.build(s, [A, M, S, B], "llvm -target=x86_64-linux-gnu")
+    assert "llvm.aarch64" not in f.get_source("ll")
+
+
 if __name__ == "__main__":
     test_util()
     test_ewise()
     test_cast()
+    test_fixed_point_multiply()
+    test_fixed_point_multiply_aarch64()